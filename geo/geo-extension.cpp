@@ -11,6 +11,7 @@
 #include "duckdb/parser/parsed_data/create_type_info.hpp"
 #include "formatter-functions.hpp"
 #include "geo_aggregate_function.hpp"
+#include "geometry.hpp"
 #include "measure-functions.hpp"
 #include "parser-functions.hpp"
 #include "predicate-functions.hpp"
@@ -64,14 +65,59 @@ void GeoExtension::Load(DuckDB &db) {
 	geo_function_set.insert(geo_function_set.end(), measure_func_set.begin(), measure_func_set.end());
 
 	for (auto func_set : geo_function_set) {
+		// liblwgeom allocations of a scalar call only live for the vector being processed
+		for (auto &func : func_set.functions) {
+			auto function = func.function;
+			func.function = [function](DataChunk &args, ExpressionState &state, Vector &result) {
+				GeometryArenaScope arena;
+				function(args, state, result);
+			};
+		}
 		CreateScalarFunctionInfo func_info(func_set);
 		catalog.AddFunction(*con.context, func_info);
 	}
 
+	// clustering windows over the whole partition are labelled row by row
+	OptimizerExtension cluster_windows;
+	cluster_windows.optimize_function = RewriteClusterWindows;
+	config.optimizer_extensions.push_back(cluster_windows);
+
 	auto cluster_db_scan = GetClusterDBScanAggregateFunction(geo_type);
 	CreateAggregateFunctionInfo cluster_db_scan_func_info(move(cluster_db_scan));
 	catalog.CreateFunction(*con.context, cluster_db_scan_func_info);
 
+	auto cluster_intersecting = GetClusterIntersectingAggregateFunction(geo_type);
+	CreateAggregateFunctionInfo cluster_intersecting_func_info(move(cluster_intersecting));
+	catalog.CreateFunction(*con.context, cluster_intersecting_func_info);
+
+	auto cluster_intersecting_win = GetClusterIntersectingWinAggregateFunction(geo_type);
+	CreateAggregateFunctionInfo cluster_intersecting_win_func_info(move(cluster_intersecting_win));
+	catalog.CreateFunction(*con.context, cluster_intersecting_win_func_info);
+
+	auto cluster_within = GetClusterWithinAggregateFunction(geo_type);
+	CreateAggregateFunctionInfo cluster_within_func_info(move(cluster_within));
+	catalog.CreateFunction(*con.context, cluster_within_func_info);
+
+	auto cluster_within_win = GetClusterWithinWinAggregateFunction(geo_type);
+	CreateAggregateFunctionInfo cluster_within_win_func_info(move(cluster_within_win));
+	catalog.CreateFunction(*con.context, cluster_within_win_func_info);
+
+	auto cluster_kmeans = GetClusterKMeansAggregateFunction(geo_type);
+	CreateAggregateFunctionInfo cluster_kmeans_func_info(move(cluster_kmeans));
+	catalog.CreateFunction(*con.context, cluster_kmeans_func_info);
+
+	auto union_agg = GetUnionAggregateFunction(geo_type);
+	CreateAggregateFunctionInfo union_agg_func_info(move(union_agg));
+	catalog.CreateFunction(*con.context, union_agg_func_info);
+
+	auto convexhull_agg = GetConvexHullAggregateFunction(geo_type);
+	CreateAggregateFunctionInfo convexhull_agg_func_info(move(convexhull_agg));
+	catalog.CreateFunction(*con.context, convexhull_agg_func_info);
+
+	auto extent_agg = GetExtentAggregateFunction(geo_type);
+	CreateAggregateFunctionInfo extent_agg_func_info(move(extent_agg));
+	catalog.CreateFunction(*con.context, extent_agg_func_info);
+
 	con.Commit();
 }
 
@@ -2,21 +2,13 @@
 
 #include "duckdb/common/types/vector.hpp"
 #include "duckdb/common/vector_operations/generic_executor.hpp"
+#include "duckdb/execution/expression_executor_state.hpp"
 #include "geometry.hpp"
 
-#include <unistd.h>
-
 namespace duckdb {
-int loopindex = 1;
-std::vector<int> queue {};
 
 bool GeoFunctions::CastVarcharToGEO(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
-	int currindex = loopindex;
-	queue.push_back(currindex);
-	loopindex++;
-	while (queue.size() > 0 && queue[0] != currindex) {
-		usleep(30);
-	}
+	GeometryArenaScope arena;
 	bool success = true;
 	try {
 		UnaryExecutor::ExecuteWithNulls<string_t, string_t>(
@@ -30,21 +22,19 @@ bool GeoFunctions::CastVarcharToGEO(Vector &source, Vector &result, idx_t count,
 				    success = false;
 				    return string_t();
 			    }
-			    idx_t size = Geometry::GetGeometrySize(gser);
-			    auto base = Geometry::GetBase(gser);
+			    auto result_str = Geometry::SerializeToVector(gser, result);
 			    Geometry::DestroyGeometry(gser);
-			    return string_t((const char *)base, size);
+			    return result_str;
 		    });
 	} catch (const std::exception &e) {
-		queue.erase(queue.begin());
 		throw Exception(e.what());
 		return false;
 	}
-	queue.erase(queue.begin());
 	return success;
 }
 
 bool GeoFunctions::CastGeoToVarchar(Vector &source, Vector &result, idx_t count, CastParameters &parameters) {
+	GeometryArenaScope arena;
 	GenericExecutor::ExecuteUnary<PrimitiveType<string_t>, PrimitiveType<string_t>>(
 	    source, result, count, [&](PrimitiveType<string_t> input) {
 		    // auto text = Geometry::GetString(input.val, DataFormatType::FORMAT_VALUE_TYPE_GEOJSON);
@@ -56,35 +46,37 @@ bool GeoFunctions::CastGeoToVarchar(Vector &source, Vector &result, idx_t count,
 
 struct MakePointBinaryOperator {
 	template <class TA, class TB, class TR>
-	static inline TR Operation(TA point_x, TB point_y) {
+	static inline TR Operation(TA point_x, TB point_y, Vector &result) {
 		auto gser = Geometry::MakePoint(point_x, point_y);
-		idx_t rv_size = Geometry::GetGeometrySize(gser);
-		auto base = Geometry::GetBase(gser);
+		auto result_str = Geometry::SerializeToVector(gser, result);
 		Geometry::DestroyGeometry(gser);
-		return string_t((const char *)base, rv_size);
+		return result_str;
 	}
 };
 
 struct MakePointTernaryOperator {
 	template <class TA, class TB, class TC, class TR>
-	static inline TR Operation(TA point_x, TB point_y, TC point_z) {
+	static inline TR Operation(TA point_x, TB point_y, TC point_z, Vector &result) {
 		auto gser = Geometry::MakePoint(point_x, point_y, point_z);
-		idx_t rv_size = Geometry::GetGeometrySize(gser);
-		auto base = Geometry::GetBase(gser);
+		auto result_str = Geometry::SerializeToVector(gser, result);
 		Geometry::DestroyGeometry(gser);
-		return string_t((const char *)base, rv_size);
+		return result_str;
 	}
 };
 
 template <typename TA, typename TB, typename TR>
 static void MakePointBinaryExecutor(Vector &point_x, Vector &point_y, Vector &result, idx_t count) {
-	BinaryExecutor::ExecuteStandard<TA, TB, TR, MakePointBinaryOperator>(point_x, point_y, result, count);
+	BinaryExecutor::Execute<TA, TB, TR>(point_x, point_y, result, count, [&](TA point_x_val, TB point_y_val) {
+		return MakePointBinaryOperator::Operation<TA, TB, TR>(point_x_val, point_y_val, result);
+	});
 }
 
 template <typename TA, typename TB, typename TC, typename TR>
 static void MakePointTernaryExecutor(Vector &point_x, Vector &point_y, Vector &point_z, Vector &result, idx_t count) {
-	TernaryExecutor::Execute<TA, TB, TC, TR>(point_x, point_y, point_z, result, count,
-	                                         MakePointTernaryOperator::Operation<TA, TB, TC, TR>);
+	TernaryExecutor::Execute<TA, TB, TC, TR>(
+	    point_x, point_y, point_z, result, count, [&](TA point_x_val, TB point_y_val, TC point_z_val) {
+		    return MakePointTernaryOperator::Operation<TA, TB, TC, TR>(point_x_val, point_y_val, point_z_val, result);
+	    });
 }
 
 void GeoFunctions::MakePointFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -101,7 +93,7 @@ void GeoFunctions::MakePointFunction(DataChunk &args, ExpressionState &state, Ve
 
 struct MakeLineBinaryOperator {
 	template <class TA, class TB, class TR>
-	static inline TR Operation(TA point1, TB point2) {
+	static inline TR Operation(TA point1, TB point2, Vector &result) {
 		if (point1.GetSize() == 0 || point2.GetSize() == 0) {
 			return string_t();
 		}
@@ -123,18 +115,19 @@ struct MakeLineBinaryOperator {
 			Geometry::DestroyGeometry(gser2);
 			return string_t();
 		}
-		idx_t rv_size = Geometry::GetGeometrySize(gser);
-		auto base = Geometry::GetBase(gser);
+		auto result_str = Geometry::SerializeToVector(gser, result);
 		Geometry::DestroyGeometry(gser1);
 		Geometry::DestroyGeometry(gser2);
 		Geometry::DestroyGeometry(gser);
-		return string_t((const char *)base, rv_size);
+		return result_str;
 	}
 };
 
 template <typename TA, typename TB, typename TR>
 static void MakeLineBinaryExecutor(Vector &point1, Vector &point2, Vector &result, idx_t count) {
-	BinaryExecutor::ExecuteStandard<TA, TB, TR, MakeLineBinaryOperator>(point1, point2, result, count);
+	BinaryExecutor::Execute<TA, TB, TR>(point1, point2, result, count, [&](TA point1_val, TB point2_val) {
+		return MakeLineBinaryOperator::Operation<TA, TB, TR>(point1_val, point2_val, result);
+	});
 }
 
 void GeoFunctions::MakeLineFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -196,19 +189,18 @@ void GeoFunctions::MakeLineArrayFunction(DataChunk &args, ExpressionState &state
 			gserArray[child_idx] = gser;
 		}
 		auto gserline = Geometry::MakeLineGArray(&gserArray[0], list_entry.length);
-		idx_t rv_size = Geometry::GetGeometrySize(gserline);
-		auto base = Geometry::GetBase(gserline);
+		auto result_str = Geometry::SerializeToVector(gserline, result);
 		for (idx_t child_idx = 0; child_idx < list_entry.length; child_idx++) {
 			Geometry::DestroyGeometry(gserArray[child_idx]);
 		}
 		Geometry::DestroyGeometry(gserline);
-		result_entries[i] = string_t((const char *)base, rv_size);
+		result_entries[i] = result_str;
 	}
 }
 
 struct MakePolygonUnaryOperator {
 	template <class TA, class TR>
-	static inline TR Operation(TA geom) {
+	static inline TR Operation(TA geom, Vector &result) {
 		if (geom.GetSize() == 0) {
 			// throw ConversionException(
 			//     "Failure in geometry get X: could not get coordinate X from geometry");
@@ -216,17 +208,16 @@ struct MakePolygonUnaryOperator {
 		}
 		auto gser = Geometry::GetGserialized(geom);
 		auto gserpoly = Geometry::MakePolygon(gser);
-		idx_t rv_size = Geometry::GetGeometrySize(gserpoly);
-		auto base = Geometry::GetBase(gserpoly);
+		auto result_str = Geometry::SerializeToVector(gserpoly, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserpoly);
-		return string_t((const char *)base, rv_size);
+		return result_str;
 	}
 };
 
 template <typename TA, typename TR>
 static void MakePolygonUnaryExecutor(Vector &geom, Vector &result, idx_t count) {
-	UnaryExecutor::Execute<TA, TR, MakePolygonUnaryOperator>(geom, result, count);
+	UnaryExecutor::ExecuteString<TA, TR, MakePolygonUnaryOperator>(geom, result, count);
 }
 
 void GeoFunctions::MakePolygonFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -298,14 +289,13 @@ void GeoFunctions::MakePolygonFunction(DataChunk &args, ExpressionState &state,
 				result_entries[i] = string_t();
 				continue;
 			}
-			idx_t rv_size = Geometry::GetGeometrySize(gserpoly);
-			auto base = Geometry::GetBase(gserpoly);
+			auto result_str = Geometry::SerializeToVector(gserpoly, result);
 			for (idx_t child_idx = 0; child_idx < list_entry.length; child_idx++) {
 				Geometry::DestroyGeometry(gserArray[child_idx]);
 			}
 			Geometry::DestroyGeometry(gserpoly);
 			Geometry::DestroyGeometry(gser);
-			result_entries[i] = string_t((const char *)base, rv_size);
+			result_entries[i] = result_str;
 		}
 		// MakePolygonBinaryExecutor<string_t, string_t>(point1_arg, result, args.size());
 	} else {
@@ -319,13 +309,13 @@ struct AsBinaryUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return geom;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		auto binary = Geometry::AsBinary(gser);
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		auto binary = Geometry::AsBinary(lwgeom);
 		idx_t size = LWSIZE_GET(binary->size) - LWVARHDRSZ;
 		auto result_str = StringVector::EmptyString(result, size);
 		memcpy(result_str.GetDataWriteable(), binary->data, size);
 		result_str.Finalize();
-		Geometry::DestroyGeometry(gser);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return result_str;
 	}
 };
@@ -334,13 +324,13 @@ static string_t AsBinaryScalarFunction(Vector &result, string_t geom, string_t t
 	if (geom.GetSize() == 0 || text.GetSize() == 0) {
 		return geom;
 	}
-	auto gser = Geometry::GetGserialized(geom);
-	auto binary = Geometry::AsBinary(gser, text.GetString());
+	auto lwgeom = Geometry::GetLWGeometry(geom);
+	auto binary = Geometry::AsBinary(lwgeom, text.GetString());
 	idx_t size = LWSIZE_GET(binary->size) - LWVARHDRSZ;
 	auto result_str = StringVector::EmptyString(result, size);
 	memcpy(result_str.GetDataWriteable(), binary->data, size);
 	result_str.Finalize();
-	Geometry::DestroyGeometry(gser);
+	Geometry::DestroyLWGeometry(lwgeom);
 	return result_str;
 }
 
@@ -372,12 +362,12 @@ struct AsTextUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return geom;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		auto text = Geometry::AsText(gser);
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		auto text = Geometry::AsText(lwgeom);
 		auto result_str = StringVector::EmptyString(result, text.size());
 		memcpy(result_str.GetDataWriteable(), text.c_str(), text.size());
 		result_str.Finalize();
-		Geometry::DestroyGeometry(gser);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return result_str;
 	}
 };
@@ -386,12 +376,12 @@ static string_t AsTextScalarFunction(Vector &result, string_t geom, size_t max_d
 	if (geom.GetSize() == 0) {
 		return geom;
 	}
-	auto gser = Geometry::GetGserialized(geom);
-	auto str = Geometry::AsText(gser, max_digits);
+	auto lwgeom = Geometry::GetLWGeometry(geom);
+	auto str = Geometry::AsText(lwgeom, max_digits);
 	auto result_str = StringVector::EmptyString(result, str.size());
 	memcpy(result_str.GetDataWriteable(), str.c_str(), str.size());
 	result_str.Finalize();
-	Geometry::DestroyGeometry(gser);
+	Geometry::DestroyLWGeometry(lwgeom);
 	return result_str;
 }
 
@@ -423,12 +413,13 @@ struct AsGeojsonUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return geom;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		auto geojson = Geometry::AsGeoJson(gser);
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		auto geojson = Geometry::AsGeoJson(lwgeom);
 		std::string geoText = std::string(geojson->data);
 		auto result_str = StringVector::EmptyString(result, geoText.size());
 		memcpy(result_str.GetDataWriteable(), geoText.c_str(), geoText.size());
 		result_str.Finalize();
+		Geometry::DestroyLWGeometry(lwgeom);
 		return result_str;
 	}
 };
@@ -439,13 +430,13 @@ struct AsGeojsonBinaryOperator {
 		if (geom.GetSize() == 0) {
 			return string_t();
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry asgeojson");
 		}
-		auto geojson = Geometry::AsGeoJson(gser, m_dec_digits);
+		auto geojson = Geometry::AsGeoJson(lwgeom, m_dec_digits);
 		std::string geoText = std::string(geojson->data);
-		Geometry::DestroyGeometry(gser);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return string_t(geoText.c_str(), geoText.size());
 	}
 };
@@ -476,20 +467,20 @@ struct GeoHashUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return geom;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry geohash");
 		}
-		auto geojson = Geometry::GeoHash(gser);
+		auto geojson = Geometry::GeoHash(lwgeom);
 		if (!geojson) {
-			Geometry::DestroyGeometry(gser);
+			Geometry::DestroyLWGeometry(lwgeom);
 			return string_t();
 		}
 		std::string geoText = std::string(geojson->data);
 		auto result_str = StringVector::EmptyString(result, geoText.size());
 		memcpy(result_str.GetDataWriteable(), geoText.c_str(), geoText.size());
 		result_str.Finalize();
-		Geometry::DestroyGeometry(gser);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return result_str;
 	}
 };
@@ -499,20 +490,20 @@ static TR GeoHashScalarFunction(Vector &result, TA geom, TB m_chars) {
 	if (geom.GetSize() == 0) {
 		return geom;
 	}
-	auto gser = Geometry::GetGserialized(geom);
-	if (!gser) {
+	auto lwgeom = Geometry::GetLWGeometry(geom);
+	if (!lwgeom) {
 		throw ConversionException("Failure in geometry geohash");
 	}
-	auto geojson = Geometry::GeoHash(gser, m_chars);
+	auto geojson = Geometry::GeoHash(lwgeom, m_chars);
 	if (!geojson) {
-		Geometry::DestroyGeometry(gser);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return string_t();
 	}
 	std::string geoText = std::string(geojson->data);
 	auto result_str = StringVector::EmptyString(result, geoText.size());
 	memcpy(result_str.GetDataWriteable(), geoText.c_str(), geoText.size());
 	result_str.Finalize();
-	Geometry::DestroyGeometry(gser);
+	Geometry::DestroyLWGeometry(lwgeom);
 	return result_str;
 }
 
@@ -538,6 +529,75 @@ void GeoFunctions::GeometryGeoHashFunction(DataChunk &args, ExpressionState &sta
 	}
 }
 
+struct HilbertOperator {
+	static inline bool Key(string_t geom, const GBOX &extent, uint64_t &key) {
+		return Geometry::GeometryHilbert(geom, extent, key);
+	}
+};
+
+struct ZOrderOperator {
+	static inline bool Key(string_t geom, const GBOX &extent, uint64_t &key) {
+		return Geometry::GeometryZOrder(geom, extent, key);
+	}
+};
+
+static GBOX GetSortKeyExtent(string_t extent_geom) {
+	int32_t srid;
+	GBOX extent;
+	if (extent_geom.GetSize() == 0 || !Geometry::GetExtent(extent_geom, srid, extent)) {
+		throw ConversionException("Failure in geometry sort key: the extent must not be empty");
+	}
+	return extent;
+}
+
+//! Space filling curve key of the box centre of each geography, over the whole lon/lat range or a given extent.
+//! A constant extent is read once per chunk.
+template <class OP>
+static void GeometrySortKeyExecutor(DataChunk &args, Vector &result) {
+	auto &geom_arg = args.data[0];
+	auto count = args.size();
+	auto sort_key = [&](string_t geom, const GBOX &extent, ValidityMask &mask, idx_t idx) {
+		uint64_t key = 0;
+		if (geom.GetSize() == 0 || !OP::Key(geom, extent, key)) {
+			mask.SetInvalid(idx);
+		}
+		return key;
+	};
+
+	GBOX extent;
+	if (args.ColumnCount() == 1) {
+		extent.xmin = -180.0;
+		extent.xmax = 180.0;
+		extent.ymin = -90.0;
+		extent.ymax = 90.0;
+	} else if (args.data[1].GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		if (ConstantVector::IsNull(args.data[1])) {
+			result.SetVectorType(VectorType::CONSTANT_VECTOR);
+			ConstantVector::SetNull(result, true);
+			return;
+		}
+		extent = GetSortKeyExtent(ConstantVector::GetData<string_t>(args.data[1])[0]);
+	} else {
+		BinaryExecutor::ExecuteWithNulls<string_t, string_t, uint64_t>(
+		    geom_arg, args.data[1], result, count,
+		    [&](string_t geom, string_t extent_geom, ValidityMask &mask, idx_t idx) {
+			    return sort_key(geom, GetSortKeyExtent(extent_geom), mask, idx);
+		    });
+		return;
+	}
+	UnaryExecutor::ExecuteWithNulls<string_t, uint64_t>(
+	    geom_arg, result, count,
+	    [&](string_t geom, ValidityMask &mask, idx_t idx) { return sort_key(geom, extent, mask, idx); });
+}
+
+void GeoFunctions::GeometryHilbertFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometrySortKeyExecutor<HilbertOperator>(args, result);
+}
+
+void GeoFunctions::GeometryZOrderFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometrySortKeyExecutor<ZOrderOperator>(args, result);
+}
+
 struct GeogFromUnaryOperator {
 	template <class TA, class TR>
 	static inline TR Operation(TA text, Vector &result) {
@@ -549,11 +609,7 @@ struct GeogFromUnaryOperator {
 			throw ConversionException("Failure in geometry parser!");
 			return string_t();
 		}
-		idx_t size = Geometry::GetGeometrySize(gser);
-		auto base = Geometry::GetBase(gser);
-		auto result_str = StringVector::EmptyString(result, size);
-		memcpy(result_str.GetDataWriteable(), base, size);
-		result_str.Finalize();
+		auto result_str = Geometry::SerializeToVector(gser, result);
 		Geometry::DestroyGeometry(gser);
 		return result_str;
 	}
@@ -579,11 +635,7 @@ struct GeomFromGeoJsonUnaryOperator {
 		if (!gser) {
 			throw ConversionException("Failure in geometry from Json: could not convert JSON to geometry");
 		}
-		idx_t size = Geometry::GetGeometrySize(gser);
-		auto base = Geometry::GetBase(gser);
-		auto result_str = StringVector::EmptyString(result, size);
-		memcpy(result_str.GetDataWriteable(), base, size);
-		result_str.Finalize();
+		auto result_str = Geometry::SerializeToVector(gser, result);
 		Geometry::DestroyGeometry(gser);
 		return result_str;
 	}
@@ -599,79 +651,438 @@ void GeoFunctions::GeometryGeomFromGeoJsonFunction(DataChunk &args, ExpressionSt
 	GeometryGeomFromGeoJsonUnaryExecutor<string_t, string_t>(text_arg, result, args.size());
 }
 
+//! The circ tree of a geography argument, kept across rows and chunks of one expression
+struct CircTreeCacheState : public FunctionLocalState {
+	~CircTreeCacheState() override {
+		Geometry::DestroyCircTree(tree);
+	}
+
+	string key;
+	CircTreeGeomCache *tree = nullptr;
+};
+
+unique_ptr<FunctionLocalState> GeoFunctions::InitCircTreeCacheState(ExpressionState &state,
+                                                                    const BoundFunctionExpression &expr,
+                                                                    FunctionData *bind_data) {
+	return make_unique<CircTreeCacheState>();
+}
+
+//! Finds the cached circ tree for the rows of one chunk. An argument gets a tree, replacing the cached one, the second
+//! time in a row it shows up with the same bytes, which covers constant arguments and runs of repeated values.
+class CircTreeLookup {
+public:
+	explicit CircTreeLookup(ExpressionState &state)
+	    : state((CircTreeCacheState *)ExecuteFunctionState::GetFunctionState(state)) {
+	}
+
+	//! The tree of one of the arguments, with argnum set to its position, or nullptr when neither has one
+	CircTreeGeomCache *Get(string_t geom1, string_t geom2, int &argnum) {
+		if (!state) {
+			return nullptr;
+		}
+		if (IsCached(geom1) || IsCached(geom2)) {
+			argnum = IsCached(geom1) ? 1 : 2;
+			return state->tree;
+		}
+		bool repeat1 = has_previous && Equals(previous1, geom1);
+		bool repeat2 = has_previous && Equals(previous2, geom2);
+		has_previous = true;
+		previous1 = geom1;
+		previous2 = geom2;
+		if (!repeat1 && !repeat2) {
+			return nullptr;
+		}
+		auto geom = repeat1 ? geom1 : geom2;
+		Geometry::DestroyCircTree(state->tree);
+		state->tree = nullptr;
+		state->key = string(geom.GetDataUnsafe(), geom.GetSize());
+		state->tree = Geometry::GetCircTree(geom);
+		if (!state->tree) {
+			throw ConversionException("Failure in geography measure: could not decode geography");
+		}
+		hit = geom;
+		has_hit = true;
+		argnum = repeat1 ? 1 : 2;
+		return state->tree;
+	}
+
+private:
+	//! Values of this chunk at the same address are the same value, unless they are inlined into the string_t
+	static bool SameAddress(string_t a, string_t b) {
+		return a.GetSize() > string_t::INLINE_LENGTH && a.GetSize() == b.GetSize() &&
+		       a.GetDataUnsafe() == b.GetDataUnsafe();
+	}
+
+	static bool Equals(string_t a, string_t b) {
+		return SameAddress(a, b) ||
+		       (a.GetSize() == b.GetSize() && memcmp(a.GetDataUnsafe(), b.GetDataUnsafe(), a.GetSize()) == 0);
+	}
+
+	bool IsCached(string_t geom) {
+		if (!state->tree) {
+			return false;
+		}
+		if (has_hit && SameAddress(hit, geom)) {
+			return true;
+		}
+		if (geom.GetSize() != state->key.size() ||
+		    memcmp(geom.GetDataUnsafe(), state->key.data(), geom.GetSize()) != 0) {
+			return false;
+		}
+		hit = geom;
+		has_hit = true;
+		return true;
+	}
+
+	CircTreeCacheState *state;
+	string_t previous1, previous2;
+	bool has_previous = false;
+	string_t hit;
+	bool has_hit = false;
+};
+
+//! The rows of a chunk where both geographies are non-empty points, measured together by the point kernels. All
+//! pairs of a batch share the SRID and spheroid setting of its first row.
+struct PointPairBatch {
+	bool Accepts(int32_t row_srid, bool row_use_spheroid) {
+		if (rows.empty()) {
+			srid = row_srid;
+			use_spheroid = row_use_spheroid;
+		}
+		return srid == row_srid && use_spheroid == row_use_spheroid;
+	}
+
+	void Add(idx_t row, const POINT2D &point1, const POINT2D &point2, double distance) {
+		rows.push_back(row);
+		points1.push_back(point1);
+		points2.push_back(point2);
+		distances.push_back(distance);
+	}
+
+	void Measure(double *out) {
+		Geometry::Distance(points1.data(), points2.data(), rows.size(), srid, use_spheroid, out);
+	}
+
+	void Measure(bool *out) {
+		Geometry::GeometryDWithin(points1.data(), points2.data(), distances.data(), rows.size(), srid, use_spheroid,
+		                          out);
+	}
+
+	vector<idx_t> rows;
+	vector<POINT2D> points1;
+	vector<POINT2D> points2;
+	vector<double> distances;
+	int32_t srid = 0;
+	bool use_spheroid = false;
+};
+
+//! Runs a geography measure over a chunk. Arguments 0 and 1 are the geographies, distance_col and spheroid_col the
+//! optional distance and use_spheroid arguments. Rows of two non-empty points go through the batched point kernel,
+//! every other row through fallback(geom1, geom2, distance, use_spheroid).
+template <class TR, class FUNC>
+static void GeographyPointPairExecutor(DataChunk &args, idx_t distance_col, idx_t spheroid_col, Vector &result,
+                                       FUNC fallback) {
+	auto count = args.size();
+	bool all_constant = true;
+	vector<UnifiedVectorFormat> formats(args.ColumnCount());
+	for (idx_t col = 0; col < args.ColumnCount(); col++) {
+		all_constant = all_constant && args.data[col].GetVectorType() == VectorType::CONSTANT_VECTOR;
+		args.data[col].ToUnifiedFormat(count, formats[col]);
+	}
+	if (all_constant) {
+		count = 1;
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+	} else {
+		result.SetVectorType(VectorType::FLAT_VECTOR);
+	}
+	auto result_data = FlatVector::GetData<TR>(result);
+
+	PointPairBatch batch;
+	for (idx_t i = 0; i < count; i++) {
+		bool is_null = false;
+		for (idx_t col = 0; col < args.ColumnCount(); col++) {
+			is_null = is_null || !formats[col].validity.RowIsValid(formats[col].sel->get_index(i));
+		}
+		if (is_null) {
+			if (all_constant) {
+				ConstantVector::SetNull(result, true);
+			} else {
+				FlatVector::SetNull(result, i, true);
+			}
+			continue;
+		}
+		auto geom1 = ((string_t *)formats[0].data)[formats[0].sel->get_index(i)];
+		auto geom2 = ((string_t *)formats[1].data)[formats[1].sel->get_index(i)];
+		double distance = 0.0;
+		if (distance_col != DConstants::INVALID_INDEX) {
+			auto &format = formats[distance_col];
+			distance = ((double *)format.data)[format.sel->get_index(i)];
+		}
+		bool use_spheroid = false;
+		if (spheroid_col != DConstants::INVALID_INDEX) {
+			auto &format = formats[spheroid_col];
+			use_spheroid = ((bool *)format.data)[format.sel->get_index(i)];
+		}
+
+		int32_t srid1, srid2;
+		POINT2D point1, point2;
+		if (Geometry::GetPoint(geom1, srid1, point1) && Geometry::GetPoint(geom2, srid2, point2) && srid1 == srid2 &&
+		    batch.Accepts(srid1, use_spheroid)) {
+			batch.Add(i, point1, point2, distance);
+			continue;
+		}
+		result_data[i] = fallback(geom1, geom2, distance, use_spheroid);
+	}
+
+	if (batch.rows.empty()) {
+		return;
+	}
+	auto measured = unique_ptr<TR[]>(new TR[batch.rows.size()]);
+	batch.Measure(measured.get());
+	for (idx_t j = 0; j < batch.rows.size(); j++) {
+		result_data[batch.rows[j]] = measured[j];
+	}
+}
+
 struct GeometryDistanceBinaryOperator {
 	template <class TA, class TB, class TR>
-	static inline TR Operation(TA geom1, TB geom2) {
+	static inline TR Operation(TA geom1, TB geom2, CircTreeLookup &trees) {
 		double dis = 0.00;
 		if (geom1.GetSize() == 0 || geom2.GetSize() == 0) {
 			return dis;
 		}
-		auto gser1 = Geometry::GetGserialized(geom1);
-		auto gser2 = Geometry::GetGserialized(geom2);
-		if (!gser1 || !gser2) {
-			if (gser1) {
-				Geometry::DestroyGeometry(gser1);
+		int argnum;
+		auto tree = trees.Get(geom1, geom2, argnum);
+		if (tree) {
+			auto lwgeom = Geometry::GetLWGeometry(argnum == 1 ? geom2 : geom1);
+			if (!lwgeom) {
+				throw ConversionException("Failure in geometry get distance: could not getting distance from geom");
 			}
-			if (gser2) {
-				Geometry::DestroyGeometry(gser2);
+			dis = Geometry::Distance(tree, argnum, lwgeom, false);
+			Geometry::DestroyLWGeometry(lwgeom);
+			return dis;
+		}
+		auto lwgeom1 = Geometry::GetLWGeometry(geom1);
+		auto lwgeom2 = Geometry::GetLWGeometry(geom2);
+		if (!lwgeom1 || !lwgeom2) {
+			if (lwgeom1) {
+				Geometry::DestroyLWGeometry(lwgeom1);
+			}
+			if (lwgeom2) {
+				Geometry::DestroyLWGeometry(lwgeom2);
 			}
 			throw ConversionException("Failure in geometry get distance: could not getting distance from geom");
 			return dis;
 		}
-		dis = Geometry::Distance(gser1, gser2, false);
-		Geometry::DestroyGeometry(gser1);
-		Geometry::DestroyGeometry(gser2);
+		dis = Geometry::Distance(lwgeom1, lwgeom2, false);
+		Geometry::DestroyLWGeometry(lwgeom1);
+		Geometry::DestroyLWGeometry(lwgeom2);
 		return dis;
 	}
 };
 
 struct GeometryDistanceTernaryOperator {
 	template <class TA, class TB, class TC, class TR>
-	static inline TR Operation(TA geom1, TB geom2, TC use_spheroid) {
+	static inline TR Operation(TA geom1, TB geom2, TC use_spheroid, CircTreeLookup &trees) {
 		double dis = 0.00;
 		if (geom1.GetSize() == 0 || geom2.GetSize() == 0) {
 			return dis;
 		}
-		auto gser1 = Geometry::GetGserialized(geom1);
-		auto gser2 = Geometry::GetGserialized(geom2);
-		if (!gser1 || !gser2) {
-			if (gser1) {
-				Geometry::DestroyGeometry(gser1);
+		int argnum;
+		auto tree = trees.Get(geom1, geom2, argnum);
+		if (tree) {
+			auto lwgeom = Geometry::GetLWGeometry(argnum == 1 ? geom2 : geom1);
+			if (!lwgeom) {
+				throw ConversionException("Failure in geometry get distance: could not getting distance from geom");
 			}
-			if (gser2) {
-				Geometry::DestroyGeometry(gser2);
+			dis = Geometry::Distance(tree, argnum, lwgeom, use_spheroid);
+			Geometry::DestroyLWGeometry(lwgeom);
+			return dis;
+		}
+		auto lwgeom1 = Geometry::GetLWGeometry(geom1);
+		auto lwgeom2 = Geometry::GetLWGeometry(geom2);
+		if (!lwgeom1 || !lwgeom2) {
+			if (lwgeom1) {
+				Geometry::DestroyLWGeometry(lwgeom1);
+			}
+			if (lwgeom2) {
+				Geometry::DestroyLWGeometry(lwgeom2);
 			}
 			throw ConversionException("Failure in geometry get distance: could not getting distance from geom");
 			return dis;
 		}
-		dis = Geometry::Distance(gser1, gser2, use_spheroid);
-		Geometry::DestroyGeometry(gser1);
-		Geometry::DestroyGeometry(gser2);
+		dis = Geometry::Distance(lwgeom1, lwgeom2, use_spheroid);
+		Geometry::DestroyLWGeometry(lwgeom1);
+		Geometry::DestroyLWGeometry(lwgeom2);
 		return dis;
 	}
 };
 
 template <typename TA, typename TB, typename TR>
-static void GeometryDistanceBinaryExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count) {
-	BinaryExecutor::ExecuteStandard<TA, TB, TR, GeometryDistanceBinaryOperator>(geom1, geom2, result, count);
+static void GeometryDistanceBinaryExecutor(DataChunk &args, Vector &result, ExpressionState &state) {
+	CircTreeLookup trees(state);
+	GeographyPointPairExecutor<TR>(args, DConstants::INVALID_INDEX, DConstants::INVALID_INDEX, result,
+	                               [&](TA left, TB right, double distance, bool use_spheroid) {
+		                               return GeometryDistanceBinaryOperator::Operation<TA, TB, TR>(left, right, trees);
+	                               });
 }
 
 template <typename TA, typename TB, typename TC, typename TR>
-static void GeometryDistanceTernaryExecutor(Vector &geom1, Vector &geom2, Vector &use_spheroid, Vector &result,
-                                            idx_t count) {
-	TernaryExecutor::Execute<TA, TB, TC, TR>(geom1, geom2, use_spheroid, result, count,
-	                                         GeometryDistanceTernaryOperator::Operation<TA, TB, TC, TR>);
+static void GeometryDistanceTernaryExecutor(DataChunk &args, Vector &result, ExpressionState &state) {
+	CircTreeLookup trees(state);
+	GeographyPointPairExecutor<TR>(args, DConstants::INVALID_INDEX, 2, result,
+	                               [&](TA left, TB right, double distance, TC spheroid) {
+		                               return GeometryDistanceTernaryOperator::Operation<TA, TB, TC, TR>(
+		                                   left, right, spheroid, trees);
+	                               });
 }
 
 void GeoFunctions::GeometryDistanceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &geom1_arg = args.data[0];
-	auto &geom2_arg = args.data[1];
 	if (args.data.size() == 2) {
-		GeometryDistanceBinaryExecutor<string_t, string_t, double>(geom1_arg, geom2_arg, result, args.size());
+		GeometryDistanceBinaryExecutor<string_t, string_t, double>(args, result, state);
 	} else if (args.data.size() == 3) {
-		auto &use_spheroid_arg = args.data[2];
-		GeometryDistanceTernaryExecutor<string_t, string_t, bool, double>(geom1_arg, geom2_arg, use_spheroid_arg,
-		                                                                  result, args.size());
+		GeometryDistanceTernaryExecutor<string_t, string_t, bool, double>(args, result, state);
+	}
+}
+
+//! The knn index of a candidate list, kept across rows and chunks until a row brings a different list
+struct KnnIndexState : public FunctionLocalState {
+	~KnnIndexState() override {
+		Geometry::DestroyKnnIndex(index);
+	}
+
+	CircTreeKnnIndex *Get(const list_entry_t &entry, const UnifiedVectorFormat &member_data) {
+		auto members = (string_t *)member_data.data;
+		if (index && Matches(entry, member_data)) {
+			return index;
+		}
+		Geometry::DestroyKnnIndex(index);
+		index = nullptr;
+		keys.clear();
+		valid.clear();
+		vector<string_t> geoms;
+		for (idx_t i = 0; i < entry.length; i++) {
+			auto idx = member_data.sel->get_index(entry.offset + i);
+			bool is_valid = member_data.validity.RowIsValid(idx) && members[idx].GetSize() > 0;
+			keys.push_back(is_valid ? string(members[idx].GetDataUnsafe(), members[idx].GetSize()) : string());
+			valid.push_back(is_valid);
+			geoms.push_back(is_valid ? members[idx] : string_t());
+		}
+		index = Geometry::GetKnnIndex(geoms, valid);
+		if (!index) {
+			throw ConversionException("Failure in geography knn: could not decode geography");
+		}
+		return index;
+	}
+
+	CircTreeKnnIndex *index = nullptr;
+
+private:
+	vector<string> keys;
+	vector<bool> valid;
+
+	bool Matches(const list_entry_t &entry, const UnifiedVectorFormat &member_data) {
+		auto members = (string_t *)member_data.data;
+		if (entry.length != keys.size()) {
+			return false;
+		}
+		for (idx_t i = 0; i < entry.length; i++) {
+			auto idx = member_data.sel->get_index(entry.offset + i);
+			bool is_valid = member_data.validity.RowIsValid(idx) && members[idx].GetSize() > 0;
+			if (is_valid != valid[i]) {
+				return false;
+			}
+			if (is_valid && (members[idx].GetSize() != keys[i].size() ||
+			                 memcmp(members[idx].GetDataUnsafe(), keys[i].data(), keys[i].size()) != 0)) {
+				return false;
+			}
+		}
+		return true;
+	}
+};
+
+unique_ptr<FunctionLocalState> GeoFunctions::InitKnnIndexState(ExpressionState &state,
+                                                               const BoundFunctionExpression &expr,
+                                                               FunctionData *bind_data) {
+	return make_unique<KnnIndexState>();
+}
+
+//! ST_KNN(probe, candidates, k [, use_spheroid]): the 1-based positions in candidates of the k geographies nearest to
+//! probe, nearest first. The candidates are indexed once, so a constant list such as (SELECT list(geog) FROM depots)
+//! is searched best first by every row instead of being measured against each of them.
+void GeoFunctions::GeometryKNNFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &geom_arg = args.data[0];
+	auto &list_arg = args.data[1];
+	auto &k_arg = args.data[2];
+	auto count = args.size();
+	bool has_spheroid = args.data.size() > 3;
+
+	UnifiedVectorFormat geom_data, list_data, k_data, spheroid_data, member_data;
+	geom_arg.ToUnifiedFormat(count, geom_data);
+	list_arg.ToUnifiedFormat(count, list_data);
+	k_arg.ToUnifiedFormat(count, k_data);
+	if (has_spheroid) {
+		args.data[3].ToUnifiedFormat(count, spheroid_data);
+	}
+	auto &members = ListVector::GetEntry(list_arg);
+	members.ToUnifiedFormat(ListVector::GetListSize(list_arg), member_data);
+	auto geoms = (string_t *)geom_data.data;
+	auto lists = (list_entry_t *)list_data.data;
+	auto ks = (int32_t *)k_data.data;
+
+	KnnIndexState row_state;
+	auto lstate = (KnnIndexState *)ExecuteFunctionState::GetFunctionState(state);
+	auto &index_state = lstate ? *lstate : row_state;
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_entries = FlatVector::GetData<list_entry_t>(result);
+	auto &result_mask = FlatVector::Validity(result);
+	// a constant list is checked against the cached index once per chunk rather than once per row
+	bool list_constant = list_arg.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	CircTreeKnnIndex *index = nullptr;
+	vector<uint32_t> nearest;
+	for (idx_t i = 0; i < count; i++) {
+		auto geom_idx = geom_data.sel->get_index(i);
+		auto list_idx = list_data.sel->get_index(i);
+		auto k_idx = k_data.sel->get_index(i);
+		auto spheroid_idx = has_spheroid ? spheroid_data.sel->get_index(i) : 0;
+		result_entries[i].offset = ListVector::GetListSize(result);
+		result_entries[i].length = 0;
+		if (!geom_data.validity.RowIsValid(geom_idx) || !list_data.validity.RowIsValid(list_idx) ||
+		    !k_data.validity.RowIsValid(k_idx) || (has_spheroid && !spheroid_data.validity.RowIsValid(spheroid_idx))) {
+			result_mask.SetInvalid(i);
+			continue;
+		}
+		if (ks[k_idx] < 0) {
+			throw ConversionException("Failure in geography knn: k must not be negative");
+		}
+		if (geoms[geom_idx].GetSize() == 0 || ks[k_idx] == 0) {
+			continue;
+		}
+		bool use_spheroid = has_spheroid && ((bool *)spheroid_data.data)[spheroid_idx];
+
+		if (!index || !list_constant) {
+			index = index_state.Get(lists[list_idx], member_data);
+		}
+		auto lwgeom = Geometry::GetLWGeometry(geoms[geom_idx]);
+		if (!lwgeom) {
+			throw ConversionException("Failure in geography knn: could not decode geography");
+		}
+		Geometry::KNearest(index, lwgeom, MinValue<idx_t>(ks[k_idx], lists[list_idx].length), use_spheroid,
+		                   nearest);
+		Geometry::DestroyLWGeometry(lwgeom);
+
+		auto offset = result_entries[i].offset;
+		ListVector::Reserve(result, offset + nearest.size());
+		auto positions = FlatVector::GetData<int32_t>(ListVector::GetEntry(result));
+		for (idx_t j = 0; j < nearest.size(); j++) {
+			positions[offset + j] = nearest[j] + 1;
+		}
+		result_entries[i].length = nearest.size();
+		ListVector::SetListSize(result, offset + nearest.size());
+	}
+	if (args.AllConstant()) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
 	}
 }
 
@@ -695,11 +1106,7 @@ struct CentroidUnaryOperator {
 			Geometry::DestroyGeometry(gser);
 			return geom;
 		}
-		idx_t rv_size = Geometry::GetGeometrySize(gserCentroid);
-		auto base = Geometry::GetBase(gserCentroid);
-		auto result_str = StringVector::EmptyString(result, rv_size);
-		memcpy(result_str.GetDataWriteable(), base, rv_size);
-		result_str.Finalize();
+		auto result_str = Geometry::SerializeToVector(gserCentroid, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserCentroid);
 		return result_str;
@@ -747,7 +1154,7 @@ void GeoFunctions::GeometryCentroidFunction(DataChunk &args, ExpressionState &st
 
 struct FromTextUnaryOperator {
 	template <class TA, class TR>
-	static inline TR Operation(TA text) {
+	static inline TR Operation(TA text, Vector &result) {
 		if (text.GetSize() == 0) {
 			return text;
 		}
@@ -756,39 +1163,30 @@ struct FromTextUnaryOperator {
 			throw ConversionException("Failure in geometry from text: could not convert text to geometry");
 			return string_t();
 		}
-		idx_t size = Geometry::GetGeometrySize(gser);
-		auto base = Geometry::GetBase(gser);
+		auto result_str = Geometry::SerializeToVector(gser, result);
 		Geometry::DestroyGeometry(gser);
-		return string_t((const char *)base, size);
+		return result_str;
 	}
 };
 
 template <typename TA, typename TR>
 static void GeometryFromTextUnaryExecutor(Vector &text, Vector &result, idx_t count) {
-	UnaryExecutor::Execute<TA, TR, FromTextUnaryOperator>(text, result, count);
+	UnaryExecutor::ExecuteString<TA, TR, FromTextUnaryOperator>(text, result, count);
 }
 
 void GeoFunctions::GeometryFromTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	int currindex = loopindex;
-	queue.push_back(currindex);
-	loopindex++;
-	while (queue.size() > 0 && queue[0] != currindex) {
-		usleep(30);
-	}
 	try {
 		auto &text_arg = args.data[0];
 		GeometryFromTextUnaryExecutor<string_t, string_t>(text_arg, result, args.size());
 	} catch (const std::exception &e) {
-		queue.erase(queue.begin());
 		throw Exception(e.what());
-		return;
 	}
-	queue.erase(queue.begin());
 }
 
 struct FromWKBUnaryOperator {
 	template <class TA, class TR>
 	static inline TR Operation(TA text, ValidityMask &result_mask, idx_t i, void *dataptr) {
+		auto &result = *(Vector *)dataptr;
 		if (text.GetSize() == 0) {
 			return text;
 		}
@@ -796,10 +1194,9 @@ struct FromWKBUnaryOperator {
 		if (!gser) {
 			throw ConversionException("Failure in geometry from WKB: could not convert WKB to geometry");
 		}
-		idx_t size = Geometry::GetGeometrySize(gser);
-		auto base = Geometry::GetBase(gser);
+		auto result_str = Geometry::SerializeToVector(gser, result);
 		Geometry::DestroyGeometry(gser);
-		return string_t((const char *)base, size);
+		return result_str;
 	}
 };
 
@@ -815,7 +1212,7 @@ void GeoFunctions::GeometryFromWKBFunction(DataChunk &args, ExpressionState &sta
 
 struct FromGeoHashUnaryOperator {
 	template <class TA, class TR>
-	static inline TR Operation(TA text) {
+	static inline TR Operation(TA text, Vector &result) {
 		if (text.GetSize() == 0) {
 			return text;
 		}
@@ -823,16 +1220,15 @@ struct FromGeoHashUnaryOperator {
 		if (!gser) {
 			throw ConversionException("Failure in geometry from geo hash: could not convert geo hash to geometry");
 		}
-		idx_t size = Geometry::GetGeometrySize(gser);
-		auto base = Geometry::GetBase(gser);
+		auto result_str = Geometry::SerializeToVector(gser, result);
 		Geometry::DestroyGeometry(gser);
-		return string_t((const char *)base, size);
+		return result_str;
 	}
 };
 
 struct FromGeoHashBinaryOperator {
 	template <class TA, class TB, class TR>
-	static inline TR Operation(TA text, TB precision) {
+	static inline TR Operation(TA text, TB precision, Vector &result) {
 		if (text.GetSize() == 0) {
 			return text;
 		}
@@ -840,21 +1236,22 @@ struct FromGeoHashBinaryOperator {
 		if (!gser) {
 			throw ConversionException("Failure in geometry from geo hash: could not convert geo hash to geometry");
 		}
-		idx_t size = Geometry::GetGeometrySize(gser);
-		auto base = Geometry::GetBase(gser);
+		auto result_str = Geometry::SerializeToVector(gser, result);
 		Geometry::DestroyGeometry(gser);
-		return string_t((const char *)base, size);
+		return result_str;
 	}
 };
 
 template <typename TA, typename TR>
 static void GeometryFromGeoHashUnaryExecutor(Vector &text, Vector &result, idx_t count) {
-	UnaryExecutor::Execute<TA, TR, FromGeoHashUnaryOperator>(text, result, count);
+	UnaryExecutor::ExecuteString<TA, TR, FromGeoHashUnaryOperator>(text, result, count);
 }
 
 template <typename TA, typename TB, typename TR>
 static void GeometryFromGeoHashBinaryExecutor(Vector &text, Vector &precision, Vector &result, idx_t count) {
-	BinaryExecutor::ExecuteStandard<TA, TB, TR, FromGeoHashBinaryOperator>(text, precision, result, count);
+	BinaryExecutor::Execute<TA, TB, TR>(text, precision, result, count, [&](TA text_val, TB precision_val) {
+		return FromGeoHashBinaryOperator::Operation<TA, TB, TR>(text_val, precision_val, result);
+	});
 }
 
 void GeoFunctions::GeometryFromGeoHashFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -869,7 +1266,7 @@ void GeoFunctions::GeometryFromGeoHashFunction(DataChunk &args, ExpressionState
 
 struct GPointFromGeoHashUnaryOperator {
 	template <class TA, class TR>
-	static inline TR Operation(TA text) {
+	static inline TR Operation(TA text, Vector &result) {
 		if (text.GetSize() == 0) {
 			return text;
 		}
@@ -882,17 +1279,16 @@ struct GPointFromGeoHashUnaryOperator {
 			Geometry::DestroyGeometry(gser);
 			throw ConversionException("Failure in geometry from geo hash: could not convert geo hash to geometry");
 		}
-		idx_t size = Geometry::GetGeometrySize(gserCentroid);
-		auto base = Geometry::GetBase(gserCentroid);
+		auto result_str = Geometry::SerializeToVector(gserCentroid, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserCentroid);
-		return string_t((const char *)base, size);
+		return result_str;
 	}
 };
 
 struct GPointFromGeoHashBinaryOperator {
 	template <class TA, class TB, class TR>
-	static inline TR Operation(TA text, TB precision) {
+	static inline TR Operation(TA text, TB precision, Vector &result) {
 		if (text.GetSize() == 0) {
 			return text;
 		}
@@ -905,22 +1301,23 @@ struct GPointFromGeoHashBinaryOperator {
 			Geometry::DestroyGeometry(gser);
 			throw ConversionException("Failure in geometry from geo hash: could not convert geo hash to geometry");
 		}
-		idx_t size = Geometry::GetGeometrySize(gserCentroid);
-		auto base = Geometry::GetBase(gserCentroid);
+		auto result_str = Geometry::SerializeToVector(gserCentroid, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserCentroid);
-		return string_t((const char *)base, size);
+		return result_str;
 	}
 };
 
 template <typename TA, typename TR>
 static void GeometryGPointFromGeoHashUnaryExecutor(Vector &text, Vector &result, idx_t count) {
-	UnaryExecutor::Execute<TA, TR, GPointFromGeoHashUnaryOperator>(text, result, count);
+	UnaryExecutor::ExecuteString<TA, TR, GPointFromGeoHashUnaryOperator>(text, result, count);
 }
 
 template <typename TA, typename TB, typename TR>
 static void GeometryGPointFromGeoHashBinaryExecutor(Vector &text, Vector &precision, Vector &result, idx_t count) {
-	BinaryExecutor::ExecuteStandard<TA, TB, TR, GPointFromGeoHashBinaryOperator>(text, precision, result, count);
+	BinaryExecutor::Execute<TA, TB, TR>(text, precision, result, count, [&](TA text_val, TB precision_val) {
+		return GPointFromGeoHashBinaryOperator::Operation<TA, TB, TR>(text_val, precision_val, result);
+	});
 }
 
 void GeoFunctions::GeometryGPointFromGeoHashFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -936,7 +1333,7 @@ void GeoFunctions::GeometryGPointFromGeoHashFunction(DataChunk &args, Expression
 
 struct BoundaryUnaryOperator {
 	template <class TA, class TR>
-	static inline TR Operation(TA geom) {
+	static inline TR Operation(TA geom, Vector &result) {
 		if (geom.GetSize() == 0) {
 			return geom;
 		}
@@ -948,17 +1345,16 @@ struct BoundaryUnaryOperator {
 		if (!gserBoundary) {
 			throw ConversionException("Failure in geometry boundary: could not getting boundary from geom");
 		}
-		idx_t size = Geometry::GetGeometrySize(gserBoundary);
-		auto base = Geometry::GetBase(gserBoundary);
+		auto result_str = Geometry::SerializeToVector(gserBoundary, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserBoundary);
-		return string_t((const char *)base, size);
+		return result_str;
 	}
 };
 
 template <typename TA, typename TR>
 static void GeometryBoundaryUnaryExecutor(Vector &geom, Vector &result, idx_t count) {
-	UnaryExecutor::Execute<TA, TR, BoundaryUnaryOperator>(geom, result, count);
+	UnaryExecutor::ExecuteString<TA, TR, BoundaryUnaryOperator>(geom, result, count);
 }
 
 void GeoFunctions::GeometryBoundaryFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -972,13 +1368,13 @@ struct DimensionUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return -1;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry dimension: could not getting dimension from geom");
 			return -1;
 		}
-		auto dimension = Geometry::LWGEOM_dimension(gser);
-		Geometry::DestroyGeometry(gser);
+		auto dimension = Geometry::LWGEOM_dimension(lwgeom);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return dimension;
 	}
 };
@@ -993,132 +1389,88 @@ void GeoFunctions::GeometryDimensionFunction(DataChunk &args, ExpressionState &s
 	GeometryDimensionUnaryExecutor<string_t, int>(geom_arg, result, args.size());
 }
 
-void GeometryDumpOperator(string_t geom, idx_t idx, LogicalType child_type, Vector &result) {
+// Appends the components of geom to the child vector of the list result and points entry at them
+static void GeometryDumpOperator(string_t geom, list_entry_t &entry, Vector &result) {
+	entry.offset = ListVector::GetListSize(result);
+	entry.length = 0;
 	if (geom.GetSize() == 0) {
-		auto val = Value::LIST(child_type, vector<Value> {});
-		result.SetValue(idx, val);
 		return;
 	}
+
+	// components are sliced straight out of the parent EWKB
+	int32_t srid = 0;
+	vector<WKB_COMPONENT> components;
+	if (Geometry::GetDumpComponents(geom, srid, components)) {
+		ListVector::Reserve(result, entry.offset + components.size());
+		auto &child = ListVector::GetEntry(result);
+		auto child_data = FlatVector::GetData<string_t>(child);
+		for (idx_t i = 0; i < components.size(); i++) {
+			auto size = Geometry::DumpComponentSize(components[i], srid);
+			auto str = StringVector::EmptyString(child, size);
+			Geometry::WriteDumpComponent(geom, components[i], srid, str.GetDataWriteable());
+			str.Finalize();
+			child_data[entry.offset + i] = str;
+		}
+		entry.length = components.size();
+		ListVector::SetListSize(result, entry.offset + entry.length);
+		return;
+	}
+
 	auto gser = Geometry::GetGserialized(geom);
 	if (!gser) {
 		throw ConversionException("Failure in geometry dump: could not getting dump from geom");
-		return;
 	}
 	auto gserArray = Geometry::LWGEOM_dump(gser);
+	Geometry::DestroyGeometry(gser);
 
-	vector<Value> geom_values;
+	ListVector::Reserve(result, entry.offset + gserArray.size());
+	auto &child = ListVector::GetEntry(result);
+	auto child_data = FlatVector::GetData<string_t>(child);
 	for (idx_t i = 0; i < gserArray.size(); i++) {
-		auto gserChild = gserArray[i];
-		idx_t rv_size = Geometry::GetGeometrySize(gserChild);
-		auto base = Geometry::GetBase(gserChild);
-		Geometry::DestroyGeometry(gserChild);
-		auto value = Value::BLOB((const_data_ptr_t)base, rv_size);
-		value.GetTypeMutable().CopyAuxInfo(child_type);
-		geom_values.emplace_back(value);
-	}
-	auto val = Value::LIST(child_type, geom_values);
-	result.SetValue(idx, val);
-	Geometry::DestroyGeometry(gser);
+		child_data[entry.offset + i] = Geometry::SerializeToVector(gserArray[i], child);
+		Geometry::DestroyGeometry(gserArray[i]);
+	}
+	entry.length = gserArray.size();
+	ListVector::SetListSize(result, entry.offset + entry.length);
 }
 
 void GeoFunctions::GeometryDumpFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	D_ASSERT(args.GetTypes().size() == 1);
 	auto &geom_arg = args.data[0];
 	auto count = args.size();
-	auto child_type = ListType::GetChildType(result.GetType());
 
-	string_t *ldata;
-	ValidityMask mask, result_mask;
-	switch (geom_arg.GetVectorType()) {
-	case VectorType::CONSTANT_VECTOR: {
-		ldata = ConstantVector::GetData<string_t>(geom_arg);
+	if (geom_arg.GetVectorType() == VectorType::CONSTANT_VECTOR) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
 		if (ConstantVector::IsNull(geom_arg)) {
 			ConstantVector::SetNull(result, true);
 			return;
-		} else {
-			GeometryDumpOperator(ldata[0], 0, child_type, result);
-			return;
 		}
-		break;
-	}
-	case VectorType::FLAT_VECTOR: {
-		ldata = FlatVector::GetData<string_t>(geom_arg);
-		mask = FlatVector::Validity(geom_arg);
-		result_mask = FlatVector::Validity(result);
-		break;
-	}
-	default: {
-		UnifiedVectorFormat vdata;
-		geom_arg.ToUnifiedFormat(count, vdata);
-		ldata = (string_t *)vdata.data;
-		mask = vdata.validity;
-		result_mask = FlatVector::Validity(result);
-		break;
-	}
-	}
-
-	result_mask.Copy(mask, count);
-	idx_t base_idx = 0;
-	auto entry_count = ValidityMask::EntryCount(count);
-	for (idx_t entry_idx = 0; entry_idx < entry_count; entry_idx++) {
-		auto validity_entry = mask.GetValidityEntry(entry_idx);
-		idx_t next = MinValue<idx_t>(base_idx + ValidityMask::BITS_PER_VALUE, count);
-		if (ValidityMask::AllValid(validity_entry)) {
-			// all valid: perform operation
-			for (; base_idx < next; base_idx++) {
-				GeometryDumpOperator(ldata[base_idx], base_idx, child_type, result);
-			}
-		} else if (ValidityMask::NoneValid(validity_entry)) {
-			// nothing valid: skip all
-			base_idx = next;
+		auto ldata = ConstantVector::GetData<string_t>(geom_arg);
+		GeometryDumpOperator(ldata[0], ConstantVector::GetData<list_entry_t>(result)[0], result);
+		return;
+	}
+
+	UnifiedVectorFormat vdata;
+	geom_arg.ToUnifiedFormat(count, vdata);
+	auto ldata = (string_t *)vdata.data;
+	auto result_entries = FlatVector::GetData<list_entry_t>(result);
+	auto &result_mask = FlatVector::Validity(result);
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = vdata.sel->get_index(i);
+		if (!vdata.validity.RowIsValid(idx)) {
+			result_entries[i].offset = ListVector::GetListSize(result);
+			result_entries[i].length = 0;
+			result_mask.SetInvalid(i);
 			continue;
-		} else {
-			// partially valid: need to check individual elements for validity
-			idx_t start = base_idx;
-			for (; base_idx < next; base_idx++) {
-				if (ValidityMask::RowIsValid(validity_entry, base_idx - start)) {
-					D_ASSERT(mask.RowIsValid(base_idx));
-					GeometryDumpOperator(ldata[base_idx], base_idx, child_type, result);
-				} else {
-					auto val = Value::LIST(child_type, vector<Value> {});
-					result.SetValue(base_idx, val);
-					result_mask.SetInvalid(base_idx);
-				}
-			}
 		}
+		GeometryDumpOperator(ldata[idx], result_entries[i], result);
 	}
-
-	// auto geom = ldata[0];
-	// if (geom.GetSize() == 0) {
-	// 	auto val = Value::LIST(child_type, vector<Value> {});
-	// 	result.Reference(val);
-	// 	return;
-	// }
-	// auto gser = Geometry::GetGserialized(geom);
-	// if (!gser) {
-	// 	throw ConversionException("Failure in geometry dump: could not getting dump from geom");
-	// 	return;
-	// }
-	// auto gserArray = Geometry::LWGEOM_dump(gser);
-
-	// vector<Value> geom_values;
-	// for (idx_t i = 0; i < gserArray.size(); i++) {
-	// 	auto gserChild = gserArray[i];
-	// 	idx_t rv_size = Geometry::GetGeometrySize(gserChild);
-	// 	auto base = Geometry::GetBase(gserChild);
-	// 	Geometry::DestroyGeometry(gserChild);
-	// 	auto value = Value::BLOB((const_data_ptr_t)base, rv_size);
-	// 	value.type().CopyAuxInfo(child_type);
-	// 	geom_values.emplace_back(value);
-	// }
-	// auto val = Value::LIST(child_type, geom_values);
-	// result.Reference(val);
-	// Geometry::DestroyGeometry(gser);
 }
 
 struct EndPointUnaryOperator {
 	template <class TA, class TR>
 	static inline TR Operation(TA geom, ValidityMask &result_mask, idx_t i, void *dataptr) {
+		auto &result = *(Vector *)dataptr;
 		if (geom.GetSize() == 0) {
 			return string_t();
 		}
@@ -1133,11 +1485,10 @@ struct EndPointUnaryOperator {
 			result_mask.SetInvalid(i);
 			return string_t();
 		}
-		idx_t size = Geometry::GetGeometrySize(gserEndpoint);
-		auto base = Geometry::GetBase(gserEndpoint);
+		auto result_str = Geometry::SerializeToVector(gserEndpoint, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserEndpoint);
-		return string_t((const char *)base, size);
+		return result_str;
 	}
 };
 
@@ -1157,17 +1508,11 @@ struct TypeUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return string_t();
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
-			throw ConversionException("Failure in geometry dimension: could not getting dimension from geom");
-			return string_t();
-		}
-		auto geometrytype = Geometry::Geometrytype(gser);
+		auto geometrytype = Geometry::Geometrytype(geom);
 		auto rv_size = geometrytype.size();
 		auto result_str = StringVector::EmptyString(result, rv_size);
 		memcpy(result_str.GetDataWriteable(), geometrytype.c_str(), rv_size);
 		result_str.Finalize();
-		Geometry::DestroyGeometry(gser);
 		return result_str;
 	}
 };
@@ -1188,13 +1533,13 @@ struct IsClosedUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return false;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry is closed: could not getting closed from geom");
 			return false;
 		}
-		auto isClosed = Geometry::IsClosed(gser);
-		Geometry::DestroyGeometry(gser);
+		auto isClosed = Geometry::IsClosed(lwgeom);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return isClosed;
 	}
 };
@@ -1215,13 +1560,13 @@ struct IsCollectionUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return false;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry is collection: could not getting collection from geom");
 			return false;
 		}
-		auto isCollection = Geometry::IsCollection(gser);
-		Geometry::DestroyGeometry(gser);
+		auto isCollection = Geometry::IsCollection(lwgeom);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return isCollection;
 	}
 };
@@ -1242,14 +1587,7 @@ struct IsEmptyUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return true;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
-			throw ConversionException("Failure in geometry is empty: could not getting empty from geom");
-			return true;
-		}
-		auto isEmpty = Geometry::IsEmpty(gser);
-		Geometry::DestroyGeometry(gser);
-		return isEmpty;
+		return Geometry::IsEmpty(geom);
 	}
 };
 
@@ -1296,13 +1634,13 @@ struct NPointsUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return 0;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry is ring: could not getting ring from geom");
 			return 0;
 		}
-		auto nPoints = Geometry::NPoints(gser);
-		Geometry::DestroyGeometry(gser);
+		auto nPoints = Geometry::NPoints(lwgeom);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return nPoints;
 	}
 };
@@ -1323,14 +1661,7 @@ struct NumGeometriesUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return 0;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
-			throw ConversionException("Failure in geometry is ring: could not getting ring from geom");
-			return 0;
-		}
-		auto numGeometries = Geometry::NumGeometries(gser);
-		Geometry::DestroyGeometry(gser);
-		return numGeometries;
+		return Geometry::NumGeometries(geom);
 	}
 };
 
@@ -1350,13 +1681,13 @@ struct NumPointsUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return 0;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry is ring: could not getting ring from geom");
 			return 0;
 		}
-		auto numPoints = Geometry::NumPoints(gser);
-		Geometry::DestroyGeometry(gser);
+		auto numPoints = Geometry::NumPoints(lwgeom);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return numPoints;
 	}
 };
@@ -1386,11 +1717,7 @@ static TR PointNScalarFunction(Vector &result, TA geom, TB index, ValidityMask &
 		mask.SetInvalid(idx);
 		return string_t();
 	}
-	idx_t rv_size = Geometry::GetGeometrySize(gserPointN);
-	auto base = Geometry::GetBase(gserPointN);
-	auto result_str = StringVector::EmptyString(result, rv_size);
-	memcpy(result_str.GetDataWriteable(), base, rv_size);
-	result_str.Finalize();
+	auto result_str = Geometry::SerializeToVector(gserPointN, result);
 	Geometry::DestroyGeometry(gser);
 	Geometry::DestroyGeometry(gserPointN);
 	return result_str;
@@ -1413,6 +1740,7 @@ void GeoFunctions::GeometryPointNFunction(DataChunk &args, ExpressionState &stat
 struct StartPointUnaryOperator {
 	template <class INPUT_TYPE, class RESULT_TYPE>
 	static inline RESULT_TYPE Operation(INPUT_TYPE geom, ValidityMask &result_mask, idx_t i, void *dataptr) {
+		auto &result = *(Vector *)dataptr;
 		if (geom.GetSize() == 0) {
 			return string_t();
 		}
@@ -1426,11 +1754,10 @@ struct StartPointUnaryOperator {
 			result_mask.SetInvalid(i);
 			return string_t();
 		}
-		idx_t rv_size = Geometry::GetGeometrySize(gserStartPoint);
-		auto base = Geometry::GetBase(gserStartPoint);
+		auto result_str = Geometry::SerializeToVector(gserStartPoint, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserStartPoint);
-		return string_t((const char *)base, rv_size);
+		return result_str;
 		;
 	}
 };
@@ -1453,14 +1780,7 @@ struct GetXUnaryOperator {
 			//     "Failure in geometry get X: could not get coordinate X from geometry");
 			return 0.00;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
-			throw ConversionException("Failure in geometry gets X: could not getting X from geom");
-			return 0.00;
-		}
-		double x_val = Geometry::XPoint(gser);
-		Geometry::DestroyGeometry(gser);
-		return x_val;
+		return Geometry::XPoint(geom);
 	}
 };
 
@@ -1482,14 +1802,7 @@ struct GetYUnaryOperator {
 			//     "Failure in geometry get X: could not get coordinate X from geometry");
 			return 0.00;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
-			throw ConversionException("Failure in geometry gets Y: could not getting Y from geom");
-			return 0.00;
-		}
-		double y_val = Geometry::YPoint(gser);
-		Geometry::DestroyGeometry(gser);
-		return y_val;
+		return Geometry::YPoint(geom);
 	}
 };
 
@@ -1503,6 +1816,61 @@ void GeoFunctions::GeometryGetYFunction(DataChunk &args, ExpressionState &state,
 	GeometryGetYUnaryExecutor<string_t, double>(geom_arg, result, args.size());
 }
 
+struct XMinOperator {
+	static inline double Bound(const GBOX &box) {
+		return box.xmin;
+	}
+};
+
+struct XMaxOperator {
+	static inline double Bound(const GBOX &box) {
+		return box.xmax;
+	}
+};
+
+struct YMinOperator {
+	static inline double Bound(const GBOX &box) {
+		return box.ymin;
+	}
+};
+
+struct YMaxOperator {
+	static inline double Bound(const GBOX &box) {
+		return box.ymax;
+	}
+};
+
+//! One side of the 2D box of each geography, read from the EWKB without decoding it. Empty geographies give NULL.
+template <class OP>
+static void GeometryBoundExecutor(Vector &geom, Vector &result, idx_t count) {
+	UnaryExecutor::ExecuteWithNulls<string_t, double>(
+	    geom, result, count, [&](string_t geom_val, ValidityMask &mask, idx_t idx) {
+		    int32_t srid;
+		    GBOX box;
+		    if (geom_val.GetSize() == 0 || !Geometry::GetExtent(geom_val, srid, box)) {
+			    mask.SetInvalid(idx);
+			    return 0.0;
+		    }
+		    return OP::Bound(box);
+	    });
+}
+
+void GeoFunctions::GeometryXMinFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometryBoundExecutor<XMinOperator>(args.data[0], result, args.size());
+}
+
+void GeoFunctions::GeometryXMaxFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometryBoundExecutor<XMaxOperator>(args.data[0], result, args.size());
+}
+
+void GeoFunctions::GeometryYMinFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometryBoundExecutor<YMinOperator>(args.data[0], result, args.size());
+}
+
+void GeoFunctions::GeometryYMaxFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	GeometryBoundExecutor<YMaxOperator>(args.data[0], result, args.size());
+}
+
 template <typename TA, typename TB, typename TR>
 static TR DifferenceScalarFunction(Vector &result, TA geom1, TB geom2) {
 	if (geom1.GetSize() == 0 && geom2.GetSize() == 0) {
@@ -1526,11 +1894,7 @@ static TR DifferenceScalarFunction(Vector &result, TA geom1, TB geom2) {
 		return string_t();
 	}
 	auto gserDiff = Geometry::Difference(gser1, gser2);
-	idx_t rv_size = Geometry::GetGeometrySize(gserDiff);
-	auto base = Geometry::GetBase(gserDiff);
-	auto result_str = StringVector::EmptyString(result, rv_size);
-	memcpy(result_str.GetDataWriteable(), base, rv_size);
-	result_str.Finalize();
+	auto result_str = Geometry::SerializeToVector(gserDiff, result);
 	Geometry::DestroyGeometry(gser1);
 	Geometry::DestroyGeometry(gser2);
 	Geometry::DestroyGeometry(gserDiff);
@@ -1568,11 +1932,7 @@ static TR ClosestPointScalarFunction(Vector &result, TA geom1, TB geom2) {
 		return string_t();
 	}
 	auto gserClosestPoint = Geometry::ClosestPoint(gser1, gser2);
-	idx_t rv_size = Geometry::GetGeometrySize(gserClosestPoint);
-	auto base = Geometry::GetBase(gserClosestPoint);
-	auto result_str = StringVector::EmptyString(result, rv_size);
-	memcpy(result_str.GetDataWriteable(), base, rv_size);
-	result_str.Finalize();
+	auto result_str = Geometry::SerializeToVector(gserClosestPoint, result);
 	Geometry::DestroyGeometry(gser1);
 	Geometry::DestroyGeometry(gser2);
 	Geometry::DestroyGeometry(gserClosestPoint);
@@ -1610,11 +1970,7 @@ static TR UnionScalarFunction(Vector &result, TA geom1, TB geom2) {
 		return string_t();
 	}
 	auto gserUnion = Geometry::GeometryUnion(gser1, gser2);
-	idx_t rv_size = Geometry::GetGeometrySize(gserUnion);
-	auto base = Geometry::GetBase(gserUnion);
-	auto result_str = StringVector::EmptyString(result, rv_size);
-	memcpy(result_str.GetDataWriteable(), base, rv_size);
-	result_str.Finalize();
+	auto result_str = Geometry::SerializeToVector(gserUnion, result);
 	Geometry::DestroyGeometry(gser1);
 	Geometry::DestroyGeometry(gser2);
 	Geometry::DestroyGeometry(gserUnion);
@@ -1686,15 +2042,14 @@ void GeoFunctions::GeometryUnionArrayFunction(DataChunk &args, ExpressionState &
 		}
 		auto gsergeom = Geometry::GeometryUnionGArray(&gserArray[0], list_entry.length);
 		if (gsergeom) {
-			idx_t rv_size = Geometry::GetGeometrySize(gsergeom);
-			auto base = Geometry::GetBase(gsergeom);
+			auto result_str = Geometry::SerializeToVector(gsergeom, result);
 			if (list_entry.length > 1) {
 				for (idx_t child_idx = 0; child_idx < list_entry.length; child_idx++) {
 					Geometry::DestroyGeometry(gserArray[child_idx]);
 				}
 			}
 			Geometry::DestroyGeometry(gsergeom);
-			result_entries[i] = string_t((const char *)base, rv_size);
+			result_entries[i] = result_str;
 		} else {
 			result_entries[i] = string_t();
 		}
@@ -1719,11 +2074,7 @@ static TR IntersectionScalarFunction(Vector &result, TA geom1, TB geom2) {
 		return string_t();
 	}
 	auto gserIntersection = Geometry::GeometryIntersection(gser1, gser2);
-	idx_t rv_size = Geometry::GetGeometrySize(gserIntersection);
-	auto base = Geometry::GetBase(gserIntersection);
-	auto result_str = StringVector::EmptyString(result, rv_size);
-	memcpy(result_str.GetDataWriteable(), base, rv_size);
-	result_str.Finalize();
+	auto result_str = Geometry::SerializeToVector(gserIntersection, result);
 	Geometry::DestroyGeometry(gser1);
 	Geometry::DestroyGeometry(gser2);
 	Geometry::DestroyGeometry(gserIntersection);
@@ -1762,11 +2113,7 @@ static TR SimplifyScalarFunction(Vector &result, TA geom, TB dist) {
 		Geometry::DestroyGeometry(gser);
 		return geom;
 	}
-	idx_t rv_size = Geometry::GetGeometrySize(gserSimplify);
-	auto base = Geometry::GetBase(gserSimplify);
-	auto result_str = StringVector::EmptyString(result, rv_size);
-	memcpy(result_str.GetDataWriteable(), base, rv_size);
-	result_str.Finalize();
+	auto result_str = Geometry::SerializeToVector(gserSimplify, result);
 	Geometry::DestroyGeometry(gser);
 	Geometry::DestroyGeometry(gserSimplify);
 	return result_str;
@@ -1787,7 +2134,7 @@ void GeoFunctions::GeometrySimplifyFunction(DataChunk &args, ExpressionState &st
 
 struct ConvexhullUnaryOperator {
 	template <class TA, class TR>
-	static inline TR Operation(TA geom) {
+	static inline TR Operation(TA geom, Vector &result) {
 		if (geom.GetSize() == 0) {
 			return geom;
 		}
@@ -1803,17 +2150,16 @@ struct ConvexhullUnaryOperator {
 			Geometry::DestroyGeometry(gser);
 			return string_t();
 		}
-		idx_t size = Geometry::GetGeometrySize(gserConvex);
-		auto base = Geometry::GetBase(gserConvex);
+		auto result_str = Geometry::SerializeToVector(gserConvex, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserConvex);
-		return string_t((const char *)base, size);
+		return result_str;
 	}
 };
 
 template <typename TA, typename TR>
 static void GeometryConvexhullUnaryExecutor(Vector &geom, Vector &result, idx_t count) {
-	UnaryExecutor::Execute<TA, TR, ConvexhullUnaryOperator>(geom, result, count);
+	UnaryExecutor::ExecuteString<TA, TR, ConvexhullUnaryOperator>(geom, result, count);
 }
 
 void GeoFunctions::GeometryConvexhullFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -1840,11 +2186,7 @@ static TR SnapToGridScalarFunction(Vector &result, TA geom, TB size) {
 		Geometry::DestroyGeometry(gser);
 		return geom;
 	}
-	idx_t rv_size = Geometry::GetGeometrySize(gserSnapTogrid);
-	auto base = Geometry::GetBase(gserSnapTogrid);
-	auto result_str = StringVector::EmptyString(result, rv_size);
-	memcpy(result_str.GetDataWriteable(), base, rv_size);
-	result_str.Finalize();
+	auto result_str = Geometry::SerializeToVector(gserSnapTogrid, result);
 	Geometry::DestroyGeometry(gser);
 	Geometry::DestroyGeometry(gserSnapTogrid);
 	return result_str;
@@ -1882,11 +2224,7 @@ static TR BufferScalarFunction(Vector &result, TA geom, TB radius) {
 		Geometry::DestroyGeometry(gser);
 		return geom;
 	}
-	idx_t rv_size = Geometry::GetGeometrySize(gserBuffer);
-	auto base = Geometry::GetBase(gserBuffer);
-	auto result_str = StringVector::EmptyString(result, rv_size);
-	memcpy(result_str.GetDataWriteable(), base, rv_size);
-	result_str.Finalize();
+	auto result_str = Geometry::SerializeToVector(gserBuffer, result);
 	Geometry::DestroyGeometry(gser);
 	Geometry::DestroyGeometry(gserBuffer);
 	return result_str;
@@ -1907,7 +2245,7 @@ void GeoFunctions::GeometryBufferFunction(DataChunk &args, ExpressionState &stat
 
 struct BufferTextTernaryOperator {
 	template <class TA, class TB, class TC, class TR>
-	static inline TR Operation(TA geom, TB radius, TC styles) {
+	static inline TR Operation(TA geom, TB radius, TC styles, Vector &result) {
 		if (geom.GetSize() == 0) {
 			return string_t();
 		}
@@ -1925,18 +2263,19 @@ struct BufferTextTernaryOperator {
 			Geometry::DestroyGeometry(gser);
 			return geom;
 		}
-		idx_t rv_size = Geometry::GetGeometrySize(gserBuffer);
-		auto base = Geometry::GetBase(gserBuffer);
+		auto result_str = Geometry::SerializeToVector(gserBuffer, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserBuffer);
-		return string_t((const char *)base, rv_size);
+		return result_str;
 	}
 };
 
 template <typename TA, typename TB, typename TC, typename TR>
 static void BufferTextTernaryExecutor(Vector &geom, Vector &radius, Vector &styles, Vector &result, idx_t count) {
-	TernaryExecutor::Execute<TA, TB, TC, TR>(geom, radius, styles, result, count,
-	                                         BufferTextTernaryOperator::Operation<TA, TB, TC, TR>);
+	TernaryExecutor::Execute<TA, TB, TC, TR>(
+	    geom, radius, styles, result, count, [&](TA geom_val, TB radius_val, TC styles_val) {
+		    return BufferTextTernaryOperator::Operation<TA, TB, TC, TR>(geom_val, radius_val, styles_val, result);
+	    });
 }
 
 void GeoFunctions::GeometryBufferTextFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -1986,7 +2325,142 @@ void GeoFunctions::GeometryEqualsFunction(DataChunk &args, ExpressionState &stat
 	GeometryEqualsBinaryExecutor<string_t, string_t, bool>(geom1_arg, geom2_arg, result, args.size());
 }
 
+//! The constant argument of a predicate, decoded once and kept until the constant changes or the expression goes away
+struct PreparedGeometryState : public FunctionLocalState {
+	~PreparedGeometryState() override {
+		Geometry::DestroyPreparedGeometry(prepared);
+	}
+
+	PrepGeomCache *Get(string_t geom) {
+		if (prepared && key.size() == geom.GetSize() && memcmp(key.data(), geom.GetDataUnsafe(), key.size()) == 0) {
+			return prepared;
+		}
+		Geometry::DestroyPreparedGeometry(prepared);
+		prepared = nullptr;
+		key = string(geom.GetDataUnsafe(), geom.GetSize());
+		prepared = Geometry::GetPreparedGeometry(geom);
+		if (!prepared) {
+			throw ConversionException("Failure in geometry predicate: could not decode geometry");
+		}
+		has_gbox = Geometry::GetGBox(geom, srid, gbox);
+		return prepared;
+	}
+
+	string key;
+	PrepGeomCache *prepared = nullptr;
+	int32_t srid;
+	GBOX gbox;
+	bool has_gbox = false;
+};
+
+unique_ptr<FunctionLocalState> GeoFunctions::InitPreparedGeometryState(ExpressionState &state,
+                                                                       const BoundFunctionExpression &expr,
+                                                                       FunctionData *bind_data) {
+	return make_unique<PreparedGeometryState>();
+}
+
+//! Binary predicate with one constant argument, as in a filter against a literal or the nested loop join probing one
+//! row against a whole chunk. The constant comes prepared from the function state; rows whose EWKB extent already
+//! rules out a match are answered without being decoded, and against a (multi)polygon the point rows are collected
+//! and located in one batch.
+template <class OP>
+static void GeometryPredicateExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count,
+                                      ExpressionState &state) {
+	bool left_constant = geom1.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	bool right_constant = geom2.GetVectorType() == VectorType::CONSTANT_VECTOR;
+	if (left_constant == right_constant) {
+		BinaryExecutor::ExecuteStandard<string_t, string_t, bool, OP>(geom1, geom2, result, count);
+		return;
+	}
+	auto &constant_arg = left_constant ? geom1 : geom2;
+	auto &other_arg = left_constant ? geom2 : geom1;
+	if (ConstantVector::IsNull(constant_arg)) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
+		ConstantVector::SetNull(result, true);
+		return;
+	}
+	auto constant = ConstantVector::GetData<string_t>(constant_arg)[0];
+	if (constant.GetSize() == 0) {
+		BinaryExecutor::ExecuteStandard<string_t, string_t, bool, OP>(geom1, geom2, result, count);
+		return;
+	}
+	PreparedGeometryState chunk_state;
+	auto lstate = (PreparedGeometryState *)ExecuteFunctionState::GetFunctionState(state);
+	auto &prepared_state = lstate ? *lstate : chunk_state;
+	auto prepared = prepared_state.Get(constant);
+	int argnum = left_constant ? 1 : 2;
+	bool locate_points = prepared_state.has_gbox && OP::Locates(argnum) && Geometry::CanLocatePoints(prepared);
+	vector<idx_t> point_rows;
+	vector<double> xs, ys;
+
+	UnifiedVectorFormat other_data;
+	other_arg.ToUnifiedFormat(count, other_data);
+	auto other_entries = (string_t *)other_data.data;
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_data = FlatVector::GetData<bool>(result);
+	auto &result_validity = FlatVector::Validity(result);
+	for (idx_t i = 0; i < count; i++) {
+		auto idx = other_data.sel->get_index(i);
+		if (!other_data.validity.RowIsValid(idx)) {
+			result_validity.SetInvalid(i);
+			continue;
+		}
+		auto other = other_entries[idx];
+		if (other.GetSize() == 0) {
+			result_data[i] = false;
+			continue;
+		}
+		int32_t other_srid;
+		POINT2D point;
+		if (locate_points && Geometry::GetPoint(other, other_srid, point) && other_srid == prepared_state.srid) {
+			point_rows.push_back(i);
+			xs.push_back(point.x);
+			ys.push_back(point.y);
+			continue;
+		}
+		GBOX other_box;
+		if (prepared_state.has_gbox && Geometry::GetGBox(other, other_srid, other_box) &&
+		    other_srid == prepared_state.srid &&
+		    (left_constant ? OP::RulesOut(prepared_state.gbox, other_box)
+		                   : OP::RulesOut(other_box, prepared_state.gbox))) {
+			result_data[i] = false;
+			continue;
+		}
+		auto other_gser = Geometry::GetGserialized(other);
+		if (!other_gser) {
+			throw ConversionException("Failure in geometry predicate: could not decode geometry");
+		}
+		result_data[i] = OP::Refine(prepared, argnum, other_gser);
+		Geometry::DestroyGeometry(other_gser);
+	}
+	if (!point_rows.empty()) {
+		vector<int> locations;
+		Geometry::LocatePoints(prepared, xs, ys, locations);
+		for (idx_t k = 0; k < point_rows.size(); k++) {
+			result_data[point_rows[k]] = OP::Located(locations[k]);
+		}
+	}
+}
+
 struct ContainsBinaryOperator {
+	static inline bool Refine(PrepGeomCache *prepared, int argnum, GSERIALIZED *gser) {
+		return Geometry::GeometryContains(prepared, argnum, gser);
+	}
+
+	//! A polygon as argument 1 contains the points strictly inside it
+	static inline bool Locates(int argnum) {
+		return argnum == 1;
+	}
+
+	static inline bool Located(int location) {
+		return location == 1;
+	}
+
+	static inline bool RulesOut(const GBOX &box1, const GBOX &box2) {
+		return !gbox_contains_2d(&box1, &box2);
+	}
+
 	template <class TA, class TB, class TR>
 	static inline TR Operation(TA geom1, TB geom2) {
 		if (geom1.GetSize() == 0 && geom2.GetSize() == 0) {
@@ -2015,14 +2489,15 @@ struct ContainsBinaryOperator {
 };
 
 template <typename TA, typename TB, typename TR>
-static void GeometryContainsBinaryExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count) {
-	BinaryExecutor::ExecuteStandard<TA, TB, TR, ContainsBinaryOperator>(geom1, geom2, result, count);
+static void GeometryContainsBinaryExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count,
+                                           ExpressionState &state) {
+	GeometryPredicateExecutor<ContainsBinaryOperator>(geom1, geom2, result, count, state);
 }
 
 void GeoFunctions::GeometryContainsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &geom1_arg = args.data[0];
 	auto &geom2_arg = args.data[1];
-	GeometryContainsBinaryExecutor<string_t, string_t, bool>(geom1_arg, geom2_arg, result, args.size());
+	GeometryContainsBinaryExecutor<string_t, string_t, bool>(geom1_arg, geom2_arg, result, args.size(), state);
 }
 
 struct TouchesBinaryOperator {
@@ -2065,6 +2540,22 @@ void GeoFunctions::GeometryTouchesFunction(DataChunk &args, ExpressionState &sta
 }
 
 struct WithInBinaryOperator {
+	static inline bool Refine(PrepGeomCache *prepared, int argnum, GSERIALIZED *gser) {
+		return Geometry::GeometryWithin(prepared, argnum, gser);
+	}
+
+	static inline bool Locates(int argnum) {
+		return argnum == 2;
+	}
+
+	static inline bool Located(int location) {
+		return location == 1;
+	}
+
+	static inline bool RulesOut(const GBOX &box1, const GBOX &box2) {
+		return !gbox_contains_2d(&box2, &box1);
+	}
+
 	template <class TA, class TB, class TR>
 	static inline TR Operation(TA geom1, TB geom2) {
 		if (geom1.GetSize() == 0 && geom2.GetSize() == 0) {
@@ -2093,17 +2584,35 @@ struct WithInBinaryOperator {
 };
 
 template <typename TA, typename TB, typename TR>
-static void GeometryWithinBinaryExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count) {
-	BinaryExecutor::ExecuteStandard<TA, TB, TR, WithInBinaryOperator>(geom1, geom2, result, count);
+static void GeometryWithinBinaryExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count,
+                                         ExpressionState &state) {
+	GeometryPredicateExecutor<WithInBinaryOperator>(geom1, geom2, result, count, state);
 }
 
 void GeoFunctions::GeometryWithinFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &geom1_arg = args.data[0];
 	auto &geom2_arg = args.data[1];
-	GeometryWithinBinaryExecutor<string_t, string_t, bool>(geom1_arg, geom2_arg, result, args.size());
+	GeometryWithinBinaryExecutor<string_t, string_t, bool>(geom1_arg, geom2_arg, result, args.size(), state);
 }
 
 struct IntersectsBinaryOperator {
+	static inline bool Refine(PrepGeomCache *prepared, int argnum, GSERIALIZED *gser) {
+		return Geometry::GeometryIntersects(prepared, argnum, gser);
+	}
+
+	//! Points on the boundary intersect too
+	static inline bool Locates(int argnum) {
+		return true;
+	}
+
+	static inline bool Located(int location) {
+		return location != -1;
+	}
+
+	static inline bool RulesOut(const GBOX &box1, const GBOX &box2) {
+		return !gbox_overlaps_2d(&box1, &box2);
+	}
+
 	template <class TA, class TB, class TR>
 	static inline TR Operation(TA geom1, TB geom2) {
 		if (geom1.GetSize() == 0 && geom2.GetSize() == 0) {
@@ -2132,14 +2641,15 @@ struct IntersectsBinaryOperator {
 };
 
 template <typename TA, typename TB, typename TR>
-static void GeometryIntersectsBinaryExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count) {
-	BinaryExecutor::ExecuteStandard<TA, TB, TR, IntersectsBinaryOperator>(geom1, geom2, result, count);
+static void GeometryIntersectsBinaryExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count,
+                                             ExpressionState &state) {
+	GeometryPredicateExecutor<IntersectsBinaryOperator>(geom1, geom2, result, count, state);
 }
 
 void GeoFunctions::GeometryIntersectsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &geom1_arg = args.data[0];
 	auto &geom2_arg = args.data[1];
-	GeometryIntersectsBinaryExecutor<string_t, string_t, bool>(geom1_arg, geom2_arg, result, args.size());
+	GeometryIntersectsBinaryExecutor<string_t, string_t, bool>(geom1_arg, geom2_arg, result, args.size(), state);
 }
 
 struct CoversBinaryOperator {
@@ -2261,77 +2771,169 @@ void GeoFunctions::GeometryDisjointFunction(DataChunk &args, ExpressionState &st
 
 struct DWithinTernaryOperator {
 	template <class TA, class TB, class TC, class TR>
-	static inline TR Operation(TA geom1, TB geom2, TC distance) {
+	static inline TR Operation(TA geom1, TB geom2, TC distance, CircTreeLookup &trees) {
 		if (geom1.GetSize() == 0 && geom2.GetSize() == 0) {
 			return true;
 		}
 		if (geom1.GetSize() == 0 || geom2.GetSize() == 0) {
 			return false;
 		}
-		auto gser1 = Geometry::GetGserialized(geom1);
-		auto gser2 = Geometry::GetGserialized(geom2);
-		if (!gser1 || !gser2) {
-			if (gser1) {
-				Geometry::DestroyGeometry(gser1);
+		int argnum;
+		auto tree = trees.Get(geom1, geom2, argnum);
+		if (tree) {
+			auto lwgeom = Geometry::GetLWGeometry(argnum == 1 ? geom2 : geom1);
+			if (!lwgeom) {
+				throw ConversionException("Failure in geometry get dwithin: could not getting dwithin from geom");
 			}
-			if (gser2) {
-				Geometry::DestroyGeometry(gser2);
+			auto dWithinRv = Geometry::GeometryDWithin(tree, argnum, lwgeom, distance, false);
+			Geometry::DestroyLWGeometry(lwgeom);
+			return dWithinRv;
+		}
+		auto lwgeom1 = Geometry::GetLWGeometry(geom1);
+		auto lwgeom2 = Geometry::GetLWGeometry(geom2);
+		if (!lwgeom1 || !lwgeom2) {
+			if (lwgeom1) {
+				Geometry::DestroyLWGeometry(lwgeom1);
+			}
+			if (lwgeom2) {
+				Geometry::DestroyLWGeometry(lwgeom2);
 			}
 			throw ConversionException("Failure in geometry get dwithin: could not getting dwithin from geom");
 			return false;
 		}
-		auto dWithinRv = Geometry::GeometryDWithin(gser1, gser2, distance, false);
-		Geometry::DestroyGeometry(gser1);
-		Geometry::DestroyGeometry(gser2);
+		auto dWithinRv = Geometry::GeometryDWithin(lwgeom1, lwgeom2, distance, false);
+		Geometry::DestroyLWGeometry(lwgeom1);
+		Geometry::DestroyLWGeometry(lwgeom2);
 		return dWithinRv;
 	}
 };
 
 template <typename TA, typename TB, typename TC, typename TR>
-static void GeometryDWithinTernaryExecutor(Vector &geom1, Vector &geom2, Vector &distance, Vector &result,
-                                           idx_t count) {
-	TernaryExecutor::Execute<TA, TB, TC, TR>(geom1, geom2, distance, result, count,
-	                                         DWithinTernaryOperator::Operation<TA, TB, TC, TR>);
+static void GeometryDWithinTernaryExecutor(DataChunk &args, Vector &result, ExpressionState &state) {
+	CircTreeLookup trees(state);
+	GeographyPointPairExecutor<TR>(args, 2, DConstants::INVALID_INDEX, result,
+	                               [&](TA left, TB right, TC dist, bool use_spheroid) {
+		                               return DWithinTernaryOperator::Operation<TA, TB, TC, TR>(left, right, dist,
+		                                                                                        trees);
+	                               });
 }
 
-static bool DWithinQuaternaryScalarFunction(string_t geom1, string_t geom2, double distance, bool use_spheroid) {
+static bool DWithinQuaternaryScalarFunction(string_t geom1, string_t geom2, double distance, bool use_spheroid,
+                                            CircTreeLookup &trees) {
 	if (geom1.GetSize() == 0 || geom2.GetSize() == 0) {
 		return false;
 	}
-	auto gser1 = Geometry::GetGserialized(geom1);
-	auto gser2 = Geometry::GetGserialized(geom2);
-	if (!gser1 || !gser2) {
-		if (gser1) {
-			Geometry::DestroyGeometry(gser1);
+	int argnum;
+	auto tree = trees.Get(geom1, geom2, argnum);
+	if (tree) {
+		auto lwgeom = Geometry::GetLWGeometry(argnum == 1 ? geom2 : geom1);
+		if (!lwgeom) {
+			throw ConversionException("Failure in geometry get dwithin: could not getting dwithin from geoms");
 		}
-		if (gser2) {
-			Geometry::DestroyGeometry(gser2);
+		auto dWithinRv = Geometry::GeometryDWithin(tree, argnum, lwgeom, distance, use_spheroid);
+		Geometry::DestroyLWGeometry(lwgeom);
+		return dWithinRv;
+	}
+	auto lwgeom1 = Geometry::GetLWGeometry(geom1);
+	auto lwgeom2 = Geometry::GetLWGeometry(geom2);
+	if (!lwgeom1 || !lwgeom2) {
+		if (lwgeom1) {
+			Geometry::DestroyLWGeometry(lwgeom1);
+		}
+		if (lwgeom2) {
+			Geometry::DestroyLWGeometry(lwgeom2);
 		}
 		throw ConversionException("Failure in geometry get dwithin: could not getting dwithin from geoms");
 		return false;
 	}
-	auto dWithinRv = Geometry::GeometryDWithin(gser1, gser2, distance, use_spheroid);
-	Geometry::DestroyGeometry(gser1);
-	Geometry::DestroyGeometry(gser2);
+	auto dWithinRv = Geometry::GeometryDWithin(lwgeom1, lwgeom2, distance, use_spheroid);
+	Geometry::DestroyLWGeometry(lwgeom1);
+	Geometry::DestroyLWGeometry(lwgeom2);
 	return dWithinRv;
 }
 
 void GeoFunctions::GeometryDWithinFunction(DataChunk &args, ExpressionState &state, Vector &result) {
-	auto &geom1_arg = args.data[0];
-	auto &geom2_arg = args.data[1];
-	auto &distance_arg = args.data[2];
 	if (args.data.size() == 3) {
-		GeometryDWithinTernaryExecutor<string_t, string_t, double, bool>(geom1_arg, geom2_arg, distance_arg, result,
-		                                                                 args.size());
+		GeometryDWithinTernaryExecutor<string_t, string_t, double, bool>(args, result, state);
 	} else {
-		auto &use_spheroid_arg = args.data[3];
-		GenericExecutor::ExecuteQuaternary<PrimitiveType<string_t>, PrimitiveType<string_t>, PrimitiveType<double>,
-		                                   PrimitiveType<bool>, PrimitiveType<bool>>(
-		    geom1_arg, geom2_arg, distance_arg, use_spheroid_arg, result, args.size(),
-		    [&](PrimitiveType<string_t> geom1, PrimitiveType<string_t> geom2, PrimitiveType<double> distance,
-		        PrimitiveType<bool> use_spheroid) {
-			    return DWithinQuaternaryScalarFunction(geom1.val, geom2.val, distance.val, use_spheroid.val);
-		    });
+		CircTreeLookup trees(state);
+		GeographyPointPairExecutor<bool>(args, 2, 3, result,
+		                                 [&](string_t geom1, string_t geom2, double distance, bool use_spheroid) {
+			                                 return DWithinQuaternaryScalarFunction(geom1, geom2, distance,
+			                                                                        use_spheroid, trees);
+		                                 });
+	}
+}
+
+//! ST_DWITHIN_CELL(point, distance): the cell of point in a lat/lon grid sized from distance. Together with
+//! ST_DWITHIN_CELLS it turns a distance join into an equi-join on cells that DuckDB hashes and runs in parallel:
+//!   SELECT ... FROM a JOIN (SELECT *, UNNEST(ST_DWITHIN_CELLS(g, 500)) AS cell FROM b) b
+//!     ON ST_DWITHIN_CELL(a.g, 500) = b.cell AND ST_DWITHIN(a.g, b.g, 500)
+//! Every pair within the distance shares exactly one cell, so it comes out once.
+void GeoFunctions::GeometryDWithinCellFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	BinaryExecutor::ExecuteWithNulls<string_t, double, uint64_t>(
+	    args.data[0], args.data[1], result, args.size(),
+	    [&](string_t geom, double distance, ValidityMask &mask, idx_t idx) {
+		    if (distance < 0) {
+			    throw ConversionException("Failure in geography dwithin cell: distance must not be negative");
+		    }
+		    uint64_t cell = 0;
+		    if (Geometry::GeometryDWithinCell(geom, distance, cell)) {
+			    return cell;
+		    }
+		    if (geom.GetSize() == 0 || Geometry::IsEmpty(geom)) {
+			    mask.SetInvalid(idx);
+			    return cell;
+		    }
+		    throw ConversionException("Failure in geography dwithin cell: only points lie in a single cell");
+	    });
+}
+
+//! ST_DWITHIN_CELLS(geog, distance): the cells of the ST_DWITHIN_CELL grid that hold every point within distance of
+//! geog, which may be any geography
+void GeoFunctions::GeometryDWithinCellsFunction(DataChunk &args, ExpressionState &state, Vector &result) {
+	auto &geom_arg = args.data[0];
+	auto &distance_arg = args.data[1];
+	auto count = args.size();
+
+	UnifiedVectorFormat geom_data, distance_data;
+	geom_arg.ToUnifiedFormat(count, geom_data);
+	distance_arg.ToUnifiedFormat(count, distance_data);
+	auto geoms = (string_t *)geom_data.data;
+	auto distances = (double *)distance_data.data;
+
+	result.SetVectorType(VectorType::FLAT_VECTOR);
+	auto result_entries = FlatVector::GetData<list_entry_t>(result);
+	auto &result_mask = FlatVector::Validity(result);
+	vector<uint64_t> cells;
+	for (idx_t i = 0; i < count; i++) {
+		auto geom_idx = geom_data.sel->get_index(i);
+		auto distance_idx = distance_data.sel->get_index(i);
+		result_entries[i].offset = ListVector::GetListSize(result);
+		result_entries[i].length = 0;
+		if (!geom_data.validity.RowIsValid(geom_idx) || !distance_data.validity.RowIsValid(distance_idx)) {
+			result_mask.SetInvalid(i);
+			continue;
+		}
+		if (distances[distance_idx] < 0) {
+			throw ConversionException("Failure in geography dwithin cells: distance must not be negative");
+		}
+		if (geoms[geom_idx].GetSize() == 0) {
+			continue;
+		}
+		Geometry::GeometryDWithinCells(geoms[geom_idx], distances[distance_idx], cells);
+
+		auto offset = result_entries[i].offset;
+		ListVector::Reserve(result, offset + cells.size());
+		auto cell_data = FlatVector::GetData<uint64_t>(ListVector::GetEntry(result));
+		for (idx_t j = 0; j < cells.size(); j++) {
+			cell_data[offset + j] = cells[j];
+		}
+		result_entries[i].length = cells.size();
+		ListVector::SetListSize(result, offset + cells.size());
+	}
+	if (args.AllConstant()) {
+		result.SetVectorType(VectorType::CONSTANT_VECTOR);
 	}
 }
 
@@ -2341,12 +2943,12 @@ struct AreaOperator {
 		if (geom.GetSize() == 0) {
 			return 0;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			return 0;
 		}
-		auto area = Geometry::GeometryArea(gser, false);
-		Geometry::DestroyGeometry(gser);
+		auto area = Geometry::GeometryArea(lwgeom, false);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return area;
 	}
 };
@@ -2357,13 +2959,13 @@ struct AreaBinaryOperator {
 		if (geom.GetSize() == 0) {
 			return 0;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry get area: could not getting area from geom");
 			return false;
 		}
-		auto area = Geometry::GeometryArea(gser, use_spheroid);
-		Geometry::DestroyGeometry(gser);
+		auto area = Geometry::GeometryArea(lwgeom, use_spheroid);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return area;
 	}
 };
@@ -2525,13 +3127,13 @@ struct PerimeterUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return 0.0;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry get perimeter: could not getting perimeter from geom");
 			return 0.0;
 		}
-		auto perimeter = Geometry::GeometryPerimeter(gser, false);
-		Geometry::DestroyGeometry(gser);
+		auto perimeter = Geometry::GeometryPerimeter(lwgeom, false);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return perimeter;
 	}
 };
@@ -2542,13 +3144,13 @@ struct PerimeterBinaryOperator {
 		if (geom.GetSize() == 0) {
 			return 0;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry get perimeter: could not getting perimeter from geom");
 			return 0;
 		}
-		auto perimeter = Geometry::GeometryPerimeter(gser, use_spheroid);
-		Geometry::DestroyGeometry(gser);
+		auto perimeter = Geometry::GeometryPerimeter(lwgeom, use_spheroid);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return perimeter;
 	}
 };
@@ -2581,25 +3183,25 @@ static TR AzimuthScalarFunction(Vector &result, TA geom1, TB geom2, ValidityMask
 	if (geom1.GetSize() == 0 || geom2.GetSize() == 0) {
 		return 0.0;
 	}
-	auto gser1 = Geometry::GetGserialized(geom1);
-	auto gser2 = Geometry::GetGserialized(geom2);
-	if (!gser1 || !gser2) {
-		if (gser1) {
-			Geometry::DestroyGeometry(gser1);
+	auto lwgeom1 = Geometry::GetLWGeometry(geom1);
+	auto lwgeom2 = Geometry::GetLWGeometry(geom2);
+	if (!lwgeom1 || !lwgeom2) {
+		if (lwgeom1) {
+			Geometry::DestroyLWGeometry(lwgeom1);
 		}
-		if (gser2) {
-			Geometry::DestroyGeometry(gser2);
+		if (lwgeom2) {
+			Geometry::DestroyLWGeometry(lwgeom2);
 		}
 		throw ConversionException("Failure in geometry get azimuth: could not getting azimuth from geom");
 		return 0.0;
 	}
-	auto azimuthRv = Geometry::GeometryAzimuth(gser1, gser2);
+	auto azimuthRv = Geometry::GeometryAzimuth(lwgeom1, lwgeom2);
 	if (isnan(azimuthRv)) {
 		mask.SetInvalid(idx);
 		return 0.0;
 	}
-	Geometry::DestroyGeometry(gser1);
-	Geometry::DestroyGeometry(gser2);
+	Geometry::DestroyLWGeometry(lwgeom1);
+	Geometry::DestroyLWGeometry(lwgeom2);
 	return azimuthRv;
 };
 
@@ -2623,12 +3225,12 @@ struct LengthUnaryOperator {
 		if (geom.GetSize() == 0) {
 			return 0.0;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			return 0.0;
 		}
-		auto length = Geometry::GeometryLength(gser, false);
-		Geometry::DestroyGeometry(gser);
+		auto length = Geometry::GeometryLength(lwgeom, false);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return length;
 	}
 };
@@ -2639,13 +3241,13 @@ struct LengthBinaryOperator {
 		if (geom.GetSize() == 0) {
 			return 0;
 		}
-		auto gser = Geometry::GetGserialized(geom);
-		if (!gser) {
+		auto lwgeom = Geometry::GetLWGeometry(geom);
+		if (!lwgeom) {
 			throw ConversionException("Failure in geometry get length: could not getting length from geom");
 			return false;
 		}
-		auto length = Geometry::GeometryLength(gser, use_spheroid);
-		Geometry::DestroyGeometry(gser);
+		auto length = Geometry::GeometryLength(lwgeom, use_spheroid);
+		Geometry::DestroyLWGeometry(lwgeom);
 		return length;
 	}
 };
@@ -2691,11 +3293,7 @@ struct BoundingBoxUnaryOperator {
 			Geometry::DestroyGeometry(gser);
 			return geom;
 		}
-		idx_t rv_size = Geometry::GetGeometrySize(gserBoundingBox);
-		auto base = Geometry::GetBase(gserBoundingBox);
-		auto result_str = StringVector::EmptyString(result, rv_size);
-		memcpy(result_str.GetDataWriteable(), base, rv_size);
-		result_str.Finalize();
+		auto result_str = Geometry::SerializeToVector(gserBoundingBox, result);
 		Geometry::DestroyGeometry(gser);
 		Geometry::DestroyGeometry(gserBoundingBox);
 		return result_str;
@@ -2714,39 +3312,55 @@ void GeoFunctions::GeometryBoundingBoxFunction(DataChunk &args, ExpressionState
 
 struct GeometryMaxDistanceBinaryOperator {
 	template <class TA, class TB, class TR>
-	static inline TR Operation(TA geom1, TB geom2) {
+	static inline TR Operation(TA geom1, TB geom2, CircTreeLookup &trees) {
 		double dis = 0.00;
 		if (geom1.GetSize() == 0 || geom2.GetSize() == 0) {
 			return dis;
 		}
-		auto gser1 = Geometry::GetGserialized(geom1);
-		auto gser2 = Geometry::GetGserialized(geom2);
-		if (!gser1 || !gser2) {
-			if (gser1) {
-				Geometry::DestroyGeometry(gser1);
+		int argnum;
+		auto tree = trees.Get(geom1, geom2, argnum);
+		if (tree) {
+			auto lwgeom = Geometry::GetLWGeometry(argnum == 1 ? geom2 : geom1);
+			if (!lwgeom) {
+				throw ConversionException(
+				    "Failure in geometry get max distance: could not getting max distance from geom");
 			}
-			if (gser2) {
-				Geometry::DestroyGeometry(gser2);
+			dis = Geometry::MaxDistance(tree, argnum, lwgeom);
+			Geometry::DestroyLWGeometry(lwgeom);
+			return dis;
+		}
+		auto lwgeom1 = Geometry::GetLWGeometry(geom1);
+		auto lwgeom2 = Geometry::GetLWGeometry(geom2);
+		if (!lwgeom1 || !lwgeom2) {
+			if (lwgeom1) {
+				Geometry::DestroyLWGeometry(lwgeom1);
+			}
+			if (lwgeom2) {
+				Geometry::DestroyLWGeometry(lwgeom2);
 			}
 			throw ConversionException("Failure in geometry get max distance: could not getting max distance from geom");
 			return dis;
 		}
-		dis = Geometry::MaxDistance(gser1, gser2);
-		Geometry::DestroyGeometry(gser1);
-		Geometry::DestroyGeometry(gser2);
+		dis = Geometry::MaxDistance(lwgeom1, lwgeom2);
+		Geometry::DestroyLWGeometry(lwgeom1);
+		Geometry::DestroyLWGeometry(lwgeom2);
 		return dis;
 	}
 };
 
 template <typename TA, typename TB, typename TR>
-static void GeometryMaxDistanceBinaryExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count) {
-	BinaryExecutor::ExecuteStandard<TA, TB, TR, GeometryMaxDistanceBinaryOperator>(geom1, geom2, result, count);
+static void GeometryMaxDistanceBinaryExecutor(Vector &geom1, Vector &geom2, Vector &result, idx_t count,
+                                              ExpressionState &state) {
+	CircTreeLookup trees(state);
+	BinaryExecutor::Execute<TA, TB, TR>(geom1, geom2, result, count, [&](TA left, TB right) {
+		return GeometryMaxDistanceBinaryOperator::Operation<TA, TB, TR>(left, right, trees);
+	});
 }
 
 void GeoFunctions::GeometryMaxDistanceFunction(DataChunk &args, ExpressionState &state, Vector &result) {
 	auto &geom1_arg = args.data[0];
 	auto &geom2_arg = args.data[1];
-	GeometryMaxDistanceBinaryExecutor<string_t, string_t, double>(geom1_arg, geom2_arg, result, args.size());
+	GeometryMaxDistanceBinaryExecutor<string_t, string_t, double>(geom1_arg, geom2_arg, result, args.size(), state);
 }
 
 void GeoFunctions::GeometryExtentFunction(DataChunk &args, ExpressionState &state, Vector &result) {
@@ -2807,13 +3421,12 @@ void GeoFunctions::GeometryExtentFunction(DataChunk &args, ExpressionState &stat
 			result_entries[i] = string_t();
 			continue;
 		}
-		idx_t rv_size = Geometry::GetGeometrySize(gserExtent);
-		auto base = Geometry::GetBase(gserExtent);
+		auto result_str = Geometry::SerializeToVector(gserExtent, result);
 		for (idx_t child_idx = 0; child_idx < list_entry.length; child_idx++) {
 			Geometry::DestroyGeometry(gserArray[child_idx]);
 		}
 		Geometry::DestroyGeometry(gserExtent);
-		result_entries[i] = string_t((const char *)base, rv_size);
+		result_entries[i] = result_str;
 	}
 }
 
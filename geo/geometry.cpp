@@ -19,9 +19,9 @@ string Geometry::GetString(string_t geometry, DataFormatType ftype) {
 		break;
 
 	case DataFormatType::FORMAT_VALUE_TYPE_WKT: {
-		auto gser = Geometry::GetGserialized(geometry);
-		text = postgis.LWGEOM_asText(gser);
-		Geometry::DestroyGeometry(gser);
+		auto lwgeom = Geometry::GetLWGeometry(geometry);
+		text = postgis.LWGEOM_asText(lwgeom);
+		Geometry::DestroyLWGeometry(lwgeom);
 	} break;
 
 	case DataFormatType::FORMAT_VALUE_TYPE_GEOJSON:
@@ -50,16 +50,19 @@ string Geometry::ToString(string_t geometry, DataFormatType ftype) {
 
 void Geometry::ToGeometry(GSERIALIZED *gser, data_ptr_t output) {
 	Postgis postgis;
-	data_ptr_t base = (data_ptr_t)postgis.LWGEOM_base(gser);
-	auto geometry_len = Geometry::GetGeometrySize(gser);
-	memcpy(output, base, geometry_len);
+	auto lwgeom = postgis.LWGEOM_getLWGeom(gser);
+	postgis.LWGEOM_write(lwgeom, (char *)output);
+	postgis.LWGEOM_free(lwgeom);
 }
 
 string Geometry::ToGeometry(GSERIALIZED *gser) {
-	auto geometry_len = Geometry::GetGeometrySize(gser);
-	auto buffer = std::unique_ptr<char[]>(new char[geometry_len]);
-	Geometry::ToGeometry(gser, (data_ptr_t)buffer.get());
-	return string(buffer.get(), geometry_len);
+	Postgis postgis;
+	auto lwgeom = postgis.LWGEOM_getLWGeom(gser);
+	auto geometry_len = postgis.LWGEOM_size(lwgeom);
+	string str(geometry_len, '\0');
+	postgis.LWGEOM_write(lwgeom, &str[0]);
+	postgis.LWGEOM_free(lwgeom);
+	return str;
 }
 
 string Geometry::ToGeometry(string_t text) {
@@ -76,6 +79,32 @@ GSERIALIZED *Geometry::GetGserialized(string_t geom) {
 	return postgis.LWGEOM_getGserialized(data, size);
 }
 
+LWGEOM *Geometry::GetLWGeometry(string_t geom) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	return postgis.LWGEOM_getLWGeom(data, size);
+}
+
+LWGEOM *Geometry::GetLWGeometry(GSERIALIZED *gser) {
+	Postgis postgis;
+	return postgis.LWGEOM_getLWGeom(gser);
+}
+
+bool Geometry::GetGBox(string_t geom, int32_t &srid, GBOX &gbox) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	return postgis.LWGEOM_getGBox(data, size, &srid, &gbox);
+}
+
+bool Geometry::GetPoint(string_t geom, int32_t &srid, POINT2D &point) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	return postgis.LWGEOM_getPoint(data, size, &srid, &point);
+}
+
 GSERIALIZED *Geometry::ToGserialized(string_t str) {
 	Postgis postgis;
 	auto ger = postgis.geography_in(&str.GetString()[0]);
@@ -93,10 +122,29 @@ void Geometry::DestroyGeometry(GSERIALIZED *gser) {
 	postgis.LWGEOM_free(gser);
 }
 
-data_ptr_t Geometry::GetBase(GSERIALIZED *gser) {
+void Geometry::DestroyLWGeometry(LWGEOM *lwgeom) {
+	Postgis postgis;
+	postgis.LWGEOM_free(lwgeom);
+}
+
+string_t Geometry::SerializeToVector(GSERIALIZED *gser, Vector &result) {
+	Postgis postgis;
+	auto lwgeom = postgis.LWGEOM_getLWGeom(gser);
+	auto result_str = Geometry::SerializeToVector(lwgeom, result);
+	postgis.LWGEOM_free(lwgeom);
+	return result_str;
+}
+
+string_t Geometry::SerializeToVector(LWGEOM *lwgeom, Vector &result) {
 	Postgis postgis;
-	data_ptr_t base = (data_ptr_t)postgis.LWGEOM_base(gser);
-	return base;
+	auto size = postgis.LWGEOM_size(lwgeom);
+	auto result_str = StringVector::EmptyString(result, size);
+	auto written = postgis.LWGEOM_write(lwgeom, result_str.GetDataWriteable());
+	if (written != size) {
+		throw ConversionException("Failure in geometry serialize: output size does not match the computed size");
+	}
+	result_str.Finalize();
+	return result_str;
 }
 
 GSERIALIZED *Geometry::MakePoint(double x, double y) {
@@ -129,21 +177,41 @@ lwvarlena_t *Geometry::AsBinary(GSERIALIZED *geom, string text) {
 	return postgis.LWGEOM_asBinary(geom, text);
 }
 
+lwvarlena_t *Geometry::AsBinary(LWGEOM *lwgeom, string text) {
+	Postgis postgis;
+	return postgis.LWGEOM_asBinary(lwgeom, text);
+}
+
 std::string Geometry::AsText(GSERIALIZED *geom, int max_digits) {
 	Postgis postgis;
 	return postgis.LWGEOM_asText(geom, max_digits);
 }
 
+std::string Geometry::AsText(LWGEOM *lwgeom, int max_digits) {
+	Postgis postgis;
+	return postgis.LWGEOM_asText(lwgeom, max_digits);
+}
+
 lwvarlena_t *Geometry::AsGeoJson(GSERIALIZED *geom, size_t m_dec_digits) {
 	Postgis postgis;
 	return postgis.LWGEOM_asGeoJson(geom, m_dec_digits);
 }
 
+lwvarlena_t *Geometry::AsGeoJson(LWGEOM *lwgeom, size_t m_dec_digits) {
+	Postgis postgis;
+	return postgis.LWGEOM_asGeoJson(lwgeom, m_dec_digits);
+}
+
 lwvarlena_t *Geometry::GeoHash(GSERIALIZED *geom, size_t m_chars) {
 	Postgis postgis;
 	return postgis.ST_GeoHash(geom, m_chars);
 }
 
+lwvarlena_t *Geometry::GeoHash(LWGEOM *lwgeom, size_t m_chars) {
+	Postgis postgis;
+	return postgis.ST_GeoHash(lwgeom, m_chars);
+}
+
 GSERIALIZED *Geometry::GeomFromGeoJson(string_t json) {
 	Postgis postgis;
 	auto ger = postgis.geom_from_geojson(&json.GetString()[0]);
@@ -190,6 +258,33 @@ GSERIALIZED *Geometry::GeometryUnionGArray(GSERIALIZED *gserArray[], int nelems)
 	return postgis.pgis_union_geometry_array(gserArray, nelems);
 }
 
+UnionAggState *Geometry::CreateUnionAggState() {
+	Postgis postgis;
+	return postgis.union_agg_state_create();
+}
+
+void Geometry::UnionAggStateAdd(UnionAggState *state, string_t geom) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	postgis.union_agg_state_add(state, data, size);
+}
+
+void Geometry::UnionAggStateCombine(UnionAggState *target, const UnionAggState *source) {
+	Postgis postgis;
+	postgis.union_agg_state_combine(target, source);
+}
+
+GSERIALIZED *Geometry::UnionAggStateFinalize(UnionAggState *state) {
+	Postgis postgis;
+	return postgis.union_agg_state_finalize(state);
+}
+
+void Geometry::DestroyUnionAggState(UnionAggState *state) {
+	Postgis postgis;
+	postgis.union_agg_state_free(state);
+}
+
 GSERIALIZED *Geometry::GeometryIntersection(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	Postgis postgis;
 	return postgis.ST_Intersection(geom1, geom2);
@@ -225,6 +320,49 @@ bool Geometry::GeometryContains(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return postgis.contains(geom1, geom2);
 }
 
+PrepGeomCache *Geometry::GetPreparedGeometry(string_t geom) {
+	GeometryPersistentScope persistent;
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	return postgis.GetPrepGeomCache(data, size);
+}
+
+void Geometry::DestroyPreparedGeometry(PrepGeomCache *prepared) {
+	Postgis postgis;
+	postgis.FreePrepGeomCache(prepared);
+}
+
+bool Geometry::GeometryContains(PrepGeomCache *prepared, int argnum, GSERIALIZED *geom) {
+	Postgis postgis;
+	return postgis.contains(prepared, argnum, geom);
+}
+
+bool Geometry::GeometryWithin(PrepGeomCache *prepared, int argnum, GSERIALIZED *geom) {
+	Postgis postgis;
+	return postgis.within(prepared, argnum, geom);
+}
+
+bool Geometry::GeometryIntersects(PrepGeomCache *prepared, int argnum, GSERIALIZED *geom) {
+	Postgis postgis;
+	return postgis.ST_Intersects(prepared, geom);
+}
+
+bool Geometry::CanLocatePoints(PrepGeomCache *prepared) {
+	Postgis postgis;
+	return postgis.pip_prepared_batchable(prepared);
+}
+
+void Geometry::LocatePoints(PrepGeomCache *prepared, const vector<double> &xs, const vector<double> &ys,
+                            vector<int> &locations) {
+	Postgis postgis;
+	locations.resize(xs.size());
+	if (xs.empty()) {
+		return;
+	}
+	postgis.pip_prepared_points(prepared, xs.data(), ys.data(), xs.size(), locations.data());
+}
+
 bool Geometry::GeometryTouches(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	Postgis postgis;
 	return postgis.touches(geom1, geom2);
@@ -260,6 +398,55 @@ bool Geometry::GeometryDWithin(GSERIALIZED *geom1, GSERIALIZED *geom2, double di
 	return postgis.geography_dwithin(geom1, geom2, distance, use_spheroid);
 }
 
+bool Geometry::GeometryDWithin(LWGEOM *lwgeom1, LWGEOM *lwgeom2, double distance, bool use_spheroid) {
+	Postgis postgis;
+	return postgis.geography_dwithin(lwgeom1, lwgeom2, distance, use_spheroid);
+}
+
+bool Geometry::GeometryDWithin(CircTreeGeomCache *tree, int argnum, LWGEOM *lwgeom, double distance,
+                               bool use_spheroid) {
+	Postgis postgis;
+	return postgis.geography_dwithin(tree, argnum, lwgeom, distance, use_spheroid);
+}
+
+void Geometry::GeometryDWithin(const POINT2D *points1, const POINT2D *points2, const double *distances, idx_t count,
+                               int32_t srid, bool use_spheroid, bool *results) {
+	Postgis postgis;
+	postgis.geography_dwithin_points(points1, points2, distances, count, srid, use_spheroid, results);
+}
+
+bool Geometry::GeometryDWithinCell(string_t geom, double distance, uint64_t &cell) {
+	Postgis postgis;
+	int32_t srid;
+	POINT2D point;
+	if (!postgis.LWGEOM_getPoint((const_data_ptr_t)geom.GetDataUnsafe(), geom.GetSize(), &srid, &point)) {
+		return false;
+	}
+	cell = postgis.geography_dwithin_cell(&point, srid, distance);
+	return true;
+}
+
+void Geometry::GeometryDWithinCells(string_t geom, double distance, vector<uint64_t> &cells) {
+	Postgis postgis;
+	int32_t srid;
+	POINT2D point;
+	cells.clear();
+	if (postgis.LWGEOM_getPoint((const_data_ptr_t)geom.GetDataUnsafe(), geom.GetSize(), &srid, &point)) {
+		postgis.geography_dwithin_cells(&point, srid, distance, cells);
+		return;
+	}
+	auto lwgeom = GetLWGeometry(geom);
+	if (!lwgeom) {
+		throw ConversionException("Failure in geography dwithin cells: could not decode geography");
+	}
+	auto covered = postgis.geography_dwithin_cells(lwgeom, distance, cells);
+	DestroyLWGeometry(lwgeom);
+	if (!covered) {
+		throw ConversionException("Failure in geography dwithin cells: the geography reaches too many cells at this "
+		                          "distance, join it with ST_DWITHIN instead");
+	}
+}
+
 double Geometry::GeometryArea(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.ST_Area(geom);
@@ -270,6 +457,11 @@ double Geometry::GeometryArea(GSERIALIZED *geom, bool use_spheroid) {
 	return postgis.geography_area(geom, use_spheroid);
 }
 
+double Geometry::GeometryArea(LWGEOM *lwgeom, bool use_spheroid) {
+	Postgis postgis;
+	return postgis.geography_area(lwgeom, use_spheroid);
+}
+
 double Geometry::GeometryAngle(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	Postgis postgis;
 	return postgis.LWGEOM_angle(geom1, geom2);
@@ -290,6 +482,11 @@ double Geometry::GeometryPerimeter(GSERIALIZED *geom, bool use_spheroid) {
 	return postgis.geography_perimeter(geom, use_spheroid);
 }
 
+double Geometry::GeometryPerimeter(LWGEOM *lwgeom, bool use_spheroid) {
+	Postgis postgis;
+	return postgis.geography_perimeter(lwgeom, use_spheroid);
+}
+
 double Geometry::GeometryAzimuth(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	Postgis postgis;
 	// For geometry
@@ -298,6 +495,11 @@ double Geometry::GeometryAzimuth(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return postgis.geography_azimuth(geom1, geom2);
 }
 
+double Geometry::GeometryAzimuth(LWGEOM *lwgeom1, LWGEOM *lwgeom2) {
+	Postgis postgis;
+	return postgis.geography_azimuth(lwgeom1, lwgeom2);
+}
+
 double Geometry::GeometryLength(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_length2d_linestring(geom);
@@ -308,6 +510,11 @@ double Geometry::GeometryLength(GSERIALIZED *geom, bool use_spheroid) {
 	return postgis.geography_length(geom, use_spheroid);
 }
 
+double Geometry::GeometryLength(LWGEOM *lwgeom, bool use_spheroid) {
+	Postgis postgis;
+	return postgis.geography_length(lwgeom, use_spheroid);
+}
+
 GSERIALIZED *Geometry::GeometryBoundingBox(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_envelope(geom);
@@ -321,15 +528,121 @@ double Geometry::MaxDistance(GSERIALIZED *g1, GSERIALIZED *g2, bool use_spheroid
 	return postgis.geography_maxdistance(g1, g2, use_spheroid);
 }
 
+double Geometry::MaxDistance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid) {
+	Postgis postgis;
+	return postgis.geography_maxdistance(lwgeom1, lwgeom2, use_spheroid);
+}
+
+double Geometry::MaxDistance(CircTreeGeomCache *tree, int argnum, LWGEOM *lwgeom, bool use_spheroid) {
+	Postgis postgis;
+	return postgis.geography_maxdistance(tree, argnum, lwgeom, use_spheroid);
+}
+
+CircTreeGeomCache *Geometry::GetCircTree(string_t geom) {
+	GeometryPersistentScope persistent;
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	return postgis.GetCircTreeGeomCache(data, size);
+}
+
+void Geometry::DestroyCircTree(CircTreeGeomCache *tree) {
+	Postgis postgis;
+	postgis.FreeCircTreeGeomCache(tree);
+}
+
+CircTreeKnnIndex *Geometry::GetKnnIndex(const vector<string_t> &geoms, const vector<bool> &valid) {
+	GeometryPersistentScope persistent;
+	Postgis postgis;
+	vector<const void *> bases(geoms.size());
+	vector<size_t> sizes(geoms.size());
+	for (idx_t i = 0; i < geoms.size(); i++) {
+		bases[i] = valid[i] ? geoms[i].GetDataUnsafe() : nullptr;
+		sizes[i] = geoms[i].GetSize();
+	}
+	return postgis.GetCircTreeKnnIndex(bases.data(), sizes.data(), geoms.size());
+}
+
+void Geometry::DestroyKnnIndex(CircTreeKnnIndex *index) {
+	Postgis postgis;
+	postgis.FreeCircTreeKnnIndex(index);
+}
+
+void Geometry::KNearest(const CircTreeKnnIndex *index, LWGEOM *lwgeom, idx_t k, bool use_spheroid,
+                        vector<uint32_t> &results) {
+	Postgis postgis;
+	results.resize(k);
+	auto count = postgis.geography_knn(index, lwgeom, k, use_spheroid, results.data());
+	results.resize(count);
+}
+
 GSERIALIZED *Geometry::GeometryExtent(GSERIALIZED *gserArray[], int nelems) {
 	Postgis postgis;
 	return postgis.LWGEOM_envelope_garray(gserArray, nelems);
 }
 
-std::vector<int> Geometry::GeometryClusterDBScan(GSERIALIZED *gserArray[], int nelems, double tolerance,
-                                                 int minpoints) {
+bool Geometry::GetExtent(string_t geom, int32_t &srid, GBOX &gbox) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	return postgis.LWGEOM_extent_gbox(data, size, &srid, &gbox);
+}
+
+GSERIALIZED *Geometry::GeometryEnvelope(const GBOX *box, int32_t srid) {
+	Postgis postgis;
+	return postgis.LWGEOM_envelope_gbox(box, srid);
+}
+
+bool Geometry::GeometryHilbert(string_t geom, const GBOX &extent, uint64_t &key) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	return postgis.LWGEOM_hilbert(data, size, &extent, &key);
+}
+
+bool Geometry::GeometryZOrder(string_t geom, const GBOX &extent, uint64_t &key) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	return postgis.LWGEOM_zorder(data, size, &extent, &key);
+}
+
+std::vector<int> Geometry::GeometryClusterDBScan(GSERIALIZED *gserArray[], int nelems, double tolerance, int minpoints,
+                                                 int nthreads) {
 	Postgis postgis;
-	return postgis.ST_ClusterDBSCAN(gserArray, nelems, tolerance, minpoints);
+	return postgis.ST_ClusterDBSCAN(gserArray, nelems, tolerance, minpoints, nthreads);
+}
+
+std::vector<int> Geometry::GeometryClusterDBScan(LWGEOM *geoms[], int nelems, double tolerance, int minpoints,
+                                                 int nthreads) {
+	Postgis postgis;
+	return postgis.ST_ClusterDBSCAN(geoms, nelems, tolerance, minpoints, nthreads);
+}
+
+std::vector<GSERIALIZED *> Geometry::GeometryClusterWithin(GSERIALIZED *gserArray[], int nelems, double tolerance,
+                                                           int nthreads) {
+	Postgis postgis;
+	return postgis.ST_ClusterWithin(gserArray, nelems, tolerance, nthreads);
+}
+
+bool Geometry::GetClusterCentre(string_t geom, POINT2D &centre) {
+	Postgis postgis;
+	int32_t srid;
+	if (GetPoint(geom, srid, centre)) {
+		return true;
+	}
+	auto gser = GetGserialized(geom);
+	if (!gser) {
+		return false;
+	}
+	auto has_centre = postgis.ST_ClusterKMeansCentre(gser, &centre);
+	DestroyGeometry(gser);
+	return has_centre;
+}
+
+std::vector<int> Geometry::GeometryClusterKMeans(const POINT2D *centres, int ncentres, int k, double max_radius) {
+	Postgis postgis;
+	return postgis.ST_ClusterKMeans(centres, ncentres, k, max_radius);
 }
 
 int Geometry::LWGEOM_dimension(GSERIALIZED *geom) {
@@ -337,11 +650,34 @@ int Geometry::LWGEOM_dimension(GSERIALIZED *geom) {
 	return postgis.LWGEOM_dimension(geom);
 }
 
+int Geometry::LWGEOM_dimension(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.LWGEOM_dimension(lwgeom);
+}
+
 std::vector<GSERIALIZED *> Geometry::LWGEOM_dump(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_dump(geom);
 }
 
+bool Geometry::GetDumpComponents(string_t geom, int32_t &srid, std::vector<WKB_COMPONENT> &components) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	return postgis.LWGEOM_dump_components(data, size, &srid, components);
+}
+
+idx_t Geometry::DumpComponentSize(const WKB_COMPONENT &component, int32_t srid) {
+	Postgis postgis;
+	return postgis.LWGEOM_dump_component_size(component, srid);
+}
+
+void Geometry::WriteDumpComponent(string_t geom, const WKB_COMPONENT &component, int32_t srid, char *buffer) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	postgis.LWGEOM_dump_component_write(data, component, srid, buffer);
+}
+
 GSERIALIZED *Geometry::LWGEOM_endpoint_linestring(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_endpoint_linestring(geom);
@@ -352,21 +688,51 @@ std::string Geometry::Geometrytype(GSERIALIZED *geom) {
 	return postgis.geometry_geometrytype(geom);
 }
 
+std::string Geometry::Geometrytype(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.geometry_geometrytype(lwgeom);
+}
+
+std::string Geometry::Geometrytype(string_t geom) {
+	Postgis postgis;
+	return postgis.geometry_geometrytype(geom.GetDataUnsafe(), geom.GetSize());
+}
+
 bool Geometry::IsClosed(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_isclosed(geom);
 }
 
+bool Geometry::IsClosed(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.LWGEOM_isclosed(lwgeom);
+}
+
 bool Geometry::IsCollection(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.ST_IsCollection(geom);
 }
 
+bool Geometry::IsCollection(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.ST_IsCollection(lwgeom);
+}
+
 bool Geometry::IsEmpty(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_isempty(geom);
 }
 
+bool Geometry::IsEmpty(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.LWGEOM_isempty(lwgeom);
+}
+
+bool Geometry::IsEmpty(string_t geom) {
+	Postgis postgis;
+	return postgis.LWGEOM_isempty(geom.GetDataUnsafe(), geom.GetSize());
+}
+
 bool Geometry::IsRing(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_isring(geom);
@@ -377,16 +743,36 @@ int Geometry::NPoints(GSERIALIZED *geom) {
 	return postgis.LWGEOM_npoints(geom);
 }
 
+int Geometry::NPoints(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.LWGEOM_npoints(lwgeom);
+}
+
 int Geometry::NumGeometries(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_numgeometries_collection(geom);
 }
 
+int Geometry::NumGeometries(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.LWGEOM_numgeometries_collection(lwgeom);
+}
+
+int Geometry::NumGeometries(string_t geom) {
+	Postgis postgis;
+	return postgis.LWGEOM_numgeometries_collection(geom.GetDataUnsafe(), geom.GetSize());
+}
+
 int Geometry::NumPoints(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_numpoints_linestring(geom);
 }
 
+int Geometry::NumPoints(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.LWGEOM_numpoints_linestring(lwgeom);
+}
+
 GSERIALIZED *Geometry::PointN(GSERIALIZED *geom, int index) {
 	Postgis postgis;
 	return postgis.LWGEOM_pointn_linestring(geom, index);
@@ -407,16 +793,52 @@ double Geometry::Distance(GSERIALIZED *g1, GSERIALIZED *g2, bool use_spheroid) {
 	return postgis.geography_distance(g1, g2, use_spheroid);
 }
 
+double Geometry::Distance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid) {
+	Postgis postgis;
+	return postgis.geography_distance(lwgeom1, lwgeom2, use_spheroid);
+}
+
+double Geometry::Distance(CircTreeGeomCache *tree, int argnum, LWGEOM *lwgeom, bool use_spheroid) {
+	Postgis postgis;
+	return postgis.geography_distance(tree, argnum, lwgeom, use_spheroid);
+}
+
+void Geometry::Distance(const POINT2D *points1, const POINT2D *points2, idx_t count, int32_t srid, bool use_spheroid,
+                        double *distances) {
+	Postgis postgis;
+	postgis.geography_distance_points(points1, points2, count, srid, use_spheroid, distances);
+}
+
 double Geometry::XPoint(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_x_point(geom);
 }
 
+double Geometry::XPoint(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.LWGEOM_x_point(lwgeom);
+}
+
+double Geometry::XPoint(string_t geom) {
+	Postgis postgis;
+	return postgis.LWGEOM_x_point(geom.GetDataUnsafe(), geom.GetSize());
+}
+
 double Geometry::YPoint(GSERIALIZED *geom) {
 	Postgis postgis;
 	return postgis.LWGEOM_y_point(geom);
 }
 
+double Geometry::YPoint(LWGEOM *lwgeom) {
+	Postgis postgis;
+	return postgis.LWGEOM_y_point(lwgeom);
+}
+
+double Geometry::YPoint(string_t geom) {
+	Postgis postgis;
+	return postgis.LWGEOM_y_point(geom.GetDataUnsafe(), geom.GetSize());
+}
+
 GSERIALIZED *Geometry::Centroid(GSERIALIZED *g) {
 	Postgis postgis;
 	return postgis.centroid(g);
@@ -432,4 +854,31 @@ GSERIALIZED *Geometry::Convexhull(GSERIALIZED *g) {
 	return postgis.convexhull(g);
 }
 
+ConvexHullAggState *Geometry::CreateConvexHullAggState() {
+	Postgis postgis;
+	return postgis.convexhull_agg_state_create();
+}
+
+void Geometry::ConvexHullAggStateAdd(ConvexHullAggState *state, string_t geom) {
+	Postgis postgis;
+	auto data = (const_data_ptr_t)geom.GetDataUnsafe();
+	auto size = geom.GetSize();
+	postgis.convexhull_agg_state_add(state, data, size);
+}
+
+void Geometry::ConvexHullAggStateCombine(ConvexHullAggState *target, const ConvexHullAggState *source) {
+	Postgis postgis;
+	postgis.convexhull_agg_state_combine(target, source);
+}
+
+GSERIALIZED *Geometry::ConvexHullAggStateFinalize(ConvexHullAggState *state) {
+	Postgis postgis;
+	return postgis.convexhull_agg_state_finalize(state);
+}
+
+void Geometry::DestroyConvexHullAggState(ConvexHullAggState *state) {
+	Postgis postgis;
+	postgis.convexhull_agg_state_free(state);
+}
+
 } // namespace duckdb
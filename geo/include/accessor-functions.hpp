@@ -93,6 +93,26 @@ static const std::vector<ScalarFunctionSet> GetAccessorScalarFunctions(LogicalTy
 	get_y.AddFunction(ScalarFunction({geo_type}, LogicalType::DOUBLE, GeoFunctions::GeometryGetYFunction));
 	func_set.push_back(get_y);
 
+	// ST_XMIN
+	ScalarFunctionSet xmin("st_xmin");
+	xmin.AddFunction(ScalarFunction({geo_type}, LogicalType::DOUBLE, GeoFunctions::GeometryXMinFunction));
+	func_set.push_back(xmin);
+
+	// ST_XMAX
+	ScalarFunctionSet xmax("st_xmax");
+	xmax.AddFunction(ScalarFunction({geo_type}, LogicalType::DOUBLE, GeoFunctions::GeometryXMaxFunction));
+	func_set.push_back(xmax);
+
+	// ST_YMIN
+	ScalarFunctionSet ymin("st_ymin");
+	ymin.AddFunction(ScalarFunction({geo_type}, LogicalType::DOUBLE, GeoFunctions::GeometryYMinFunction));
+	func_set.push_back(ymin);
+
+	// ST_YMAX
+	ScalarFunctionSet ymax("st_ymax");
+	ymax.AddFunction(ScalarFunction({geo_type}, LogicalType::DOUBLE, GeoFunctions::GeometryYMaxFunction));
+	func_set.push_back(ymax);
+
 	return func_set;
 }
 
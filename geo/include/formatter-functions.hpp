@@ -43,6 +43,20 @@ static const std::vector<ScalarFunctionSet> GetFormatterScalarFunctions(LogicalT
 	    ScalarFunction({geo_type, LogicalType::INTEGER}, LogicalType::VARCHAR, GeoFunctions::GeometryGeoHashFunction));
 	func_set.push_back(geohash);
 
+	// ST_HILBERT
+	ScalarFunctionSet hilbert("st_hilbert");
+	hilbert.AddFunction(ScalarFunction({geo_type}, LogicalType::UBIGINT, GeoFunctions::GeometryHilbertFunction));
+	hilbert.AddFunction(
+	    ScalarFunction({geo_type, geo_type}, LogicalType::UBIGINT, GeoFunctions::GeometryHilbertFunction));
+	func_set.push_back(hilbert);
+
+	// ST_ZORDER
+	ScalarFunctionSet zorder("st_zorder");
+	zorder.AddFunction(ScalarFunction({geo_type}, LogicalType::UBIGINT, GeoFunctions::GeometryZOrderFunction));
+	zorder.AddFunction(
+	    ScalarFunction({geo_type, geo_type}, LogicalType::UBIGINT, GeoFunctions::GeometryZOrderFunction));
+	func_set.push_back(zorder);
+
 	return func_set;
 }
 
@@ -25,6 +25,8 @@ struct GeoFunctions {
 	static void GeometryAsTextFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryAsGeojsonFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryGeoHashFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void GeometryHilbertFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void GeometryZOrderFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryGeogFromFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryGeomFromGeoJsonFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryFromTextFunction(DataChunk &args, ExpressionState &state, Vector &result);
@@ -48,6 +50,10 @@ struct GeoFunctions {
 	static void GeometryStartPointFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryGetXFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryGetYFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void GeometryXMinFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void GeometryXMaxFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void GeometryYMinFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void GeometryYMaxFunction(DataChunk &args, ExpressionState &state, Vector &result);
 
 	// **Transformations (10)**:
 	static void GeometryBoundaryFunction(DataChunk &args, ExpressionState &state, Vector &result);
@@ -73,9 +79,24 @@ struct GeoFunctions {
 	static void GeometryCoveredByFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryDisjointFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryDWithinFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void GeometryDWithinCellFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	static void GeometryDWithinCellsFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	//! Keeps the constant argument of a predicate decoded for as long as the expression lives
+	static unique_ptr<FunctionLocalState> InitPreparedGeometryState(ExpressionState &state,
+	                                                                const BoundFunctionExpression &expr,
+	                                                                FunctionData *bind_data);
 
 	// **Measures (9)**
 	static void GeometryDistanceFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	//! Keeps the circ tree of a repeated geography argument across rows
+	static unique_ptr<FunctionLocalState> InitCircTreeCacheState(ExpressionState &state,
+	                                                             const BoundFunctionExpression &expr,
+	                                                             FunctionData *bind_data);
+	static void GeometryKNNFunction(DataChunk &args, ExpressionState &state, Vector &result);
+	//! Keeps the knn index of a candidate list across rows
+	static unique_ptr<FunctionLocalState> InitKnnIndexState(ExpressionState &state,
+	                                                        const BoundFunctionExpression &expr,
+	                                                        FunctionData *bind_data);
 	static void GeometryAreaFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryAngleFunction(DataChunk &args, ExpressionState &state, Vector &result);
 	static void GeometryPerimeterFunction(DataChunk &args, ExpressionState &state, Vector &result);
@@ -8,6 +8,10 @@
 
 #pragma once
 
+#include "duckdb/optimizer/optimizer_extension.hpp"
+#include "duckdb/parallel/task_scheduler.hpp"
+#include "duckdb/planner/expression/bound_constant_expression.hpp"
+#include "duckdb/planner/expression/bound_window_expression.hpp"
 #include "geometry.hpp"
 
 namespace duckdb {
@@ -147,111 +151,170 @@ public:
 	}
 };
 
-struct ClusterDBScanState {
-	bool isset;
-	double epsilon;
-	int minpoints;
-	idx_t count;
+//! The rows of a window decoded once, as the window clusters one frame after another over the same input, and the
+//! labels of the last frame clustered
+struct ClusterDBScanWindowCache {
+	~ClusterDBScanWindowCache() {
+		Clear();
+	}
+
+	void Clear() {
+		for (idx_t i = 0; i < geoms.size(); i++) {
+			if (geoms[i]) {
+				Geometry::DestroyLWGeometry(geoms[i]);
+				Geometry::DestroyGeometry(gsers[i]);
+			}
+		}
+		gsers.clear();
+		geoms.clear();
+		decoded.clear();
+		has_clusters = false;
+	}
+
+	//! Row i decoded, nullptr when it is empty. Decoded rows are kept as long as the input stays the same.
+	LWGEOM *GetRow(const string_t *data, idx_t i) {
+		if (data != rows_data) {
+			Clear();
+			rows_data = data;
+		}
+		if (i >= decoded.size()) {
+			gsers.resize(i + 1, nullptr);
+			geoms.resize(i + 1, nullptr);
+			decoded.resize(i + 1, false);
+		}
+		if (!decoded[i]) {
+			decoded[i] = true;
+			GeometryPersistentScope persistent;
+			auto gser = Geometry::GetGserialized(data[i]);
+			if (gser && !Geometry::IsEmpty(gser)) {
+				gsers[i] = gser;
+				geoms[i] = Geometry::GetLWGeometry(gser);
+				// the clustering reads the box of every geometry, it has to live as long as the geometry does
+				lwgeom_add_bbox(geoms[i]);
+			} else if (gser) {
+				Geometry::DestroyGeometry(gser);
+			}
+		}
+		return geoms[i];
+	}
+
+	bool IsClustered(const string_t *data, const FrameBounds &frame, double epsilon, int minpoints) const {
+		return has_clusters && data == rows_data && frame.first == frame_first && frame.second == frame_second &&
+		       epsilon == this->epsilon && minpoints == this->minpoints;
+	}
+
+	template <class INCLUDED>
+	void Cluster(const string_t *data, const INCLUDED &include, const FrameBounds &frame, double epsilon,
+	             int minpoints, int nthreads) {
+		std::vector<LWGEOM *> frame_geoms;
+		std::vector<int> index(frame.second - frame.first, -1);
+		for (idx_t i = frame.first; i < frame.second; i++) {
+			if (!include(i)) {
+				continue;
+			}
+			auto lwgeom = GetRow(data, i);
+			if (lwgeom) {
+				index[i - frame.first] = frame_geoms.size();
+				frame_geoms.push_back(lwgeom);
+			}
+		}
+
+		std::vector<int> labels;
+		if (!frame_geoms.empty()) {
+			labels =
+			    Geometry::GeometryClusterDBScan(&frame_geoms[0], frame_geoms.size(), epsilon, minpoints, nthreads);
+		}
+		clusters.assign(index.size(), -1);
+		for (idx_t i = 0; i < index.size(); i++) {
+			if (index[i] != -1) {
+				clusters[i] = labels[index[i]];
+			}
+		}
+
+		has_clusters = true;
+		frame_first = frame.first;
+		frame_second = frame.second;
+		this->epsilon = epsilon;
+		this->minpoints = minpoints;
+	}
+
+	const string_t *rows_data = nullptr;
+	std::vector<GSERIALIZED *> gsers;
+	std::vector<LWGEOM *> geoms;
+	std::vector<bool> decoded;
+
+	bool has_clusters = false;
+	idx_t frame_first = 0;
+	idx_t frame_second = 0;
+	double epsilon = 0;
+	int minpoints = 0;
 	std::vector<int> clusters;
+};
+
+//! The threads of the database, which the neighbours of the rows are searched on
+struct ClusterDBScanBindData : public FunctionData {
+	explicit ClusterDBScanBindData(int nthreads_p) : nthreads(nthreads_p) {
+	}
 
-	void Initialize() {
-		this->isset = false;
-		this->epsilon = 0;
-		this->minpoints = 0;
-		this->count = 0;
-		this->clusters = {};
+	unique_ptr<FunctionData> Copy() const override {
+		return make_unique<ClusterDBScanBindData>(nthreads);
 	}
 
-	void Combine(const ClusterDBScanState &other) {
-		this->isset = other.isset || this->isset;
-		this->epsilon = other.epsilon;
-		this->minpoints = other.minpoints;
-		this->count = other.count;
-		this->clusters.insert(this->clusters.end(), other.clusters.begin(), other.clusters.end());
+	bool Equals(const FunctionData &other_p) const override {
+		auto &other = (const ClusterDBScanBindData &)other_p;
+		return nthreads == other.nthreads;
 	}
+
+	int nthreads;
+};
+
+struct ClusterDBScanState {
+	bool isset;
+	double epsilon;
+	int minpoints;
+	//! EWKB of the rows of the group, when used as a plain aggregate
+	std::vector<string> *rows;
+	ClusterDBScanWindowCache *window;
 };
 
+//! As a window function every row gets the label of its cluster within the frame, NULL for noise. As a plain
+//! aggregate the group is clustered once and the number of clusters is returned.
 struct ClusterDBScanOperation {
 	template <class STATE>
 	static void Initialize(STATE &state) {
-		state.Initialize();
+		state.isset = false;
+		state.epsilon = 0;
+		state.minpoints = 0;
+		state.rows = nullptr;
+		state.window = nullptr;
 	}
 
 	template <class STATE, class OP>
 	static void Combine(const STATE &source, STATE &target, AggregateInputData &aggr_input_data) {
-		target.Combine(source);
+		if (!source.isset) {
+			return;
+		}
+		if (!target.isset) {
+			target.isset = true;
+			target.epsilon = source.epsilon;
+			target.minpoints = source.minpoints;
+			target.rows = new std::vector<string>();
+		}
+		target.rows->insert(target.rows->end(), source.rows->begin(), source.rows->end());
 	}
 
 	template <class A_TYPE, class B_TYPE, class C_TYPE, class STATE, class OP>
 	static void Operation(STATE *state, AggregateInputData &, A_TYPE *x_data, B_TYPE *y_data, C_TYPE *z_data,
 	                      ValidityMask &amask, ValidityMask &bmask, ValidityMask &cmask, idx_t xidx, idx_t yidx,
 	                      idx_t zidx, idx_t count) {
-		ClusterDBScanIncluded include(amask, amask, bmask, cmask, 0);
-
-		double epsilon = y_data[xidx] / MS_PER_RADIAN;
-		int minpoints = z_data[xidx];
 		if (!state->isset) {
 			state->isset = true;
-			state->epsilon = epsilon;
-			state->minpoints = minpoints;
-			state->count = count;
-			size_t asize = amask.ValidityMaskSize();
-			std::vector<GSERIALIZED *> gserArray {};
-			std::vector<int> indexVec(asize, -1);
-			int idx = 0;
-
-			for (size_t i = 0; i < count; i++) {
-				if (include(i)) {
-					auto gser = Geometry::GetGserialized(x_data[i]);
-					if (!Geometry::IsEmpty(gser)) {
-						gserArray.push_back(gser);
-						indexVec[i] = idx++;
-					} else {
-						Geometry::DestroyGeometry(gser);
-					}
-				}
-			}
-
-			// Doing cluster db scan
-			auto clusters = Geometry::GeometryClusterDBScan(&gserArray[0], gserArray.size(), epsilon, minpoints);
-
-			state->clusters = {};
-
-			for (idx_t i = 0; i < asize; i++) {
-				if (indexVec[i] == -1) {
-					state->clusters.push_back(-1);
-				} else {
-					state->clusters.push_back(clusters[indexVec[i]]);
-				}
-			}
-
-			// Free memory
-			for (idx_t child_idx = 0; child_idx < gserArray.size(); child_idx++) {
-				Geometry::DestroyGeometry(gserArray[child_idx]);
-			}
-
-			// if (state->clusters[ridx - frame.first] == -1) {
-			// 	rmask.SetInvalid(ridx);
-			// } else {
-			// 	rdata[ridx] = state->clusters[ridx - frame.first];
-			// }
-		} else {
-			// if (state->clusters[ridx - frame.first] == -1) {
-			// 	rmask.SetInvalid(ridx);
-			// } else {
-			// 	rdata[ridx] = state->clusters[ridx - frame.first];
-			// }
+			state->epsilon = y_data[yidx] / MS_PER_RADIAN;
+			state->minpoints = z_data[zidx];
+			state->rows = new std::vector<string>();
 		}
-	}
-
-	template <class A_TYPE, class B_TYPE, class C_TYPE, class STATE, class OP>
-	static void ConstantOperation(STATE *state, AggregateInputData &, A_TYPE *x_data, B_TYPE *y_data, C_TYPE *z_data,
-	                              ValidityMask &mask, idx_t count) {
-		// state->isset = true;
-		// for (size_t i = 0; i < count; i++) {
-		// 	state->epsilon = y_data[i];
-		// 	state->minpoints = z_data[i];
-		// }
+		auto &geom = x_data[xidx];
+		state->rows->emplace_back(geom.GetDataUnsafe(), geom.GetSize());
 	}
 
 	static bool IgnoreNull() {
@@ -260,12 +323,39 @@ struct ClusterDBScanOperation {
 
 	template <class T, class STATE>
 	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
-		// if (state->clusters[idx] == -1) {
-		// 	mask.SetInvalid(idx);
-		// } else {
-		// 	// mask.SetValid(i);
-		// 	target[idx] = state->clusters[idx];
-		// }
+		if (!state.isset) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		std::vector<GSERIALIZED *> gserArray {};
+		for (auto &row : *state.rows) {
+			auto gser = Geometry::GetGserialized(string_t(row.data(), row.size()));
+			if (!gser) {
+				continue;
+			}
+			if (Geometry::IsEmpty(gser)) {
+				Geometry::DestroyGeometry(gser);
+				continue;
+			}
+			gserArray.push_back(gser);
+		}
+
+		std::vector<int> clusters;
+		if (!gserArray.empty()) {
+			auto &bind_data = (ClusterDBScanBindData &)*finalize_data.input.bind_data;
+			clusters = Geometry::GeometryClusterDBScan(&gserArray[0], gserArray.size(), state.epsilon,
+			                                           state.minpoints, bind_data.nthreads);
+		}
+		for (idx_t child_idx = 0; child_idx < gserArray.size(); child_idx++) {
+			Geometry::DestroyGeometry(gserArray[child_idx]);
+		}
+
+		// the labels are numbered from 0 without gaps, noise is -1
+		int nclusters = 0;
+		for (auto cluster : clusters) {
+			nclusters = MaxValue(nclusters, cluster + 1);
+		}
+		target = nclusters;
 	}
 
 	template <class STATE, class A_TYPE, class B_TYPE, class C_TYPE, class RESULT_TYPE>
@@ -279,62 +369,31 @@ struct ClusterDBScanOperation {
 		auto &rmask = FlatVector::Validity(result);
 		double epsilon = bdata[ridx] / MS_PER_RADIAN;
 		int minpoints = cdata[ridx];
-		if (!state->isset || frame.first != prev.first || frame.second != prev.second || state->epsilon != epsilon ||
-		    state->minpoints != minpoints) {
-			state->isset = true;
-			state->epsilon = epsilon;
-			state->minpoints = minpoints;
-			size_t asize = frame.second - frame.first;
-			std::vector<GSERIALIZED *> gserArray {};
-			std::vector<int> indexVec(asize, -1);
-			int idx = 0;
-
-			for (size_t i = frame.first; i < frame.second; i++) {
-				if (include(i)) {
-					auto gser = Geometry::GetGserialized(adata[i]);
-					if (!Geometry::IsEmpty(gser)) {
-						gserArray.push_back(gser);
-						indexVec[i - frame.first] = idx++;
-					} else {
-						Geometry::DestroyGeometry(gser);
-					}
-				}
-			}
-
-			// Doing cluster db scan
-			auto clusters = Geometry::GeometryClusterDBScan(&gserArray[0], gserArray.size(), epsilon, minpoints);
-
-			state->clusters = {};
-
-			for (idx_t i = 0; i < asize; i++) {
-				if (indexVec[i] == -1) {
-					state->clusters.push_back(-1);
-				} else {
-					state->clusters.push_back(clusters[indexVec[i]]);
-				}
-			}
-
-			// Free memory
-			for (idx_t child_idx = 0; child_idx < gserArray.size(); child_idx++) {
-				Geometry::DestroyGeometry(gserArray[child_idx]);
-			}
+		if (!state->window) {
+			state->window = new ClusterDBScanWindowCache();
+		}
+		auto &window = *state->window;
+		// every row of a frame shared with the row before, as with a frame over the whole partition, reads the labels
+		// of the one clustering
+		if (!window.IsClustered(adata, frame, epsilon, minpoints)) {
+			auto &bind_data = (ClusterDBScanBindData &)*aggr_input_data.bind_data;
+			window.Cluster(adata, include, frame, epsilon, minpoints, bind_data.nthreads);
+		}
 
-			if (state->clusters[ridx - frame.first] == -1) {
-				rmask.SetInvalid(ridx);
-			} else {
-				rdata[ridx] = state->clusters[ridx - frame.first];
-			}
+		// a frame such as ROWS BETWEEN 2 PRECEDING AND 1 PRECEDING leaves the row itself out, it has no label then
+		if (ridx < frame.first || ridx >= frame.second || window.clusters[ridx - frame.first] == -1) {
+			rmask.SetInvalid(ridx);
 		} else {
-			if (state->clusters[ridx - frame.first] == -1) {
-				rmask.SetInvalid(ridx);
-			} else {
-				rdata[ridx] = state->clusters[ridx - frame.first];
-			}
+			rdata[ridx] = window.clusters[ridx - frame.first];
 		}
 	}
 
 	template <class STATE>
 	static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+		delete state.rows;
+		state.rows = nullptr;
+		delete state.window;
+		state.window = nullptr;
 	}
 };
 
@@ -363,10 +422,8 @@ static void TernaryWindow(Vector inputs[], const ValidityMask &filter_mask, Aggr
 	    inputs[0], inputs[1], inputs[2], filter_mask, aggr_input_data, state, frame, prev, result, rid, bias);
 }
 
-unique_ptr<FunctionData> BindGeometryClusterDBScan(ClientContext &context, AggregateFunction &function,
-                                                   vector<unique_ptr<Expression>> &arguments) {
-	auto geo_type = arguments[0]->return_type;
-	function =
+static AggregateFunction GetClusterDBScanFunction(const LogicalType &geo_type, const string &name) {
+	auto function =
 	    AggregateFunction({geo_type, LogicalType::DOUBLE, LogicalType::INTEGER}, LogicalType::INTEGER,
 	                      AggregateFunction::StateSize<ClusterDBScanState>,
 	                      AggregateFunction::StateInitialize<ClusterDBScanState, ClusterDBScanOperation>,
@@ -377,9 +434,109 @@ unique_ptr<FunctionData> BindGeometryClusterDBScan(ClientContext &context, Aggre
 	                      TernaryUpdate<ClusterDBScanState, string_t, double, int, ClusterDBScanOperation>, nullptr,
 	                      AggregateFunction::StateDestroy<ClusterDBScanState, ClusterDBScanOperation>, nullptr,
 	                      TernaryWindow<ClusterDBScanState, string_t, double, int, int, ClusterDBScanOperation>);
-	function.name = "st_clusterdbscan";
+	function.name = name;
 	function.arguments[0] = geo_type;
-	return nullptr;
+	return function;
+}
+
+unique_ptr<FunctionData> BindGeometryClusterDBScan(ClientContext &context, AggregateFunction &function,
+                                                   vector<unique_ptr<Expression>> &arguments) {
+	function = GetClusterDBScanFunction(arguments[0]->return_type, "st_clusterdbscan");
+	return make_unique<ClusterDBScanBindData>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+}
+
+//! Connected components are DBSCAN clusters of a single point: rows within the distance of each other, or
+//! intersecting each other for a distance of zero, end up in the same cluster
+unique_ptr<FunctionData> BindGeometryClusterIntersectingWin(ClientContext &context, AggregateFunction &function,
+                                                            vector<unique_ptr<Expression>> &arguments) {
+	arguments.push_back(make_unique<BoundConstantExpression>(Value::DOUBLE(0)));
+	arguments.push_back(make_unique<BoundConstantExpression>(Value::INTEGER(1)));
+	function = GetClusterDBScanFunction(arguments[0]->return_type, "st_clusterintersectingwin");
+	return make_unique<ClusterDBScanBindData>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+}
+
+unique_ptr<FunctionData> BindGeometryClusterWithinWin(ClientContext &context, AggregateFunction &function,
+                                                      vector<unique_ptr<Expression>> &arguments) {
+	arguments.push_back(make_unique<BoundConstantExpression>(Value::INTEGER(1)));
+	function = GetClusterDBScanFunction(arguments[0]->return_type, "st_clusterwithinwin");
+	return make_unique<ClusterDBScanBindData>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+}
+
+//! The rows are gathered as for ST_ClusterDBSCAN, the group is returned as its connected components: a list with a
+//! GEOMETRYCOLLECTION of the members of each component
+struct ClusterWithinOperation : public ClusterDBScanOperation {
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.isset) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		std::vector<GSERIALIZED *> gserArray {};
+		for (auto &row : *state.rows) {
+			auto gser = Geometry::GetGserialized(string_t(row.data(), row.size()));
+			if (!gser) {
+				continue;
+			}
+			if (Geometry::IsEmpty(gser)) {
+				Geometry::DestroyGeometry(gser);
+				continue;
+			}
+			gserArray.push_back(gser);
+		}
+
+		std::vector<GSERIALIZED *> components;
+		if (!gserArray.empty()) {
+			auto &bind_data = (ClusterDBScanBindData &)*finalize_data.input.bind_data;
+			components = Geometry::GeometryClusterWithin(&gserArray[0], gserArray.size(), state.epsilon,
+			                                             bind_data.nthreads);
+		}
+		for (idx_t child_idx = 0; child_idx < gserArray.size(); child_idx++) {
+			Geometry::DestroyGeometry(gserArray[child_idx]);
+		}
+
+		auto &result = finalize_data.result;
+		target.offset = ListVector::GetListSize(result);
+		target.length = components.size();
+		ListVector::Reserve(result, target.offset + target.length);
+		auto &child = ListVector::GetEntry(result);
+		auto child_data = FlatVector::GetData<string_t>(child);
+		for (idx_t i = 0; i < components.size(); i++) {
+			child_data[target.offset + i] = Geometry::SerializeToVector(components[i], child);
+			Geometry::DestroyGeometry(components[i]);
+		}
+		ListVector::SetListSize(result, target.offset + target.length);
+	}
+};
+
+static AggregateFunction GetClusterWithinFunction(const LogicalType &geo_type, const string &name) {
+	auto function =
+	    AggregateFunction({geo_type, LogicalType::DOUBLE, LogicalType::INTEGER}, LogicalType::LIST(geo_type),
+	                      AggregateFunction::StateSize<ClusterDBScanState>,
+	                      AggregateFunction::StateInitialize<ClusterDBScanState, ClusterWithinOperation>,
+	                      TernaryScatterUpdate<ClusterDBScanState, string_t, double, int, ClusterWithinOperation>,
+	                      AggregateFunction::StateCombine<ClusterDBScanState, ClusterWithinOperation>,
+	                      AggregateFunction::StateFinalize<ClusterDBScanState, list_entry_t, ClusterWithinOperation>,
+	                      FunctionNullHandling::DEFAULT_NULL_HANDLING,
+	                      TernaryUpdate<ClusterDBScanState, string_t, double, int, ClusterWithinOperation>, nullptr,
+	                      AggregateFunction::StateDestroy<ClusterDBScanState, ClusterWithinOperation>);
+	function.name = name;
+	function.arguments[0] = geo_type;
+	return function;
+}
+
+unique_ptr<FunctionData> BindGeometryClusterIntersecting(ClientContext &context, AggregateFunction &function,
+                                                         vector<unique_ptr<Expression>> &arguments) {
+	arguments.push_back(make_unique<BoundConstantExpression>(Value::DOUBLE(0)));
+	arguments.push_back(make_unique<BoundConstantExpression>(Value::INTEGER(1)));
+	function = GetClusterWithinFunction(arguments[0]->return_type, "st_clusterintersecting");
+	return make_unique<ClusterDBScanBindData>(TaskScheduler::GetScheduler(context).NumberOfThreads());
+}
+
+unique_ptr<FunctionData> BindGeometryClusterWithin(ClientContext &context, AggregateFunction &function,
+                                                   vector<unique_ptr<Expression>> &arguments) {
+	arguments.push_back(make_unique<BoundConstantExpression>(Value::INTEGER(1)));
+	function = GetClusterWithinFunction(arguments[0]->return_type, "st_clusterwithin");
+	return make_unique<ClusterDBScanBindData>(TaskScheduler::GetScheduler(context).NumberOfThreads());
 }
 
 static const AggregateFunctionSet GetClusterDBScanAggregateFunction(LogicalType geo_type) {
@@ -392,4 +549,553 @@ static const AggregateFunctionSet GetClusterDBScanAggregateFunction(LogicalType
 	return cluster_dbscan;
 }
 
+static const AggregateFunctionSet GetClusterIntersectingAggregateFunction(LogicalType geo_type) {
+	// ST_CLUSTERINTERSECTING
+	AggregateFunctionSet cluster_intersecting("st_clusterintersecting");
+	cluster_intersecting.AddFunction(AggregateFunction({geo_type}, LogicalType::LIST(geo_type), nullptr, nullptr,
+	                                                   nullptr, nullptr, nullptr,
+	                                                   FunctionNullHandling::DEFAULT_NULL_HANDLING, nullptr,
+	                                                   BindGeometryClusterIntersecting));
+
+	return cluster_intersecting;
+}
+
+static const AggregateFunctionSet GetClusterIntersectingWinAggregateFunction(LogicalType geo_type) {
+	// ST_CLUSTERINTERSECTINGWIN
+	AggregateFunctionSet cluster_intersecting("st_clusterintersectingwin");
+	cluster_intersecting.AddFunction(AggregateFunction({geo_type}, LogicalTypeId::INTEGER, nullptr, nullptr, nullptr,
+	                                                   nullptr, nullptr, FunctionNullHandling::DEFAULT_NULL_HANDLING,
+	                                                   nullptr, BindGeometryClusterIntersectingWin));
+
+	return cluster_intersecting;
+}
+
+static const AggregateFunctionSet GetClusterWithinAggregateFunction(LogicalType geo_type) {
+	// ST_CLUSTERWITHIN
+	AggregateFunctionSet cluster_within("st_clusterwithin");
+	cluster_within.AddFunction(AggregateFunction({geo_type, LogicalType::DOUBLE}, LogicalType::LIST(geo_type), nullptr,
+	                                             nullptr, nullptr, nullptr, nullptr,
+	                                             FunctionNullHandling::DEFAULT_NULL_HANDLING, nullptr,
+	                                             BindGeometryClusterWithin));
+
+	return cluster_within;
+}
+
+static const AggregateFunctionSet GetClusterWithinWinAggregateFunction(LogicalType geo_type) {
+	// ST_CLUSTERWITHINWIN
+	AggregateFunctionSet cluster_within("st_clusterwithinwin");
+	cluster_within.AddFunction(AggregateFunction({geo_type, LogicalType::DOUBLE}, LogicalTypeId::INTEGER, nullptr,
+	                                             nullptr, nullptr, nullptr, nullptr,
+	                                             FunctionNullHandling::DEFAULT_NULL_HANDLING, nullptr,
+	                                             BindGeometryClusterWithinWin));
+
+	return cluster_within;
+}
+
+static bool IsClusterWindowFunction(const string &name) {
+	return name == "st_clusterdbscan" || name == "st_clusterintersectingwin" || name == "st_clusterwithinwin" ||
+	       name == "st_clusterkmeans";
+}
+
+//! No ORDER BY, or UNBOUNDED on both ends: every row of the partition has the whole partition as its frame
+static bool IsWholePartitionFrame(const BoundWindowExpression &wexpr) {
+	switch (wexpr.start) {
+	case WindowBoundary::UNBOUNDED_PRECEDING:
+		break;
+	case WindowBoundary::CURRENT_ROW_RANGE:
+		if (!wexpr.orders.empty()) {
+			return false;
+		}
+		break;
+	default:
+		return false;
+	}
+	switch (wexpr.end) {
+	case WindowBoundary::UNBOUNDED_FOLLOWING:
+		return true;
+	case WindowBoundary::CURRENT_ROW_RANGE:
+		return wexpr.orders.empty();
+	default:
+		return false;
+	}
+}
+
+//! DuckDB runs a frame over the whole partition, such as OVER (), as one Update/Finalize per partition and hands the
+//! result to every row, the same way as a plain aggregate. Cluster labels belong to the rows, so such a frame of a
+//! clustering function is rewritten to end at an offset past any partition: the same rows, framed row by row through
+//! Window. The rewrite is an optimizer pass, it does not run with the optimizer disabled.
+static void RewriteClusterWindows(ClientContext &context, OptimizerExtensionInfo *info,
+                                  unique_ptr<LogicalOperator> &plan) {
+	if (plan->type == LogicalOperatorType::LOGICAL_WINDOW) {
+		for (auto &expr : plan->expressions) {
+			if (expr->expression_class != ExpressionClass::BOUND_WINDOW) {
+				continue;
+			}
+			auto &wexpr = (BoundWindowExpression &)*expr;
+			if (!wexpr.aggregate || !IsClusterWindowFunction(wexpr.aggregate->name) || !IsWholePartitionFrame(wexpr)) {
+				continue;
+			}
+			wexpr.start = WindowBoundary::UNBOUNDED_PRECEDING;
+			wexpr.end = WindowBoundary::EXPR_FOLLOWING_ROWS;
+			wexpr.end_expr =
+			    make_unique<BoundConstantExpression>(Value::BIGINT(NumericLimits<int64_t>::Maximum() / 2));
+		}
+	}
+	for (auto &child : plan->children) {
+		RewriteClusterWindows(context, info, child);
+	}
+}
+
+//! The cluster centre of each row of a window read once, and the labels of the last frame clustered
+struct ClusterKMeansWindowCache {
+	//! Centre of row i, false when it is empty. Centres are kept as long as the input stays the same.
+	bool GetRow(const string_t *data, idx_t i, POINT2D &centre) {
+		if (data != rows_data) {
+			centres.clear();
+			states.clear();
+			has_clusters = false;
+			rows_data = data;
+		}
+		if (i >= states.size()) {
+			centres.resize(i + 1);
+			states.resize(i + 1, ROW_UNREAD);
+		}
+		if (states[i] == ROW_UNREAD) {
+			states[i] = Geometry::GetClusterCentre(data[i], centres[i]) ? ROW_CENTRE : ROW_EMPTY;
+		}
+		centre = centres[i];
+		return states[i] == ROW_CENTRE;
+	}
+
+	bool IsClustered(const string_t *data, const FrameBounds &frame, int k, double max_radius) const {
+		return has_clusters && data == rows_data && frame.first == frame_first && frame.second == frame_second &&
+		       k == this->k && max_radius == this->max_radius;
+	}
+
+	template <class INCLUDED>
+	void Cluster(const string_t *data, const INCLUDED &include, const FrameBounds &frame, int k, double max_radius) {
+		std::vector<POINT2D> frame_centres;
+		std::vector<int> index(frame.second - frame.first, -1);
+		for (idx_t i = frame.first; i < frame.second; i++) {
+			POINT2D centre;
+			if (include(i) && GetRow(data, i, centre)) {
+				index[i - frame.first] = frame_centres.size();
+				frame_centres.push_back(centre);
+			}
+		}
+
+		std::vector<int> labels;
+		if (!frame_centres.empty()) {
+			labels = Geometry::GeometryClusterKMeans(frame_centres.data(), frame_centres.size(), k, max_radius);
+		}
+		clusters.assign(index.size(), -1);
+		for (idx_t i = 0; i < index.size(); i++) {
+			if (index[i] != -1) {
+				clusters[i] = labels[index[i]];
+			}
+		}
+
+		has_clusters = true;
+		frame_first = frame.first;
+		frame_second = frame.second;
+		this->k = k;
+		this->max_radius = max_radius;
+	}
+
+	static constexpr uint8_t ROW_UNREAD = 0;
+	static constexpr uint8_t ROW_EMPTY = 1;
+	static constexpr uint8_t ROW_CENTRE = 2;
+
+	const string_t *rows_data = nullptr;
+	std::vector<POINT2D> centres;
+	std::vector<uint8_t> states;
+
+	bool has_clusters = false;
+	idx_t frame_first = 0;
+	idx_t frame_second = 0;
+	int k = 0;
+	double max_radius = 0;
+	std::vector<int> clusters;
+};
+
+struct ClusterKMeansState {
+	bool isset;
+	int k;
+	double max_radius;
+	//! Centres of the non-empty rows of the group, when used as a plain aggregate
+	std::vector<POINT2D> *centres;
+	ClusterKMeansWindowCache *window;
+};
+
+//! k-means of the centroids on the unit sphere. As a window function every row gets the number of its cluster
+//! within the frame, NULL when it is empty. As a plain aggregate the number of clusters formed is returned.
+struct ClusterKMeansOperation {
+	static int CheckK(int k) {
+		if (k <= 0) {
+			throw ConversionException("ST_ClusterKMeans: number of clusters must be greater than zero");
+		}
+		return k;
+	}
+
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.isset = false;
+		state.k = 0;
+		state.max_radius = 0;
+		state.centres = nullptr;
+		state.window = nullptr;
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &aggr_input_data) {
+		if (!source.isset) {
+			return;
+		}
+		if (!target.isset) {
+			target.isset = true;
+			target.k = source.k;
+			target.max_radius = source.max_radius;
+		}
+		if (!target.centres) {
+			target.centres = new std::vector<POINT2D>();
+		}
+		target.centres->insert(target.centres->end(), source.centres->begin(), source.centres->end());
+	}
+
+	template <class A_TYPE, class B_TYPE, class C_TYPE, class STATE, class OP>
+	static void Operation(STATE *state, AggregateInputData &, A_TYPE *x_data, B_TYPE *y_data, C_TYPE *z_data,
+	                      ValidityMask &amask, ValidityMask &bmask, ValidityMask &cmask, idx_t xidx, idx_t yidx,
+	                      idx_t zidx, idx_t count) {
+		if (!state->isset) {
+			state->isset = true;
+			state->k = CheckK(y_data[yidx]);
+			state->max_radius = z_data[zidx] / MS_PER_RADIAN;
+			state->centres = new std::vector<POINT2D>();
+		}
+		POINT2D centre;
+		if (Geometry::GetClusterCentre(x_data[xidx], centre)) {
+			state->centres->push_back(centre);
+		}
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.isset) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		auto &centres = *state.centres;
+		std::vector<int> clusters;
+		if (!centres.empty()) {
+			clusters = Geometry::GeometryClusterKMeans(centres.data(), centres.size(), state.k, state.max_radius);
+		}
+		int nclusters = 0;
+		for (auto cluster : clusters) {
+			nclusters = MaxValue(nclusters, cluster + 1);
+		}
+		target = nclusters;
+	}
+
+	template <class STATE, class A_TYPE, class B_TYPE, class C_TYPE, class RESULT_TYPE>
+	static void Window(const A_TYPE *adata, const B_TYPE *bdata, const C_TYPE *cdata, const ValidityMask &fmask,
+	                   const ValidityMask &amask, const ValidityMask &bmask, const ValidityMask &cmask,
+	                   AggregateInputData &aggr_input_data, STATE *state, const FrameBounds &frame,
+	                   const FrameBounds &prev, Vector &result, idx_t ridx, idx_t bias) {
+		ClusterDBScanIncluded include(fmask, amask, bmask, cmask, bias);
+
+		auto rdata = FlatVector::GetData<RESULT_TYPE>(result);
+		auto &rmask = FlatVector::Validity(result);
+		int k = CheckK(bdata[ridx]);
+		double max_radius = cdata[ridx] / MS_PER_RADIAN;
+		if (!state->window) {
+			state->window = new ClusterKMeansWindowCache();
+		}
+		auto &window = *state->window;
+		if (!window.IsClustered(adata, frame, k, max_radius)) {
+			window.Cluster(adata, include, frame, k, max_radius);
+		}
+
+		if (ridx < frame.first || ridx >= frame.second || window.clusters[ridx - frame.first] == -1) {
+			rmask.SetInvalid(ridx);
+		} else {
+			rdata[ridx] = window.clusters[ridx - frame.first];
+		}
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+		delete state.centres;
+		state.centres = nullptr;
+		delete state.window;
+		state.window = nullptr;
+	}
+};
+
+unique_ptr<FunctionData> BindGeometryClusterKMeans(ClientContext &context, AggregateFunction &function,
+                                                   vector<unique_ptr<Expression>> &arguments) {
+	auto geo_type = arguments[0]->return_type;
+	// without a max_radius the clusters may be as wide as they come out
+	if (arguments.size() == 2) {
+		arguments.push_back(make_unique<BoundConstantExpression>(Value::DOUBLE(0)));
+	}
+	function =
+	    AggregateFunction({geo_type, LogicalType::INTEGER, LogicalType::DOUBLE}, LogicalType::INTEGER,
+	                      AggregateFunction::StateSize<ClusterKMeansState>,
+	                      AggregateFunction::StateInitialize<ClusterKMeansState, ClusterKMeansOperation>,
+	                      TernaryScatterUpdate<ClusterKMeansState, string_t, int, double, ClusterKMeansOperation>,
+	                      AggregateFunction::StateCombine<ClusterKMeansState, ClusterKMeansOperation>,
+	                      AggregateFunction::StateFinalize<ClusterKMeansState, int, ClusterKMeansOperation>,
+	                      FunctionNullHandling::DEFAULT_NULL_HANDLING,
+	                      TernaryUpdate<ClusterKMeansState, string_t, int, double, ClusterKMeansOperation>, nullptr,
+	                      AggregateFunction::StateDestroy<ClusterKMeansState, ClusterKMeansOperation>, nullptr,
+	                      TernaryWindow<ClusterKMeansState, string_t, int, double, int, ClusterKMeansOperation>);
+	function.name = "st_clusterkmeans";
+	function.arguments[0] = geo_type;
+	return nullptr;
+}
+
+static const AggregateFunctionSet GetClusterKMeansAggregateFunction(LogicalType geo_type) {
+	// ST_CLUSTERKMEANS
+	AggregateFunctionSet cluster_kmeans("st_clusterkmeans");
+	cluster_kmeans.AddFunction(AggregateFunction({geo_type, LogicalType::INTEGER}, LogicalTypeId::INTEGER, nullptr,
+	                                             nullptr, nullptr, nullptr, nullptr,
+	                                             FunctionNullHandling::DEFAULT_NULL_HANDLING, nullptr,
+	                                             BindGeometryClusterKMeans));
+	cluster_kmeans.AddFunction(AggregateFunction(
+	    {geo_type, LogicalType::INTEGER, LogicalType::DOUBLE}, LogicalTypeId::INTEGER, nullptr, nullptr, nullptr,
+	    nullptr, nullptr, FunctionNullHandling::DEFAULT_NULL_HANDLING, nullptr, BindGeometryClusterKMeans));
+
+	return cluster_kmeans;
+}
+
+//! State of an aggregate folding the geometries into an opaque liblwgeom state, allocated with the first row
+template <class FOLD>
+struct GeometryFoldState {
+	typename FOLD::State *fold_state;
+};
+
+//! Scaffolding shared by the aggregates that fold geometries in liblwgeom: FOLD supplies the Create, Add, Combine,
+//! Finalize and Destroy steps of its state, this handles the NULL and empty inputs and the result
+template <class FOLD>
+struct GeometryFoldOperation {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.fold_state = nullptr;
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input) {
+		if (input.GetSize() == 0) {
+			return;
+		}
+		if (!state.fold_state) {
+			state.fold_state = FOLD::Create();
+		}
+		FOLD::Add(state.fold_state, input);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input,
+	                              idx_t count) {
+		// the folds are idempotent, a repeated geometry adds nothing
+		Operation<INPUT_TYPE, STATE, OP>(state, input, unary_input);
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &aggr_input_data) {
+		if (!source.fold_state) {
+			return;
+		}
+		if (!target.fold_state) {
+			target.fold_state = FOLD::Create();
+		}
+		FOLD::Combine(target.fold_state, source.fold_state);
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		auto gser = state.fold_state ? FOLD::Finalize(state.fold_state) : nullptr;
+		if (!gser) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		target = Geometry::SerializeToVector(gser, finalize_data.result);
+		Geometry::DestroyGeometry(gser);
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+
+	template <class STATE>
+	static void Destroy(STATE &state, AggregateInputData &aggr_input_data) {
+		FOLD::Destroy(state.fold_state);
+		state.fold_state = nullptr;
+	}
+};
+
+template <class FOLD>
+static AggregateFunction GetGeometryFoldAggregate(LogicalType geo_type) {
+	return AggregateFunction::UnaryAggregateDestructor<GeometryFoldState<FOLD>, string_t, string_t,
+	                                                   GeometryFoldOperation<FOLD>>(geo_type, geo_type);
+}
+
+//! Each thread folds its rows into partial unions, Combine merges the partials of two states pairwise
+struct UnionAggregateFold {
+	using State = UnionAggState;
+
+	static State *Create() {
+		return Geometry::CreateUnionAggState();
+	}
+	static void Add(State *state, string_t geom) {
+		Geometry::UnionAggStateAdd(state, geom);
+	}
+	static void Combine(State *target, const State *source) {
+		Geometry::UnionAggStateCombine(target, source);
+	}
+	static GSERIALIZED *Finalize(State *state) {
+		return Geometry::UnionAggStateFinalize(state);
+	}
+	static void Destroy(State *state) {
+		Geometry::DestroyUnionAggState(state);
+	}
+};
+
+static const AggregateFunctionSet GetUnionAggregateFunction(LogicalType geo_type) {
+	// ST_UNION_AGG
+	AggregateFunctionSet union_agg("st_union_agg");
+	union_agg.AddFunction(GetGeometryFoldAggregate<UnionAggregateFold>(geo_type));
+
+	return union_agg;
+}
+
+//! Each thread keeps the hull vertices of its rows, Combine merges two vertex sets into the hull of both
+struct ConvexHullAggregateFold {
+	using State = ConvexHullAggState;
+
+	static State *Create() {
+		return Geometry::CreateConvexHullAggState();
+	}
+	static void Add(State *state, string_t geom) {
+		Geometry::ConvexHullAggStateAdd(state, geom);
+	}
+	static void Combine(State *target, const State *source) {
+		Geometry::ConvexHullAggStateCombine(target, source);
+	}
+	static GSERIALIZED *Finalize(State *state) {
+		return Geometry::ConvexHullAggStateFinalize(state);
+	}
+	static void Destroy(State *state) {
+		Geometry::DestroyConvexHullAggState(state);
+	}
+};
+
+static const AggregateFunctionSet GetConvexHullAggregateFunction(LogicalType geo_type) {
+	// ST_CONVEXHULL_AGG
+	AggregateFunctionSet convexhull_agg("st_convexhull_agg");
+	convexhull_agg.AddFunction(GetGeometryFoldAggregate<ConvexHullAggregateFold>(geo_type));
+
+	return convexhull_agg;
+}
+
+struct ExtentAggregateState {
+	bool has_srid;
+	int32_t srid;
+	bool has_box;
+	GBOX box;
+};
+
+//! Folds 2D boxes read straight from the EWKB, only the box is carried between rows and threads
+struct ExtentAggregateOperation {
+	template <class STATE>
+	static void Initialize(STATE &state) {
+		state.has_srid = false;
+		state.has_box = false;
+	}
+
+	template <class STATE>
+	static void AddSrid(STATE &state, int32_t srid) {
+		if (state.has_srid && state.srid != srid) {
+			throw Exception(
+			    StringUtil::Format("ST_Extent_Agg: Operation on mixed SRID geometries %d != %d", state.srid, srid));
+		}
+		state.has_srid = true;
+		state.srid = srid;
+	}
+
+	template <class STATE>
+	static void AddBox(STATE &state, const GBOX &box) {
+		if (!state.has_box) {
+			state.has_box = true;
+			state.box = box;
+			return;
+		}
+		state.box.xmin = MinValue(state.box.xmin, box.xmin);
+		state.box.xmax = MaxValue(state.box.xmax, box.xmax);
+		state.box.ymin = MinValue(state.box.ymin, box.ymin);
+		state.box.ymax = MaxValue(state.box.ymax, box.ymax);
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void Operation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input) {
+		if (input.GetSize() == 0) {
+			return;
+		}
+		int32_t srid = 0;
+		GBOX box;
+		bool has_box = Geometry::GetExtent(input, srid, box);
+		AddSrid(state, srid);
+		if (has_box) {
+			AddBox(state, box);
+		}
+	}
+
+	template <class INPUT_TYPE, class STATE, class OP>
+	static void ConstantOperation(STATE &state, const INPUT_TYPE &input, AggregateUnaryInput &unary_input,
+	                              idx_t count) {
+		// a repeated geometry does not grow the box
+		Operation<INPUT_TYPE, STATE, OP>(state, input, unary_input);
+	}
+
+	template <class STATE, class OP>
+	static void Combine(const STATE &source, STATE &target, AggregateInputData &aggr_input_data) {
+		if (!source.has_srid) {
+			return;
+		}
+		AddSrid(target, source.srid);
+		if (source.has_box) {
+			AddBox(target, source.box);
+		}
+	}
+
+	template <class T, class STATE>
+	static void Finalize(STATE &state, T &target, AggregateFinalizeData &finalize_data) {
+		if (!state.has_srid) {
+			finalize_data.ReturnNull();
+			return;
+		}
+		auto gser = Geometry::GeometryEnvelope(state.has_box ? &state.box : nullptr, state.srid);
+		target = Geometry::SerializeToVector(gser, finalize_data.result);
+		Geometry::DestroyGeometry(gser);
+	}
+
+	static bool IgnoreNull() {
+		return true;
+	}
+};
+
+static const AggregateFunctionSet GetExtentAggregateFunction(LogicalType geo_type) {
+	// ST_EXTENT_AGG
+	AggregateFunctionSet extent_agg("st_extent_agg");
+	extent_agg.AddFunction(
+	    AggregateFunction::UnaryAggregate<ExtentAggregateState, string_t, string_t, ExtentAggregateOperation>(
+	        geo_type, geo_type));
+
+	return extent_agg;
+}
+
 } // namespace duckdb
@@ -14,6 +14,12 @@
 
 namespace duckdb {
 
+struct PrepGeomCache;
+struct CircTreeGeomCache;
+struct CircTreeKnnIndex;
+struct UnionAggState;
+struct ConvexHullAggState;
+
 enum class DataFormatType : uint8_t { FORMAT_VALUE_TYPE_WKB, FORMAT_VALUE_TYPE_WKT, FORMAT_VALUE_TYPE_GEOJSON };
 
 //! The Geometry class is a static class that holds helper functions for the Geometry type.
@@ -26,6 +32,13 @@ public:
 	static string ToString(string_t geometry, DataFormatType ftype = DataFormatType::FORMAT_VALUE_TYPE_WKB);
 
 	static GSERIALIZED *GetGserialized(string_t geom);
+	//! Decode the stored EWKB straight into an LWGEOM, without going through GSERIALIZED
+	static LWGEOM *GetLWGeometry(string_t geom);
+	static LWGEOM *GetLWGeometry(GSERIALIZED *gser);
+	//! Read the SRID and the exact 2D extent from the stored EWKB. Returns false for empty and curved geometries.
+	static bool GetGBox(string_t geom, int32_t &srid, GBOX &gbox);
+	//! SRID and coordinates of a non-empty point, read from the header without decoding; false for anything else
+	static bool GetPoint(string_t geom, int32_t &srid, POINT2D &point);
 
 	//! Convert a string to a geometry. This function should ONLY be called after calling GetGeometrySize, since it does
 	//! NOT perform data validation.
@@ -39,8 +52,12 @@ public:
 	static idx_t GetGeometrySize(GSERIALIZED *gser);
 
 	static void DestroyGeometry(GSERIALIZED *gser);
+	static void DestroyLWGeometry(LWGEOM *lwgeom);
 
-	static data_ptr_t GetBase(GSERIALIZED *gser);
+	//! Serialize a geometry as EWKB directly into the string heap of the result vector. The geometry is
+	//! deserialized once and the output buffer is sized exactly, so no intermediate copy is made.
+	static string_t SerializeToVector(GSERIALIZED *gser, Vector &result);
+	static string_t SerializeToVector(LWGEOM *lwgeom, Vector &result);
 
 	static GSERIALIZED *MakePoint(double x, double y);
 	static GSERIALIZED *MakePoint(double x, double y, double z);
@@ -49,9 +66,13 @@ public:
 	static GSERIALIZED *MakePolygon(GSERIALIZED *geom, GSERIALIZED *gserArray[] = {}, int nelems = 0);
 
 	static lwvarlena_t *AsBinary(GSERIALIZED *gser, string text = "");
+	static lwvarlena_t *AsBinary(LWGEOM *lwgeom, string text = "");
 	static std::string AsText(GSERIALIZED *gser, int max_digits = OUT_DEFAULT_DECIMAL_DIGITS);
+	static std::string AsText(LWGEOM *lwgeom, int max_digits = OUT_DEFAULT_DECIMAL_DIGITS);
 	static lwvarlena_t *AsGeoJson(GSERIALIZED *gser, size_t m_dec_digits = OUT_DEFAULT_DECIMAL_DIGITS);
+	static lwvarlena_t *AsGeoJson(LWGEOM *lwgeom, size_t m_dec_digits = OUT_DEFAULT_DECIMAL_DIGITS);
 	static lwvarlena_t *GeoHash(GSERIALIZED *gser, size_t m_chars = 0);
+	static lwvarlena_t *GeoHash(LWGEOM *lwgeom, size_t m_chars = 0);
 
 	static GSERIALIZED *GeomFromGeoJson(string_t json);
 	static GSERIALIZED *FromText(char *text);
@@ -63,11 +84,25 @@ public:
 	static GSERIALIZED *ClosestPoint(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	static GSERIALIZED *GeometryUnion(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	static GSERIALIZED *GeometryUnionGArray(GSERIALIZED *gserArray[], int nelems);
+	//! State of the union aggregate, folding inputs into partial unions as they are added
+	static UnionAggState *CreateUnionAggState();
+	static void UnionAggStateAdd(UnionAggState *state, string_t geom);
+	static void UnionAggStateCombine(UnionAggState *target, const UnionAggState *source);
+	//! The union of all added geometries, or nullptr when nothing was added
+	static GSERIALIZED *UnionAggStateFinalize(UnionAggState *state);
+	static void DestroyUnionAggState(UnionAggState *state);
 	static GSERIALIZED *GeometryIntersection(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	static GSERIALIZED *GeometrySimplify(GSERIALIZED *geom, double dist);
 	static GSERIALIZED *Centroid(GSERIALIZED *g);
 	static GSERIALIZED *Centroid(GSERIALIZED *g, bool use_spheroid);
 	static GSERIALIZED *Convexhull(GSERIALIZED *g);
+	//! State of the convex hull aggregate, keeping the vertices of the hull of the inputs added so far
+	static ConvexHullAggState *CreateConvexHullAggState();
+	static void ConvexHullAggStateAdd(ConvexHullAggState *state, string_t geom);
+	static void ConvexHullAggStateCombine(ConvexHullAggState *target, const ConvexHullAggState *source);
+	//! The convex hull of all added geometries, or nullptr when nothing was added
+	static GSERIALIZED *ConvexHullAggStateFinalize(ConvexHullAggState *state);
+	static void DestroyConvexHullAggState(ConvexHullAggState *state);
 	static GSERIALIZED *GeometrySnapToGrid(GSERIALIZED *geom, double size);
 	static GSERIALIZED *GeometryBuffer(GSERIALIZED *geom, double radius);
 	static GSERIALIZED *GeometryBufferText(GSERIALIZED *geom, double radius, string styles_text);
@@ -80,40 +115,143 @@ public:
 	static bool GeometryCovers(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	static bool GeometryCoveredby(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	static bool GeometryDisjoint(GSERIALIZED *geom1, GSERIALIZED *geom2);
+	//! Decode a geometry that is compared against many rows once, outside the arena so it can be kept across calls
+	static PrepGeomCache *GetPreparedGeometry(string_t geom);
+	static void DestroyPreparedGeometry(PrepGeomCache *prepared);
+	//! Predicates with the prepared geometry as argument number argnum (1 or 2) and geom as the other
+	static bool GeometryContains(PrepGeomCache *prepared, int argnum, GSERIALIZED *geom);
+	static bool GeometryWithin(PrepGeomCache *prepared, int argnum, GSERIALIZED *geom);
+	static bool GeometryIntersects(PrepGeomCache *prepared, int argnum, GSERIALIZED *geom);
+	//! Point-in-polygon of a batch of points against a prepared (multi)polygon: -1 outside, 0 boundary, 1 inside
+	static bool CanLocatePoints(PrepGeomCache *prepared);
+	static void LocatePoints(PrepGeomCache *prepared, const vector<double> &xs, const vector<double> &ys,
+	                         vector<int> &locations);
 	static bool GeometryDWithin(GSERIALIZED *geom1, GSERIALIZED *geom2, double distance, bool use_spheroid);
+	static bool GeometryDWithin(LWGEOM *lwgeom1, LWGEOM *lwgeom2, double distance, bool use_spheroid);
+	static bool GeometryDWithin(CircTreeGeomCache *tree, int argnum, LWGEOM *lwgeom, double distance,
+	                            bool use_spheroid);
+	//! DWithin of count point pairs sharing one SRID, without building geometries
+	static void GeometryDWithin(const POINT2D *points1, const POINT2D *points2, const double *distances, idx_t count,
+	                            int32_t srid, bool use_spheroid, bool *results);
+	//! Cell of a non-empty point in the dwithin join grid for distance; false for anything else
+	static bool GeometryDWithinCell(string_t geom, double distance, uint64_t &cell);
+	//! Cells of the dwithin join grid for distance that hold every point within distance of geom; throws when they
+	//! are too many to list
+	static void GeometryDWithinCells(string_t geom, double distance, vector<uint64_t> &cells);
 
 	static double GeometryArea(GSERIALIZED *geom);
 	static double GeometryArea(GSERIALIZED *geom, bool use_spheroid);
+	static double GeometryArea(LWGEOM *lwgeom, bool use_spheroid);
 	static double GeometryAngle(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	static double GeometryAngle(std::vector<GSERIALIZED *> geom_vec);
 	static double GeometryPerimeter(GSERIALIZED *geom);
 	static double GeometryPerimeter(GSERIALIZED *geom, bool use_spheroid);
+	static double GeometryPerimeter(LWGEOM *lwgeom, bool use_spheroid);
 	static double GeometryAzimuth(GSERIALIZED *geom1, GSERIALIZED *geom2);
+	static double GeometryAzimuth(LWGEOM *lwgeom1, LWGEOM *lwgeom2);
 	static double GeometryLength(GSERIALIZED *geom);
 	static double GeometryLength(GSERIALIZED *geom, bool use_spheroid);
+	static double GeometryLength(LWGEOM *lwgeom, bool use_spheroid);
 	static GSERIALIZED *GeometryBoundingBox(GSERIALIZED *geom);
 	static double Distance(GSERIALIZED *g1, GSERIALIZED *g2);
 	static double Distance(GSERIALIZED *g1, GSERIALIZED *g2, bool use_spheroid);
+	static double Distance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid);
+	static double Distance(CircTreeGeomCache *tree, int argnum, LWGEOM *lwgeom, bool use_spheroid);
+	//! Distances of count point pairs sharing one SRID, without building geometries or circ trees
+	static void Distance(const POINT2D *points1, const POINT2D *points2, idx_t count, int32_t srid, bool use_spheroid,
+	                     double *distances);
 	static double MaxDistance(GSERIALIZED *g1, GSERIALIZED *g2, bool use_spheroid = true);
+	static double MaxDistance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid = true);
+	static double MaxDistance(CircTreeGeomCache *tree, int argnum, LWGEOM *lwgeom, bool use_spheroid = true);
+	//! Decode a geography and build its circ tree, outside the arena so both can be reused across calls
+	static CircTreeGeomCache *GetCircTree(string_t geom);
+	static void DestroyCircTree(CircTreeGeomCache *tree);
+	//! Index a set of geographies for nearest neighbour searches, outside the arena. Null members are left out.
+	static CircTreeKnnIndex *GetKnnIndex(const vector<string_t> &geoms, const vector<bool> &valid);
+	static void DestroyKnnIndex(CircTreeKnnIndex *index);
+	//! Positions in the index of the (at most) k members nearest to lwgeom, nearest first
+	static void KNearest(const CircTreeKnnIndex *index, LWGEOM *lwgeom, idx_t k, bool use_spheroid,
+	                     vector<uint32_t> &results);
 	static GSERIALIZED *GeometryExtent(GSERIALIZED *gserArray[], int nelems);
+	//! 2D extent of one geography for the extent aggregate. Returns false for empty geographies, srid is set anyway.
+	static bool GetExtent(string_t geom, int32_t &srid, GBOX &gbox);
+	//! Envelope geometry of an extent, or an empty collection when box is nullptr
+	static GSERIALIZED *GeometryEnvelope(const GBOX *box, int32_t srid);
+	//! Hilbert and Z-order keys of the box centre of geom within extent. Return false for empty geographies.
+	static bool GeometryHilbert(string_t geom, const GBOX &extent, uint64_t &key);
+	static bool GeometryZOrder(string_t geom, const GBOX &extent, uint64_t &key);
 
-	static std::vector<int> GeometryClusterDBScan(GSERIALIZED *gserArray[], int nelems, double tolerance,
-	                                              int minpoints);
+	//! DBSCAN labels of the geographies, tolerance in radians, with the neighbours searched on up to nthreads threads
+	static std::vector<int> GeometryClusterDBScan(GSERIALIZED *gserArray[], int nelems, double tolerance, int minpoints,
+	                                              int nthreads);
+	static std::vector<int> GeometryClusterDBScan(LWGEOM *geoms[], int nelems, double tolerance, int minpoints,
+	                                              int nthreads);
+	//! The connected components of the geographies within tolerance (radians), one GEOMETRYCOLLECTION each
+	static std::vector<GSERIALIZED *> GeometryClusterWithin(GSERIALIZED *gserArray[], int nelems, double tolerance,
+	                                                        int nthreads);
+	//! The point a geography is clustered by in k-means, its centroid on the sphere. False for empty geographies.
+	static bool GetClusterCentre(string_t geom, POINT2D &centre);
+	static std::vector<int> GeometryClusterKMeans(const POINT2D *centres, int ncentres, int k, double max_radius);
 
 	static int LWGEOM_dimension(GSERIALIZED *geom);
+	static int LWGEOM_dimension(LWGEOM *lwgeom);
 	static std::vector<GSERIALIZED *> LWGEOM_dump(GSERIALIZED *geom);
+	//! Byte ranges of the ST_DUMP components inside geom, false when it has to go through LWGEOM_dump
+	static bool GetDumpComponents(string_t geom, int32_t &srid, std::vector<WKB_COMPONENT> &components);
+	static idx_t DumpComponentSize(const WKB_COMPONENT &component, int32_t srid);
+	static void WriteDumpComponent(string_t geom, const WKB_COMPONENT &component, int32_t srid, char *buffer);
 	static GSERIALIZED *LWGEOM_endpoint_linestring(GSERIALIZED *geom);
 	static std::string Geometrytype(GSERIALIZED *geom);
+	static std::string Geometrytype(LWGEOM *lwgeom);
+	//! The string_t accessors read the stored EWKB header and only decode the geometry when they have to
+	static std::string Geometrytype(string_t geom);
 	static bool IsClosed(GSERIALIZED *geom);
+	static bool IsClosed(LWGEOM *lwgeom);
 	static bool IsCollection(GSERIALIZED *geom);
+	static bool IsCollection(LWGEOM *lwgeom);
 	static bool IsEmpty(GSERIALIZED *geom);
+	static bool IsEmpty(LWGEOM *lwgeom);
+	static bool IsEmpty(string_t geom);
 	static bool IsRing(GSERIALIZED *geom);
 	static int NPoints(GSERIALIZED *geom);
+	static int NPoints(LWGEOM *lwgeom);
 	static int NumGeometries(GSERIALIZED *geom);
+	static int NumGeometries(LWGEOM *lwgeom);
+	static int NumGeometries(string_t geom);
 	static int NumPoints(GSERIALIZED *geom);
+	static int NumPoints(LWGEOM *lwgeom);
 	static GSERIALIZED *PointN(GSERIALIZED *geom, int index);
 	static GSERIALIZED *StartPoint(GSERIALIZED *geom);
 	static double XPoint(GSERIALIZED *geom);
+	static double XPoint(LWGEOM *lwgeom);
+	static double XPoint(string_t geom);
 	static double YPoint(GSERIALIZED *geom);
+	static double YPoint(LWGEOM *lwgeom);
+	static double YPoint(string_t geom);
+};
+
+//! Serves liblwgeom allocations on the current thread from a per-thread arena while in scope. Everything allocated
+//! inside is released when the outermost scope ends, so no geometry may be kept beyond it.
+class GeometryArenaScope {
+public:
+	GeometryArenaScope() {
+		lwarena_begin();
+	}
+	~GeometryArenaScope() {
+		lwarena_end();
+	}
+};
+
+//! Suspends the arena of the current thread while in scope, for liblwgeom allocations that have to outlive it
+class GeometryPersistentScope {
+public:
+	GeometryPersistentScope() : depth(lwarena_suspend()) {
+	}
+	~GeometryPersistentScope() {
+		lwarena_resume(depth);
+	}
+
+private:
+	int depth;
 };
 } // namespace duckdb
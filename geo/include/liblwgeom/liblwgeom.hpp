@@ -877,6 +877,8 @@ extern double lwpoint_get_x(const LWPOINT *point);
 extern double lwpoint_get_y(const LWPOINT *point);
 
 unsigned int geohash_point_as_int(POINT2D *pt);
+uint64_t hilbert_point_as_int(uint32_t x, uint32_t y);
+uint64_t morton_point_as_int(uint32_t x, uint32_t y);
 
 /**
  * Create an LWGEOM object from a GeoJSON representation
@@ -902,6 +904,14 @@ extern void spheroid_init(SPHEROID *s, double a, double b);
 extern double lwgeom_distance_spheroid(const LWGEOM *lwgeom1, const LWGEOM *lwgeom2, const SPHEROID *spheroid,
                                        double tolerance);
 
+/**
+ * Calculate the geodetic distances between count pairs of points, p1[i] to
+ * p2[i], on the spheroid. Pass per pair tolerances for dwithin, or NULL to
+ * always get the exact spheroid distance.
+ */
+extern void lwpoints_distance_spheroid(const POINT2D *p1, const POINT2D *p2, uint32_t count,
+                                       const SPHEROID *spheroid, const double *tolerances, double *distances);
+
 /**
  * Calculate the bearing between two points on a spheroid.
  */
@@ -1237,6 +1247,47 @@ extern int ptarray_calculate_gbox_cartesian(const POINTARRAY *pa, GBOX *gbox);
  */
 extern LWGEOM *lwgeom_from_wkb(const uint8_t *wkb, const size_t wkb_size, const char check);
 
+/**
+ * Read a single property of a WKB/EWKB buffer from its leading bytes, without
+ * building an LWGEOM. Each returns LW_FAILURE when the value cannot be read
+ * that way, and the caller has to fall back to lwgeom_from_wkb.
+ *
+ * wkb_peek_is_empty handles points, lines, polygons and their collections.
+ * wkb_peek_ngeoms only works for collection types, wkb_peek_first_point only
+ * for non-empty POINTTYPE. wkb_peek_gbox computes the exact 2D extent from
+ * the coordinates and fails for empty and curved geometries.
+ */
+extern int wkb_peek_type(const uint8_t *wkb, const size_t wkb_size, uint8_t *type);
+extern int wkb_peek_srid(const uint8_t *wkb, const size_t wkb_size, int32_t *srid);
+extern int wkb_peek_gbox(const uint8_t *wkb, const size_t wkb_size, GBOX *gbox);
+extern int wkb_peek_is_empty(const uint8_t *wkb, const size_t wkb_size, int *is_empty);
+extern int wkb_peek_ngeoms(const uint8_t *wkb, const size_t wkb_size, uint32_t *ngeoms);
+extern int wkb_peek_first_point(const uint8_t *wkb, const size_t wkb_size, POINT4D *out_point);
+
+/**
+ * A non-empty leaf of a WKB buffer, as listed by wkb_peek_components: the
+ * offset and size of its body, the bytes after its type header.
+ */
+typedef struct {
+	size_t offset;
+	size_t size;
+	uint8_t type;
+	uint8_t has_z;
+	uint8_t has_m;
+} WKB_COMPONENT;
+
+/**
+ * List the non-empty leaves of a native byte order EWKB buffer in
+ * lwgeom_dump order, into an lwalloc'ed array the caller frees. Returns
+ * LW_FAILURE for curves, triangles, surfaces and swapped byte order.
+ * wkb_component_write writes one leaf as a standalone EWKB geometry
+ * carrying srid, of wkb_component_size bytes.
+ */
+extern int wkb_peek_components(const uint8_t *wkb, const size_t wkb_size, int32_t *srid, WKB_COMPONENT **components,
+                               uint32_t *ncomponents);
+extern size_t wkb_component_size(const WKB_COMPONENT *component, int32_t srid);
+extern size_t wkb_component_write(const uint8_t *wkb, const WKB_COMPONENT *component, int32_t srid, uint8_t *buf);
+
 /**
  * @param check parser check flags, see LW_PARSER_CHECK_* macros
  */
@@ -1361,11 +1412,39 @@ extern uint32_t lwtype_get_collectiontype(uint8_t type);
 extern uint8_t *lwgeom_to_wkb_buffer(const LWGEOM *geom, uint8_t variant);
 extern size_t lwgeom_to_wkb_size(const LWGEOM *geom, uint8_t variant);
 
+/**
+ * Write the WKB of geom into a caller provided buffer, which must be at least
+ * lwgeom_to_wkb_size(geom, variant) bytes long. Returns the number of bytes written.
+ */
+extern ptrdiff_t lwgeom_to_wkb_write_buf(const LWGEOM *geom, uint8_t variant, uint8_t *buffer);
+
 /* Memory management */
 extern void *lwalloc(size_t size);
 extern void *lwrealloc(void *mem, size_t size);
 extern void lwfree(void *mem);
 
+/**
+ * Open/close a per-thread allocation arena. Scopes nest; while one is open,
+ * lwalloc on this thread is served from the arena and everything it handed
+ * out is released by the outermost lwarena_end().
+ */
+extern void lwarena_begin(void);
+extern void lwarena_end(void);
+
+/**
+ * Route lwalloc back to the default allocator until lwarena_resume() is
+ * called with the returned depth, for structures built inside a scope that
+ * have to outlive it. Memory obtained while suspended is freed with lwfree.
+ */
+extern int lwarena_suspend(void);
+extern void lwarena_resume(int depth);
+
+/**
+ * Allocate with the default allocator even inside an arena scope, for memory
+ * that has to outlive it. Free it with lwfree as usual.
+ */
+extern void *lwalloc_persistent(size_t size);
+
 /**
  * Write a notice out to the notice handler.
  *
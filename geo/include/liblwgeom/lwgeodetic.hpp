@@ -103,6 +103,7 @@ int ptarray_contains_point_sphere(const POINTARRAY *pa, const POINT2D *pt_outsid
 int lwpoly_covers_point2d(const LWPOLY *poly, const POINT2D *pt_to_test);
 double latitude_degrees_normalize(double lat);
 double longitude_degrees_normalize(double lon);
+int *lwgeodetic_cluster_kmeans(const POINT2D *points, uint32_t n, uint32_t k, double max_radius);
 
 /*
 ** Prototypes for spheroid functions.
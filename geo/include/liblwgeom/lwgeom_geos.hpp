@@ -44,5 +44,8 @@ GEOSGeometry *make_geos_segment(double x1, double y1, double x2, double y2);
 
 int union_dbscan(LWGEOM **geoms, uint32_t num_geoms, UNIONFIND *uf, double eps, uint32_t min_points,
                  char **is_in_cluster_ret);
+int union_intersecting_pairs(LWGEOM **geoms, uint32_t num_geoms, UNIONFIND *uf);
+int union_dbscan_geodetic(LWGEOM **geoms, uint32_t num_geoms, UNIONFIND *uf, double eps, uint32_t min_points,
+                          char **is_in_cluster_ret, uint32_t num_threads);
 
 } // namespace duckdb
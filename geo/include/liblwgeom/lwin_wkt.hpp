@@ -44,15 +44,14 @@ typedef struct {
 /*
  * Global that holds the final output geometry for the WKT parser.
  */
-extern LWGEOM_PARSER_RESULT global_parser_result;
+extern thread_local LWGEOM_PARSER_RESULT global_parser_result;
 extern const char *parser_error_messages[];
 
 /*
  * Prototypes for the lexer
  */
-extern void wkt_lexer_init(char *str);
-extern void wkt_lexer_close(void);
-extern int wkt_yylex_destroy(void);
+extern void wkt_lexer_init(void **scanner, char *str);
+extern void wkt_lexer_close(void *scanner);
 
 /*
  * Functions called from within the bison parser to construct geometries.
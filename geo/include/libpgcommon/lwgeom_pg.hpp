@@ -35,6 +35,11 @@ GSERIALIZED *geography_serialize(LWGEOM *lwgeom);
  */
 void gserialized_error_if_srid_mismatch(const GSERIALIZED *g1, const GSERIALIZED *g2, const char *funcname);
 
+/**
+ * Compare SRIDs of two LWGEOMs and print informative error message if they differ.
+ */
+void lwgeom_error_if_srid_mismatch(const LWGEOM *g1, const LWGEOM *g2, const char *funcname);
+
 /**
  * Compare SRIDs of GSERIALIZEDs to reference and print informative error message if they differ.
  */
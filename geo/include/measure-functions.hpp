@@ -54,12 +54,24 @@ static const std::vector<ScalarFunctionSet> GetMeasureScalarFunctions(LogicalTyp
 
 	// ST_DISTANCE
 	ScalarFunctionSet distance("st_distance");
-	distance.AddFunction(
-	    ScalarFunction({geo_type, geo_type}, LogicalType::DOUBLE, GeoFunctions::GeometryDistanceFunction));
+	distance.AddFunction(ScalarFunction({geo_type, geo_type}, LogicalType::DOUBLE,
+	                                    GeoFunctions::GeometryDistanceFunction, nullptr, nullptr, nullptr,
+	                                    GeoFunctions::InitCircTreeCacheState));
 	distance.AddFunction(ScalarFunction({geo_type, geo_type, LogicalType::BOOLEAN}, LogicalType::DOUBLE,
-	                                    GeoFunctions::GeometryDistanceFunction));
+	                                    GeoFunctions::GeometryDistanceFunction, nullptr, nullptr, nullptr,
+	                                    GeoFunctions::InitCircTreeCacheState));
 	func_set.push_back(distance);
 
+	// ST_KNN
+	ScalarFunctionSet knn("st_knn");
+	knn.AddFunction(ScalarFunction({geo_type, LogicalType::LIST(geo_type), LogicalType::INTEGER},
+	                               LogicalType::LIST(LogicalType::INTEGER), GeoFunctions::GeometryKNNFunction, nullptr,
+	                               nullptr, nullptr, GeoFunctions::InitKnnIndexState));
+	knn.AddFunction(ScalarFunction({geo_type, LogicalType::LIST(geo_type), LogicalType::INTEGER, LogicalType::BOOLEAN},
+	                               LogicalType::LIST(LogicalType::INTEGER), GeoFunctions::GeometryKNNFunction, nullptr,
+	                               nullptr, nullptr, GeoFunctions::InitKnnIndexState));
+	func_set.push_back(knn);
+
 	// ST_LENGTH
 	ScalarFunctionSet length("st_length");
 	length.AddFunction(ScalarFunction({geo_type}, LogicalType::DOUBLE, GeoFunctions::GeometryLengthFunction));
@@ -69,10 +81,12 @@ static const std::vector<ScalarFunctionSet> GetMeasureScalarFunctions(LogicalTyp
 
 	// ST_MAXDISTANCE
 	ScalarFunctionSet maxdistance("st_maxdistance");
-	maxdistance.AddFunction(
-	    ScalarFunction({geo_type, geo_type}, LogicalType::DOUBLE, GeoFunctions::GeometryMaxDistanceFunction));
+	maxdistance.AddFunction(ScalarFunction({geo_type, geo_type}, LogicalType::DOUBLE,
+	                                       GeoFunctions::GeometryMaxDistanceFunction, nullptr, nullptr, nullptr,
+	                                       GeoFunctions::InitCircTreeCacheState));
 	maxdistance.AddFunction(ScalarFunction({geo_type, geo_type, LogicalType::BOOLEAN}, LogicalType::DOUBLE,
-	                                       GeoFunctions::GeometryMaxDistanceFunction));
+	                                       GeoFunctions::GeometryMaxDistanceFunction, nullptr, nullptr, nullptr,
+	                                       GeoFunctions::InitCircTreeCacheState));
 	func_set.push_back(maxdistance);
 
 	// ST_PERIMETER
@@ -1,15 +1,15 @@
 namespace duckdb {
-/* A Bison parser, made by GNU Bison 2.3.  */
+/* A Bison parser, made by GNU Bison 3.8.2.  */
 
-/* Skeleton interface for Bison's Yacc-like parsers in C
+/* Bison interface for Yacc-like parsers in C
 
-   Copyright (C) 1984, 1989, 1990, 2000, 2001, 2002, 2003, 2004, 2005, 2006
-   Free Software Foundation, Inc.
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
 
-   This program is free software; you can redistribute it and/or modify
+   This program is free software: you can redistribute it and/or modify
    it under the terms of the GNU General Public License as published by
-   the Free Software Foundation; either version 2, or (at your option)
-   any later version.
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
 
    This program is distributed in the hope that it will be useful,
    but WITHOUT ANY WARRANTY; without even the implied warranty of
@@ -17,9 +17,7 @@ namespace duckdb {
    GNU General Public License for more details.
 
    You should have received a copy of the GNU General Public License
-   along with this program; if not, write to the Free Software
-   Foundation, Inc., 51 Franklin Street, Fifth Floor,
-   Boston, MA 02110-1301, USA.  */
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
 
 /* As a special exception, you may create a larger work that contains
    part or all of the Bison parser skeleton and distribute that work
@@ -34,99 +32,97 @@ namespace duckdb {
    This special exception was added by the Free Software Foundation in
    version 2.2 of Bison.  */
 
-/* Tokens.  */
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_WKT_YY_EXTENSION_GEO_INCLUDE_PARSER_LWIN_WKT_PARSE_HPP_INCLUDED
+# define YY_WKT_YY_EXTENSION_GEO_INCLUDE_PARSER_LWIN_WKT_PARSE_HPP_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int wkt_yydebug;
+#endif
+
+/* Token kinds.  */
 #ifndef YYTOKENTYPE
 # define YYTOKENTYPE
-   /* Put the tokens into the symbol table, so that GDB and other debuggers
-      know about them.  */
-   enum yytokentype {
-     POINT_TOK = 258,
-     LINESTRING_TOK = 259,
-     POLYGON_TOK = 260,
-     MPOINT_TOK = 261,
-     MLINESTRING_TOK = 262,
-     MPOLYGON_TOK = 263,
-     MSURFACE_TOK = 264,
-     MCURVE_TOK = 265,
-     CURVEPOLYGON_TOK = 266,
-     COMPOUNDCURVE_TOK = 267,
-     CIRCULARSTRING_TOK = 268,
-     COLLECTION_TOK = 269,
-     RBRACKET_TOK = 270,
-     LBRACKET_TOK = 271,
-     COMMA_TOK = 272,
-     EMPTY_TOK = 273,
-     SEMICOLON_TOK = 274,
-     TRIANGLE_TOK = 275,
-     TIN_TOK = 276,
-     POLYHEDRALSURFACE_TOK = 277,
-     DOUBLE_TOK = 278,
-     DIMENSIONALITY_TOK = 279,
-     SRID_TOK = 280
-   };
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    POINT_TOK = 258,               /* POINT_TOK  */
+    LINESTRING_TOK = 259,          /* LINESTRING_TOK  */
+    POLYGON_TOK = 260,             /* POLYGON_TOK  */
+    MPOINT_TOK = 261,              /* MPOINT_TOK  */
+    MLINESTRING_TOK = 262,         /* MLINESTRING_TOK  */
+    MPOLYGON_TOK = 263,            /* MPOLYGON_TOK  */
+    MSURFACE_TOK = 264,            /* MSURFACE_TOK  */
+    MCURVE_TOK = 265,              /* MCURVE_TOK  */
+    CURVEPOLYGON_TOK = 266,        /* CURVEPOLYGON_TOK  */
+    COMPOUNDCURVE_TOK = 267,       /* COMPOUNDCURVE_TOK  */
+    CIRCULARSTRING_TOK = 268,      /* CIRCULARSTRING_TOK  */
+    COLLECTION_TOK = 269,          /* COLLECTION_TOK  */
+    RBRACKET_TOK = 270,            /* RBRACKET_TOK  */
+    LBRACKET_TOK = 271,            /* LBRACKET_TOK  */
+    COMMA_TOK = 272,               /* COMMA_TOK  */
+    EMPTY_TOK = 273,               /* EMPTY_TOK  */
+    SEMICOLON_TOK = 274,           /* SEMICOLON_TOK  */
+    TRIANGLE_TOK = 275,            /* TRIANGLE_TOK  */
+    TIN_TOK = 276,                 /* TIN_TOK  */
+    POLYHEDRALSURFACE_TOK = 277,   /* POLYHEDRALSURFACE_TOK  */
+    DOUBLE_TOK = 278,              /* DOUBLE_TOK  */
+    DIMENSIONALITY_TOK = 279,      /* DIMENSIONALITY_TOK  */
+    SRID_TOK = 280                 /* SRID_TOK  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
 #endif
-/* Tokens.  */
-#define POINT_TOK 258
-#define LINESTRING_TOK 259
-#define POLYGON_TOK 260
-#define MPOINT_TOK 261
-#define MLINESTRING_TOK 262
-#define MPOLYGON_TOK 263
-#define MSURFACE_TOK 264
-#define MCURVE_TOK 265
-#define CURVEPOLYGON_TOK 266
-#define COMPOUNDCURVE_TOK 267
-#define CIRCULARSTRING_TOK 268
-#define COLLECTION_TOK 269
-#define RBRACKET_TOK 270
-#define LBRACKET_TOK 271
-#define COMMA_TOK 272
-#define EMPTY_TOK 273
-#define SEMICOLON_TOK 274
-#define TRIANGLE_TOK 275
-#define TIN_TOK 276
-#define POLYHEDRALSURFACE_TOK 277
-#define DOUBLE_TOK 278
-#define DIMENSIONALITY_TOK 279
-#define SRID_TOK 280
-
-
-
 
+/* Value type.  */
 #if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
-typedef union YYSTYPE
-#line 105 "extension/geo/parser/lwin_wkt_parse.y"
+union YYSTYPE
 {
+#line 119 "extension/geo/parser/lwin_wkt_parse.y"
+
 	int integervalue;
 	double doublevalue;
 	char *stringvalue;
 	LWGEOM *geometryvalue;
 	POINT coordinatevalue;
 	POINTARRAY *ptarrayvalue;
-}
-/* Line 1529 of yacc.c.  */
-#line 108 "extension/geo/include/parser/lwin_wkt_parse.hpp"
-	YYSTYPE;
-# define yystype YYSTYPE /* obsolescent; will be withdrawn */
-# define YYSTYPE_IS_DECLARED 1
+
+#line 98 "extension/geo/include/parser/lwin_wkt_parse.hpp"
+
+};
+typedef union YYSTYPE YYSTYPE;
 # define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
 #endif
 
-extern YYSTYPE  wkt_yylval;
-
+/* Location type.  */
 #if ! defined YYLTYPE && ! defined YYLTYPE_IS_DECLARED
-typedef struct YYLTYPE
+typedef struct YYLTYPE YYLTYPE;
+struct YYLTYPE
 {
   int first_line;
   int first_column;
   int last_line;
   int last_column;
-} YYLTYPE;
-# define yyltype YYLTYPE /* obsolescent; will be withdrawn */
+};
 # define YYLTYPE_IS_DECLARED 1
 # define YYLTYPE_IS_TRIVIAL 1
 #endif
 
-extern YYLTYPE  wkt_yylloc;
+
+
+
+int wkt_yyparse (void *scanner);
+
+
+#endif /* !YY_WKT_YY_EXTENSION_GEO_INCLUDE_PARSER_LWIN_WKT_PARSE_HPP_INCLUDED  */
 
 } // namespace duckdb
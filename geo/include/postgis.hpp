@@ -9,6 +9,12 @@
 
 namespace duckdb {
 
+struct PrepGeomCache;
+struct CircTreeGeomCache;
+struct CircTreeKnnIndex;
+struct UnionAggState;
+struct ConvexHullAggState;
+
 class Postgis {
 public:
 	Postgis();
@@ -17,15 +23,26 @@ public:
 public:
 	GSERIALIZED *geography_in(char *input);
 	GSERIALIZED *LWGEOM_getGserialized(const void *base, size_t size);
+	LWGEOM *LWGEOM_getLWGeom(const void *base, size_t size);
+	LWGEOM *LWGEOM_getLWGeom(GSERIALIZED *gser);
+	bool LWGEOM_getGBox(const void *base, size_t size, int32_t *srid, GBOX *gbox);
+	bool LWGEOM_getPoint(const void *base, size_t size, int32_t *srid, POINT2D *point);
 	idx_t LWGEOM_size(GSERIALIZED *gser);
+	idx_t LWGEOM_size(LWGEOM *lwgeom);
 	char *LWGEOM_base(GSERIALIZED *gser);
+	idx_t LWGEOM_write(LWGEOM *lwgeom, char *buffer);
 	string LWGEOM_asBinary(const void *data, size_t size);
 	lwvarlena_t *LWGEOM_asBinary(GSERIALIZED *gser, string text = "");
+	lwvarlena_t *LWGEOM_asBinary(LWGEOM *lwgeom, string text = "");
 	string LWGEOM_asText(GSERIALIZED *gser, size_t max_digits = OUT_DEFAULT_DECIMAL_DIGITS);
+	string LWGEOM_asText(LWGEOM *lwgeom, size_t max_digits = OUT_DEFAULT_DECIMAL_DIGITS);
 	lwvarlena_t *LWGEOM_asGeoJson(GSERIALIZED *gser, size_t m_dec_digits = OUT_DEFAULT_DECIMAL_DIGITS);
+	lwvarlena_t *LWGEOM_asGeoJson(LWGEOM *lwgeom, size_t m_dec_digits = OUT_DEFAULT_DECIMAL_DIGITS);
 	string LWGEOM_asGeoJson(const void *data, size_t size);
 	lwvarlena_t *ST_GeoHash(GSERIALIZED *gser, size_t m_chars = 0);
+	lwvarlena_t *ST_GeoHash(LWGEOM *lwgeom, size_t m_chars = 0);
 	void LWGEOM_free(GSERIALIZED *gser);
+	void LWGEOM_free(LWGEOM *lwgeom);
 
 	GSERIALIZED *LWGEOM_makepoint(double x, double y);
 	GSERIALIZED *LWGEOM_makepoint(double x, double y, double z);
@@ -42,9 +59,19 @@ public:
 	GSERIALIZED *LWGEOM_closestpoint(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	GSERIALIZED *ST_Union(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	GSERIALIZED *pgis_union_geometry_array(GSERIALIZED *gserArray[], int nelems);
+	UnionAggState *union_agg_state_create();
+	void union_agg_state_add(UnionAggState *state, const void *base, size_t size);
+	void union_agg_state_combine(UnionAggState *target, const UnionAggState *source);
+	GSERIALIZED *union_agg_state_finalize(UnionAggState *state);
+	void union_agg_state_free(UnionAggState *state);
 	GSERIALIZED *ST_Intersection(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	GSERIALIZED *LWGEOM_simplify2d(GSERIALIZED *geom, double dist);
 	GSERIALIZED *convexhull(GSERIALIZED *geom);
+	ConvexHullAggState *convexhull_agg_state_create();
+	void convexhull_agg_state_add(ConvexHullAggState *state, const void *base, size_t size);
+	void convexhull_agg_state_combine(ConvexHullAggState *target, const ConvexHullAggState *source);
+	GSERIALIZED *convexhull_agg_state_finalize(ConvexHullAggState *state);
+	void convexhull_agg_state_free(ConvexHullAggState *state);
 	GSERIALIZED *LWGEOM_snaptogrid(GSERIALIZED *geom, double size);
 	GSERIALIZED *buffer(GSERIALIZED *geom, double radius, string styles_text = "");
 
@@ -56,43 +83,100 @@ public:
 	bool covers(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	bool coveredby(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	bool disjoint(GSERIALIZED *geom1, GSERIALIZED *geom2);
+	PrepGeomCache *GetPrepGeomCache(const void *base, size_t size);
+	void FreePrepGeomCache(PrepGeomCache *cache);
+	bool contains(PrepGeomCache *cache, int argnum, GSERIALIZED *geom);
+	bool within(PrepGeomCache *cache, int argnum, GSERIALIZED *geom);
+	bool ST_Intersects(PrepGeomCache *cache, GSERIALIZED *geom);
+	bool pip_prepared_batchable(const PrepGeomCache *cache);
+	void pip_prepared_points(const PrepGeomCache *cache, const double *xs, const double *ys, uint32_t n, int *results);
 	bool geography_dwithin(GSERIALIZED *geom1, GSERIALIZED *geom2, double distance, bool use_spheroid);
+	bool geography_dwithin(LWGEOM *lwgeom1, LWGEOM *lwgeom2, double distance, bool use_spheroid);
+	bool geography_dwithin(CircTreeGeomCache *cache, int argnum, LWGEOM *lwgeom, double distance, bool use_spheroid);
+	void geography_dwithin_points(const POINT2D *points1, const POINT2D *points2, const double *distances,
+	                              uint32_t count, int32_t srid, bool use_spheroid, bool *results);
+	uint64_t geography_dwithin_cell(const POINT2D *point, int32_t srid, double distance);
+	void geography_dwithin_cells(const POINT2D *point, int32_t srid, double distance, std::vector<uint64_t> &cells);
+	int geography_dwithin_cells(const LWGEOM *lwgeom, double distance, std::vector<uint64_t> &cells);
 
 	double ST_Area(GSERIALIZED *geom);
 	double geography_area(GSERIALIZED *geom, bool use_spheroid);
+	double geography_area(LWGEOM *lwgeom, bool use_spheroid);
 	double LWGEOM_angle(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	double LWGEOM_angle(std::vector<GSERIALIZED *> geom_vec);
 	double LWGEOM_perimeter2d_poly(GSERIALIZED *geom);
 	double geography_perimeter(GSERIALIZED *geom, bool use_spheroid);
+	double geography_perimeter(LWGEOM *lwgeom, bool use_spheroid);
 	double LWGEOM_azimuth(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	double geography_azimuth(GSERIALIZED *geom1, GSERIALIZED *geom2);
+	double geography_azimuth(LWGEOM *lwgeom1, LWGEOM *lwgeom2);
 	double LWGEOM_length2d_linestring(GSERIALIZED *geom);
 	double geography_length(GSERIALIZED *geom, bool use_spheroid);
+	double geography_length(LWGEOM *lwgeom, bool use_spheroid);
 	GSERIALIZED *LWGEOM_envelope(GSERIALIZED *geom);
 	double LWGEOM_maxdistance2d_linestring(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	double geography_maxdistance(GSERIALIZED *geom1, GSERIALIZED *geom2, bool use_spheroid);
+	double geography_maxdistance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid);
+	double geography_maxdistance(CircTreeGeomCache *cache, int argnum, LWGEOM *lwgeom, bool use_spheroid);
 	GSERIALIZED *LWGEOM_envelope_garray(GSERIALIZED *gserArray[], int nelems);
+	GSERIALIZED *LWGEOM_envelope_gbox(const GBOX *box, int32_t srid);
+	bool LWGEOM_extent_gbox(const void *base, size_t size, int32_t *srid, GBOX *box);
+	bool LWGEOM_hilbert(const void *base, size_t size, const GBOX *extent, uint64_t *key);
+	bool LWGEOM_zorder(const void *base, size_t size, const GBOX *extent, uint64_t *key);
 
-	std::vector<int> ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int nelems, double tolerance, int minpoints);
+	std::vector<int> ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int nelems, double tolerance, int minpoints,
+	                                  int nthreads);
+	std::vector<int> ST_ClusterDBSCAN(LWGEOM *geoms[], int nelems, double tolerance, int minpoints, int nthreads);
+	std::vector<GSERIALIZED *> ST_ClusterWithin(GSERIALIZED *gserArray[], int nelems, double tolerance, int nthreads);
+	bool ST_ClusterKMeansCentre(GSERIALIZED *gser, POINT2D *centre);
+	std::vector<int> ST_ClusterKMeans(const POINT2D *centres, int ncentres, int k, double max_radius);
 
 	int LWGEOM_dimension(GSERIALIZED *geom);
+	int LWGEOM_dimension(LWGEOM *lwgeom);
 	std::vector<GSERIALIZED *> LWGEOM_dump(GSERIALIZED *geom);
+	bool LWGEOM_dump_components(const void *base, size_t size, int32_t *srid, std::vector<WKB_COMPONENT> &components);
+	size_t LWGEOM_dump_component_size(const WKB_COMPONENT &component, int32_t srid);
+	size_t LWGEOM_dump_component_write(const void *base, const WKB_COMPONENT &component, int32_t srid, char *buffer);
 	GSERIALIZED *LWGEOM_endpoint_linestring(GSERIALIZED *geom);
 	std::string geometry_geometrytype(GSERIALIZED *geom);
+	std::string geometry_geometrytype(LWGEOM *lwgeom);
+	std::string geometry_geometrytype(const void *base, size_t size);
 	bool LWGEOM_isclosed(GSERIALIZED *geom);
+	bool LWGEOM_isclosed(LWGEOM *lwgeom);
 	bool ST_IsCollection(GSERIALIZED *geom);
+	bool ST_IsCollection(LWGEOM *lwgeom);
 	bool LWGEOM_isempty(GSERIALIZED *geom);
+	bool LWGEOM_isempty(LWGEOM *lwgeom);
+	bool LWGEOM_isempty(const void *base, size_t size);
 	bool LWGEOM_isring(GSERIALIZED *geom);
 	int LWGEOM_npoints(GSERIALIZED *geom);
+	int LWGEOM_npoints(LWGEOM *lwgeom);
 	int LWGEOM_numgeometries_collection(GSERIALIZED *geom);
+	int LWGEOM_numgeometries_collection(LWGEOM *lwgeom);
+	int LWGEOM_numgeometries_collection(const void *base, size_t size);
 	int LWGEOM_numpoints_linestring(GSERIALIZED *geom);
+	int LWGEOM_numpoints_linestring(LWGEOM *lwgeom);
 	GSERIALIZED *LWGEOM_pointn_linestring(GSERIALIZED *geom, int index);
 	GSERIALIZED *LWGEOM_startpoint_linestring(GSERIALIZED *geom);
 	double LWGEOM_x_point(GSERIALIZED *geom);
+	double LWGEOM_x_point(LWGEOM *lwgeom);
+	double LWGEOM_x_point(const void *base, size_t size);
 	double LWGEOM_y_point(GSERIALIZED *geom);
+	double LWGEOM_y_point(LWGEOM *lwgeom);
+	double LWGEOM_y_point(const void *base, size_t size);
 
 	double ST_distance(GSERIALIZED *geom1, GSERIALIZED *geom2);
 	double geography_distance(GSERIALIZED *geom1, GSERIALIZED *geom2, bool use_spheroid);
+	double geography_distance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid);
+	double geography_distance(CircTreeGeomCache *cache, int argnum, LWGEOM *lwgeom, bool use_spheroid);
+	void geography_distance_points(const POINT2D *points1, const POINT2D *points2, uint32_t count, int32_t srid,
+	                               bool use_spheroid, double *distances);
+	CircTreeGeomCache *GetCircTreeGeomCache(const void *base, size_t size);
+	void FreeCircTreeGeomCache(CircTreeGeomCache *cache);
+	CircTreeKnnIndex *GetCircTreeKnnIndex(const void *const *bases, const size_t *sizes, uint32_t ngeoms);
+	void FreeCircTreeKnnIndex(CircTreeKnnIndex *index);
+	uint32_t geography_knn(const CircTreeKnnIndex *index, const LWGEOM *lwgeom, uint32_t k, bool use_spheroid,
+	                       uint32_t *results);
 	GSERIALIZED *centroid(GSERIALIZED *geom);
 	GSERIALIZED *geography_centroid(GSERIALIZED *geom, bool use_spheroid);
 };
@@ -26,19 +26,41 @@
 #include "duckdb.hpp"
 #include "liblwgeom/liblwgeom.hpp"
 #include "liblwgeom/liblwgeom_internal.hpp"
+#include "liblwgeom/lwgeodetic_tree.hpp"
 
 namespace duckdb {
 
 #ifndef _LIBGEOGRAPHY_MEASUREMENT_H
 #define _LIBGEOGRAPHY_MEASUREMENT_H 1
 
+struct CircTreeKnnIndex;
+
 double geography_distance(GSERIALIZED *geom1, GSERIALIZED *geom2, bool use_spheroid);
+double geography_distance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid, const CIRC_NODE *circ_tree1 = NULL,
+                          const CIRC_NODE *circ_tree2 = NULL);
 double geography_maxdistance(GSERIALIZED *geom1, GSERIALIZED *geom2, bool use_spheroid);
+double geography_maxdistance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid,
+                             const CIRC_NODE *circ_tree1 = NULL, const CIRC_NODE *circ_tree2 = NULL);
 double geography_area(GSERIALIZED *g, bool use_spheroid);
+double geography_area(LWGEOM *lwgeom, bool use_spheroid);
 double geography_perimeter(GSERIALIZED *g, bool use_spheroid);
+double geography_perimeter(LWGEOM *lwgeom, bool use_spheroid);
 double geography_azimuth(GSERIALIZED *g1, GSERIALIZED *g2);
+double geography_azimuth(LWGEOM *lwgeom1, LWGEOM *lwgeom2);
 double geography_length(GSERIALIZED *g, bool use_spheroid);
+double geography_length(LWGEOM *lwgeom, bool use_spheroid);
 bool geography_dwithin(GSERIALIZED *g1, GSERIALIZED *g2, double tolerance, bool use_spheroid);
+bool geography_dwithin(LWGEOM *lwgeom1, LWGEOM *lwgeom2, double tolerance, bool use_spheroid,
+                       const CIRC_NODE *circ_tree1 = NULL, const CIRC_NODE *circ_tree2 = NULL);
+void geography_distance_points(const POINT2D *points1, const POINT2D *points2, uint32_t count, int32_t srid,
+                               bool use_spheroid, double *distances);
+void geography_dwithin_points(const POINT2D *points1, const POINT2D *points2, const double *tolerances,
+                              uint32_t count, int32_t srid, bool use_spheroid, bool *results);
+uint64_t geography_dwithin_cell(const POINT2D *point, int32_t srid, double distance);
+void geography_dwithin_cells(const POINT2D *point, int32_t srid, double distance, std::vector<uint64_t> &cells);
+int geography_dwithin_cells(const LWGEOM *lwgeom, double distance, std::vector<uint64_t> &cells);
+uint32_t geography_knn(const CircTreeKnnIndex *index, const LWGEOM *lwgeom, uint32_t k, bool use_spheroid,
+                       uint32_t *results);
 
 #endif /* !defined _LIBGEOGRAPHY_MEASUREMENT_H  */
 
@@ -26,18 +26,52 @@
 #include "duckdb.hpp"
 #include "liblwgeom/liblwgeom.hpp"
 #include "liblwgeom/liblwgeom_internal.hpp"
+#include "liblwgeom/lwgeodetic_tree.hpp"
 
 namespace duckdb {
 
 #ifndef _LIBGEOGRAPHY_MEASUREMENT_TREES_H
 #define _LIBGEOGRAPHY_MEASUREMENT_TREES_H 1
 
+/*
+ * A geography together with its circ tree, kept across calls so the tree
+ * is built once for an argument that is measured against many others.
+ */
+struct CircTreeGeomCache {
+	LWGEOM *lwgeom;
+	CIRC_NODE *index;
+};
+
+CircTreeGeomCache *GetCircTreeGeomCache(const void *base, size_t size);
+void FreeCircTreeGeomCache(CircTreeGeomCache *cache);
+
+/*
+ * A fixed set of geographies searched for the ones nearest to a probe: the
+ * cached circ tree of every member, and a tree of circles over their roots
+ * whose leaves carry the member position in edge_num.
+ */
+struct CircTreeKnnIndex {
+	uint32_t ngeoms;
+	CircTreeGeomCache **geoms; /* NULL for NULL members */
+	CIRC_NODE *root;           /* NULL when no member is non-empty */
+};
+
+CircTreeKnnIndex *GetCircTreeKnnIndex(const void *const *bases, const size_t *sizes, uint32_t ngeoms);
+void FreeCircTreeKnnIndex(CircTreeKnnIndex *index);
+
 int geography_tree_distance(const GSERIALIZED *g1, const GSERIALIZED *g2, const SPHEROID *s, double tolerance,
                             double *distance);
 
+int geography_tree_distance(const LWGEOM *lwgeom1, const LWGEOM *lwgeom2, const SPHEROID *s, double tolerance,
+                            double *distance, const CIRC_NODE *circ_tree1 = NULL, const CIRC_NODE *circ_tree2 = NULL);
+
 int geography_tree_maxdistance(const GSERIALIZED *g1, const GSERIALIZED *g2, const SPHEROID *s, double tolerance,
                                double *distance);
 
+int geography_tree_maxdistance(const LWGEOM *lwgeom1, const LWGEOM *lwgeom2, const SPHEROID *s, double tolerance,
+                               double *distance, const CIRC_NODE *circ_tree1 = NULL,
+                               const CIRC_NODE *circ_tree2 = NULL);
+
 #endif /* !defined _LIBGEOGRAPHY_MEASUREMENT_TREES_H  */
 
 } // namespace duckdb
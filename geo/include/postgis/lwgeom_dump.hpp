@@ -29,5 +29,8 @@
 namespace duckdb {
 
 std::vector<GSERIALIZED *> LWGEOM_dump(GSERIALIZED *geom);
+bool LWGEOM_dump_components(const void *base, size_t size, int32_t *srid, std::vector<WKB_COMPONENT> &components);
+size_t LWGEOM_dump_component_size(const WKB_COMPONENT &component, int32_t srid);
+size_t LWGEOM_dump_component_write(const void *base, const WKB_COMPONENT &component, int32_t srid, char *buffer);
 
 } // namespace duckdb
@@ -29,5 +29,6 @@
 namespace duckdb {
 
 lwvarlena_t *LWGEOM_asGeoJson(GSERIALIZED *gser, size_t m_dec_digits = OUT_DEFAULT_DECIMAL_DIGITS);
+lwvarlena_t *LWGEOM_asGeoJson(LWGEOM *lwgeom, size_t m_dec_digits = OUT_DEFAULT_DECIMAL_DIGITS);
 
 } // namespace duckdb
@@ -34,4 +34,22 @@ GSERIALIZED *LWGEOM_snaptogrid(GSERIALIZED *geom, double ipx, double ipy, double
 int point_in_polygon(LWPOLY *polygon, LWPOINT *point);
 int point_in_multipolygon(LWMPOLY *mpolygon, LWPOINT *pont);
 
+/*
+ * Point-in-polygon index of one polygon, for a polygon tested against many
+ * points. It points into the rings of the polygon, which must outlive it.
+ */
+struct RING_INDEX;
+typedef struct {
+	uint32_t nrings;
+	RING_INDEX **rings; /* exterior ring first */
+	GBOX box;           /* box of the exterior ring */
+} POLY_INDEX;
+
+POLY_INDEX *poly_index_build(const LWPOLY *poly);
+void poly_index_free(POLY_INDEX *index);
+int point_in_poly_index(const POLY_INDEX *index, const POINT2D *pt);
+int point_in_poly_indexes(POLY_INDEX *const *indexes, uint32_t npolys, const POINT2D *pt);
+void point_in_poly_indexes_batch(POLY_INDEX *const *indexes, uint32_t npolys, const double *xs, const double *ys,
+                                 uint32_t n, int *results);
+
 } // namespace duckdb
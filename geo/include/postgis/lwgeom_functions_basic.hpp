@@ -36,9 +36,14 @@ GSERIALIZED *LWGEOM_makeline_garray(GSERIALIZED *gserArray[], int nelems);
 GSERIALIZED *LWGEOM_makepoly(GSERIALIZED *geom, GSERIALIZED *gserArray[] = {}, int nelems = 0);
 double ST_distance(GSERIALIZED *geom1, GSERIALIZED *geom2);
 lwvarlena_t *ST_GeoHash(GSERIALIZED *gser, size_t m_chars = 0);
+lwvarlena_t *ST_GeoHash(LWGEOM *lwgeom, size_t m_chars = 0);
 bool ST_IsCollection(GSERIALIZED *geom);
+bool ST_IsCollection(LWGEOM *lwgeom);
 bool LWGEOM_isempty(GSERIALIZED *geom);
+bool LWGEOM_isempty(LWGEOM *lwgeom);
+bool LWGEOM_isempty(const void *base, size_t size);
 int LWGEOM_npoints(GSERIALIZED *geom);
+int LWGEOM_npoints(LWGEOM *lwgeom);
 GSERIALIZED *LWGEOM_closestpoint(GSERIALIZED *geom1, GSERIALIZED *geom2);
 double ST_Area(GSERIALIZED *geom);
 double LWGEOM_angle(GSERIALIZED *geom1, GSERIALIZED *geom2);
@@ -47,6 +52,10 @@ double LWGEOM_perimeter2d_poly(GSERIALIZED *geom);
 double LWGEOM_azimuth(GSERIALIZED *geom1, GSERIALIZED *geom2);
 double LWGEOM_length2d_linestring(GSERIALIZED *geom);
 GSERIALIZED *LWGEOM_envelope(GSERIALIZED *geom);
+GSERIALIZED *LWGEOM_envelope_gbox(const GBOX *box, int32_t srid);
+bool LWGEOM_extent_gbox(const void *base, size_t size, int32_t *srid, GBOX *box);
+bool LWGEOM_hilbert(const void *base, size_t size, const GBOX *extent, uint64_t *key);
+bool LWGEOM_zorder(const void *base, size_t size, const GBOX *extent, uint64_t *key);
 double LWGEOM_maxdistance2d_linestring(GSERIALIZED *geom1, GSERIALIZED *geom2);
 GSERIALIZED *LWGEOM_envelope_garray(GSERIALIZED *gserArray[], int nelems);
 
@@ -26,6 +26,8 @@
 #include "duckdb.hpp"
 #include "geos_c.hpp"
 #include "liblwgeom/liblwgeom.hpp"
+#include "postgis/lwgeom_functions_analytic.hpp"
+#include "postgis/lwgeom_rtree.hpp"
 
 namespace duckdb {
 
@@ -34,18 +36,71 @@ GEOSGeometry *POSTGIS2GEOS(const GSERIALIZED *g);
 
 extern void lwgeom_geos_error(const char *fmt, ...);
 
+/*
+ * A geometry tested against many others (typically a constant argument),
+ * decoded once into every form the predicates need. The GEOS form is only
+ * built when a predicate has to fall back to GEOS.
+ *
+ * A multi geometry with many parts also gets an R-tree over the boxes of
+ * its non-empty parts, so ST_Intersects only visits the parts near the
+ * other geometry. Tree item i is parts[i], whose GEOS form is built on
+ * first use as well.
+ *
+ * A (multi)polygon gets a point-in-polygon index per polygon in
+ * pip_indexes, and parts_pip[i] is the one of parts[i].
+ */
+struct PrepGeomCache {
+	LWGEOM *lwgeom;
+	GSERIALIZED *gser;
+	GEOSGeometry *geos;
+	GBOX gbox;
+	int has_gbox;
+	RTREE *parts_tree;
+	LWGEOM **parts;
+	GEOSGeometry **parts_geos;
+	uint32_t *parts_hits;
+	POLY_INDEX **pip_indexes;
+	uint32_t npip_indexes;
+	POLY_INDEX **parts_pip;
+};
+
+PrepGeomCache *GetPrepGeomCache(const void *base, size_t size);
+void FreePrepGeomCache(PrepGeomCache *cache);
+
 GSERIALIZED *centroid(GSERIALIZED *geom);
 bool LWGEOM_isring(GSERIALIZED *geom);
 GSERIALIZED *ST_Difference(GSERIALIZED *geom1, GSERIALIZED *geom2);
 GSERIALIZED *ST_Union(GSERIALIZED *geom1, GSERIALIZED *geom2);
 GSERIALIZED *pgis_union_geometry_array(GSERIALIZED *gserArray[], int nelems);
+
+/* Incremental state of the union aggregate */
+struct UnionAggState;
+UnionAggState *union_agg_state_create(void);
+void union_agg_state_add(UnionAggState *state, const void *base, size_t size);
+void union_agg_state_combine(UnionAggState *target, const UnionAggState *source);
+GSERIALIZED *union_agg_state_finalize(UnionAggState *state);
+void union_agg_state_free(UnionAggState *state);
+
 GSERIALIZED *ST_Intersection(GSERIALIZED *geom1, GSERIALIZED *geom2);
 GSERIALIZED *convexhull(GSERIALIZED *geom);
+
+/* Incremental state of the convex hull aggregate */
+struct ConvexHullAggState;
+ConvexHullAggState *convexhull_agg_state_create(void);
+void convexhull_agg_state_add(ConvexHullAggState *state, const void *base, size_t size);
+void convexhull_agg_state_combine(ConvexHullAggState *target, const ConvexHullAggState *source);
+GSERIALIZED *convexhull_agg_state_finalize(ConvexHullAggState *state);
+void convexhull_agg_state_free(ConvexHullAggState *state);
+
 GSERIALIZED *buffer(GSERIALIZED *geom1, double size, string styles_text = "");
 bool ST_Equals(GSERIALIZED *geom1, GSERIALIZED *geom2);
 bool contains(GSERIALIZED *geom1, GSERIALIZED *geom2);
 bool touches(GSERIALIZED *geom1, GSERIALIZED *geom2);
 bool ST_Intersects(GSERIALIZED *geom1, GSERIALIZED *geom2);
+bool contains_prepared(PrepGeomCache *cache, int argnum, GSERIALIZED *geom);
+bool ST_Intersects_prepared(PrepGeomCache *cache, GSERIALIZED *geom);
+bool pip_prepared_batchable(const PrepGeomCache *cache);
+void pip_prepared_points(const PrepGeomCache *cache, const double *xs, const double *ys, uint32_t n, int *results);
 bool covers(GSERIALIZED *geom1, GSERIALIZED *geom2);
 bool coveredby(GSERIALIZED *geom1, GSERIALIZED *geom2);
 bool disjoint(GSERIALIZED *geom1, GSERIALIZED *geom2);
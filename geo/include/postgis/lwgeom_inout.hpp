@@ -28,14 +28,23 @@
 
 namespace duckdb {
 GSERIALIZED *LWGEOM_getGserialized(const void *base, size_t size);
+LWGEOM *LWGEOM_getLWGeom(const void *base, size_t size);
+LWGEOM *LWGEOM_getLWGeom(GSERIALIZED *gser);
+bool LWGEOM_getGBox(const void *base, size_t size, int32_t *srid, GBOX *gbox);
+bool LWGEOM_getPoint(const void *base, size_t size, int32_t *srid, POINT2D *point);
 
 GSERIALIZED *geom_from_geojson(char *json);
 size_t LWGEOM_size(GSERIALIZED *gser);
+size_t LWGEOM_size(LWGEOM *lwgeom);
 char *LWGEOM_base(GSERIALIZED *gser);
+size_t LWGEOM_write(LWGEOM *lwgeom, char *buffer);
 lwvarlena_t *LWGEOM_asBinary(GSERIALIZED *gser, string text = "");
+lwvarlena_t *LWGEOM_asBinary(LWGEOM *lwgeom, string text = "");
 std::string LWGEOM_asBinary(const void *base, size_t size);
 std::string LWGEOM_asText(GSERIALIZED *gser, size_t max_digits = OUT_DEFAULT_DECIMAL_DIGITS);
+std::string LWGEOM_asText(LWGEOM *lwgeom, size_t max_digits = OUT_DEFAULT_DECIMAL_DIGITS);
 std::string LWGEOM_asGeoJson(const void *base, size_t size);
 void LWGEOM_free(GSERIALIZED *gser);
+void LWGEOM_free(LWGEOM *lwgeom);
 
 } // namespace duckdb
@@ -30,14 +30,25 @@ namespace duckdb {
 
 GSERIALIZED *LWGEOM_boundary(GSERIALIZED *geom);
 int LWGEOM_dimension(GSERIALIZED *geom);
+int LWGEOM_dimension(LWGEOM *lwgeom);
 GSERIALIZED *LWGEOM_endpoint_linestring(GSERIALIZED *geom);
 std::string geometry_geometrytype(GSERIALIZED *geom);
+std::string geometry_geometrytype(LWGEOM *lwgeom);
+std::string geometry_geometrytype(const void *base, size_t size);
 bool LWGEOM_isclosed(GSERIALIZED *geom);
+bool LWGEOM_isclosed(LWGEOM *lwgeom);
 int LWGEOM_numgeometries_collection(GSERIALIZED *geom);
+int LWGEOM_numgeometries_collection(LWGEOM *lwgeom);
+int LWGEOM_numgeometries_collection(const void *base, size_t size);
 int LWGEOM_numpoints_linestring(GSERIALIZED *geom);
+int LWGEOM_numpoints_linestring(LWGEOM *lwgeom);
 GSERIALIZED *LWGEOM_pointn_linestring(GSERIALIZED *geom, int where);
 GSERIALIZED *LWGEOM_startpoint_linestring(GSERIALIZED *geom);
 double LWGEOM_x_point(GSERIALIZED *geom);
+double LWGEOM_x_point(LWGEOM *lwgeom);
+double LWGEOM_x_point(const void *base, size_t size);
 double LWGEOM_y_point(GSERIALIZED *geom);
+double LWGEOM_y_point(LWGEOM *lwgeom);
+double LWGEOM_y_point(const void *base, size_t size);
 
 } // namespace duckdb
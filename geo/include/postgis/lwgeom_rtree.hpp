@@ -0,0 +1,57 @@
+/**********************************************************************
+ *
+ * PostGIS - Spatial Types for PostgreSQL
+ * http://postgis.net
+ *
+ * PostGIS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * PostGIS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PostGIS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **********************************************************************/
+
+#pragma once
+#include "liblwgeom/liblwgeom.hpp"
+
+namespace duckdb {
+
+#ifndef _LWGEOM_RTREE_H
+#define _LWGEOM_RTREE_H 1
+
+#define RTREE_NODE_CAPACITY 16
+
+/*
+ * A static R-tree over the 2D boxes of a fixed set of items, packed bottom
+ * up: the items are sorted along a Hilbert curve through their box centres
+ * and cut into full leaves, and every level above is packed the same way
+ * over the level below. The nodes of all levels live in one array, leaf
+ * level first.
+ */
+typedef struct {
+	uint32_t nitems;
+	uint32_t *items;     /* item numbers, in Hilbert order */
+	GBOX *item_boxes;    /* box of each entry of items */
+	uint32_t nlevels;
+	uint32_t *level_offsets; /* first node of each level, level_offsets[nlevels] is the node count */
+	GBOX *nodes;
+} RTREE;
+
+/* Build a tree over nboxes boxes, item i being boxes[i] */
+RTREE *rtree_build(const GBOX *boxes, uint32_t nboxes);
+
+/* Write the items whose box overlaps box to hits, which has room for all items. Returns their number. */
+uint32_t rtree_query(const RTREE *tree, const GBOX *box, uint32_t *hits);
+
+void rtree_free(RTREE *tree);
+
+#endif /* !defined _LWGEOM_RTREE_H */
+
+} // namespace duckdb
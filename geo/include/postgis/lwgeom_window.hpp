@@ -29,6 +29,10 @@
 
 namespace duckdb {
 
-std::vector<int> ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int nelems, double tolerance, int minpoints);
+std::vector<int> ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int nelems, double tolerance, int minpoints, int nthreads);
+std::vector<int> ST_ClusterDBSCAN(LWGEOM *geoms[], int nelems, double tolerance, int minpoints, int nthreads);
+std::vector<GSERIALIZED *> ST_ClusterWithin(GSERIALIZED *gserArray[], int nelems, double tolerance, int nthreads);
+bool ST_ClusterKMeansCentre(GSERIALIZED *gser, POINT2D *centre);
+std::vector<int> ST_ClusterKMeans(const POINT2D *centres, int ncentres, int k, double max_radius);
 
 } // namespace duckdb
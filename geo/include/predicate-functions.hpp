@@ -17,8 +17,9 @@ static const std::vector<ScalarFunctionSet> GetPredicateScalarFunctions(LogicalT
 
 	// ST_CONTAINS
 	ScalarFunctionSet contains("st_contains");
-	contains.AddFunction(
-	    ScalarFunction({geo_type, geo_type}, LogicalType::BOOLEAN, GeoFunctions::GeometryContainsFunction));
+	contains.AddFunction(ScalarFunction({geo_type, geo_type}, LogicalType::BOOLEAN,
+	                                    GeoFunctions::GeometryContainsFunction, nullptr, nullptr, nullptr,
+	                                    GeoFunctions::InitPreparedGeometryState));
 	func_set.push_back(contains);
 
 	// ST_COVEREDBY
@@ -42,11 +43,24 @@ static const std::vector<ScalarFunctionSet> GetPredicateScalarFunctions(LogicalT
 	// ST_DWITHIN
 	ScalarFunctionSet dwithin("st_dwithin");
 	dwithin.AddFunction(ScalarFunction({geo_type, geo_type, LogicalType::DOUBLE}, LogicalType::BOOLEAN,
-	                                   GeoFunctions::GeometryDWithinFunction));
+	                                   GeoFunctions::GeometryDWithinFunction, nullptr, nullptr, nullptr,
+	                                   GeoFunctions::InitCircTreeCacheState));
 	dwithin.AddFunction(ScalarFunction({geo_type, geo_type, LogicalType::DOUBLE, LogicalType::BOOLEAN},
 	                                   LogicalType::DOUBLE, GeoFunctions::GeometryLengthFunction));
 	func_set.push_back(dwithin);
 
+	// ST_DWITHIN_CELL
+	ScalarFunctionSet dwithin_cell("st_dwithin_cell");
+	dwithin_cell.AddFunction(ScalarFunction({geo_type, LogicalType::DOUBLE}, LogicalType::UBIGINT,
+	                                        GeoFunctions::GeometryDWithinCellFunction));
+	func_set.push_back(dwithin_cell);
+
+	// ST_DWITHIN_CELLS
+	ScalarFunctionSet dwithin_cells("st_dwithin_cells");
+	dwithin_cells.AddFunction(ScalarFunction({geo_type, LogicalType::DOUBLE}, LogicalType::LIST(LogicalType::UBIGINT),
+	                                         GeoFunctions::GeometryDWithinCellsFunction));
+	func_set.push_back(dwithin_cells);
+
 	// ST_EQUALS
 	ScalarFunctionSet equals("st_equals");
 	equals.AddFunction(
@@ -55,8 +69,9 @@ static const std::vector<ScalarFunctionSet> GetPredicateScalarFunctions(LogicalT
 
 	// ST_INTERSECTS
 	ScalarFunctionSet intersects("st_intersects");
-	intersects.AddFunction(
-	    ScalarFunction({geo_type, geo_type}, LogicalType::BOOLEAN, GeoFunctions::GeometryIntersectsFunction));
+	intersects.AddFunction(ScalarFunction({geo_type, geo_type}, LogicalType::BOOLEAN,
+	                                      GeoFunctions::GeometryIntersectsFunction, nullptr, nullptr, nullptr,
+	                                      GeoFunctions::InitPreparedGeometryState));
 	func_set.push_back(intersects);
 
 	// ST_TOUCHES
@@ -67,8 +82,9 @@ static const std::vector<ScalarFunctionSet> GetPredicateScalarFunctions(LogicalT
 
 	// ST_WITHIN
 	ScalarFunctionSet within("st_within");
-	within.AddFunction(
-	    ScalarFunction({geo_type, geo_type}, LogicalType::BOOLEAN, GeoFunctions::GeometryWithinFunction));
+	within.AddFunction(ScalarFunction({geo_type, geo_type}, LogicalType::BOOLEAN,
+	                                  GeoFunctions::GeometryWithinFunction, nullptr, nullptr, nullptr,
+	                                  GeoFunctions::InitPreparedGeometryState));
 	func_set.push_back(within);
 
 	return func_set;
@@ -108,6 +108,12 @@ void gserialized_error_if_srid_mismatch(const GSERIALIZED *g1, const GSERIALIZED
 		        lwtype_name(gserialized1_get_type(g1)), srid1, lwtype_name(gserialized_get_type(g2)), srid2);
 }
 
+void lwgeom_error_if_srid_mismatch(const LWGEOM *g1, const LWGEOM *g2, const char *funcname) {
+	if (g1->srid != g2->srid)
+		lwerror("%s: Operation on mixed SRID geometries (%s, %d) != (%s, %d)", funcname, lwtype_name(g1->type),
+		        g1->srid, lwtype_name(g2->type), g2->srid);
+}
+
 void gserialized_error_if_srid_mismatch_reference(const GSERIALIZED *g1, const int32_t srid2, const char *funcname) {
 	int32_t srid1 = gserialized_get_srid(g1);
 	if (srid1 != srid2) {
@@ -215,6 +215,50 @@ unsigned int geohash_point_as_int(POINT2D *pt) {
 	return ch;
 }
 
+/*
+** Position of a cell of the 2^32 x 2^32 grid along the Hilbert curve,
+** walking down the quadrants from the top bit and rotating each one so the
+** curve stays continuous.
+*/
+uint64_t hilbert_point_as_int(uint32_t x, uint32_t y) {
+	uint32_t rx, ry, s, t;
+	uint64_t d = 0;
+
+	for (s = 0x80000000u; s > 0; s >>= 1) {
+		rx = (x & s) > 0;
+		ry = (y & s) > 0;
+		d += (uint64_t)s * s * ((3 * rx) ^ ry);
+		if (ry == 0) {
+			if (rx == 1) {
+				x = UINT32_MAX - x;
+				y = UINT32_MAX - y;
+			}
+			t = x;
+			x = y;
+			y = t;
+		}
+	}
+	return d;
+}
+
+/*
+** Position of a cell of the 2^32 x 2^32 grid along the Z-order (Morton)
+** curve: the bits of x and y interleaved, x taking the even bits.
+*/
+static uint64_t morton_spread_bits(uint32_t v) {
+	uint64_t x = v;
+	x = (x | (x << 16)) & 0x0000FFFF0000FFFFull;
+	x = (x | (x << 8)) & 0x00FF00FF00FF00FFull;
+	x = (x | (x << 4)) & 0x0F0F0F0F0F0F0F0Full;
+	x = (x | (x << 2)) & 0x3333333333333333ull;
+	x = (x | (x << 1)) & 0x5555555555555555ull;
+	return x;
+}
+
+uint64_t morton_point_as_int(uint32_t x, uint32_t y) {
+	return morton_spread_bits(x) | (morton_spread_bits(y) << 1);
+}
+
 static char const *base32 = "0123456789bcdefghjkmnpqrstuvwxyz";
 
 /*
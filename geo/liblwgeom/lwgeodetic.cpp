@@ -1592,7 +1592,6 @@ static double ptarray_distance_spheroid(const POINTARRAY *pa1, const POINTARRAY
 		/* Copy end to start to allow a new end value in next iteration */
 		e1.start = e1.end;
 		A1 = A2;
-		return -1.0;
 	}
 
 	if (use_sphere)
@@ -1841,6 +1840,40 @@ int lwpoly_covers_point2d(const LWPOLY *poly, const POINT2D *pt_to_test) {
 	return LW_TRUE;
 }
 
+/**
+ * Calculate the distances between count pairs of longitude/latitude points,
+ * p1[i] to p2[i], into distances[i]. This is the point/point case of
+ * ptarray_distance_spheroid run over flat arrays: the sphere distance of
+ * every pair is computed in one branch free pass, and only the pairs not
+ * already settled by it go through the spheroid calculation. When
+ * tolerances is NULL every pair gets its spheroid distance, as the tree
+ * distance does.
+ */
+void lwpoints_distance_spheroid(const POINT2D *p1, const POINT2D *p2, uint32_t count, const SPHEROID *s,
+                                const double *tolerances, double *distances) {
+	GEOGRAPHIC_POINT g1, g2;
+	uint32_t i;
+
+	for (i = 0; i < count; i++) {
+		geographic_point_init(p1[i].x, p1[i].y, &g1);
+		geographic_point_init(p2[i].x, p2[i].y, &g2);
+		distances[i] = s->radius * sphere_distance(&g1, &g2);
+	}
+
+	/* Sphere special case, axes equal */
+	if (s->a == s->b)
+		return;
+
+	for (i = 0; i < count; i++) {
+		/* Below tolerance, actual distance isn't of interest */
+		if (tolerances && distances[i] < 0.95 * tolerances[i])
+			continue;
+		geographic_point_init(p1[i].x, p1[i].y, &g1);
+		geographic_point_init(p2[i].x, p2[i].y, &g2);
+		distances[i] = spheroid_distance(&g1, &g2, s);
+	}
+}
+
 /**
  * Calculate the distance between two LWGEOMs, using the coordinates are
  * longitude and latitude. Return immediately when the calculated distance drops
@@ -358,6 +358,41 @@ static CIRC_NODE *circ_nodes_merge(CIRC_NODE **nodes, int num_nodes) {
 	return nodes[0];
 }
 
+/**
+ * Build a tree over the root nodes of a set of trees, for searches that run
+ * across many geometries. The roots stay with the caller: the leaves of the
+ * new tree are copies of their circles, with edge_num set to the position of
+ * the root in the input. NULL roots are skipped, and NULL is returned when
+ * all of them are.
+ */
+CIRC_NODE *circ_tree_new_forest(CIRC_NODE *const *roots, uint32_t num_roots) {
+	CIRC_NODE **nodes;
+	CIRC_NODE *node;
+	uint32_t i, j = 0;
+
+	nodes = (CIRC_NODE **)lwalloc(sizeof(CIRC_NODE *) * (num_roots ? num_roots : 1));
+	for (i = 0; i < num_roots; i++) {
+		if (!roots[i])
+			continue;
+		node = (CIRC_NODE *)lwalloc(sizeof(CIRC_NODE));
+		*node = *(roots[i]);
+		node->num_nodes = 0;
+		node->nodes = NULL;
+		node->edge_num = (int)i;
+		node->p1 = node->p2 = NULL;
+		nodes[j++] = node;
+	}
+	if (!j) {
+		lwfree(nodes);
+		return NULL;
+	}
+
+	circ_nodes_sort(nodes, j);
+	node = circ_nodes_merge(nodes, j);
+	lwfree(nodes);
+	return node;
+}
+
 /**
  * Build a tree of nodes from a point array, one node per edge.
  */
@@ -499,7 +534,7 @@ CIRC_NODE *lwgeom_calculate_circ_tree(const LWGEOM *lwgeom) {
 	}
 }
 
-static double circ_node_min_distance(const CIRC_NODE *n1, const CIRC_NODE *n2) {
+double circ_node_min_distance(const CIRC_NODE *n1, const CIRC_NODE *n2) {
 	double d = sphere_distance(&(n1->center), &(n2->center));
 	double r1 = n1->radius;
 	double r2 = n2->radius;
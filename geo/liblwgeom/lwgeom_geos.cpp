@@ -38,7 +38,8 @@ namespace duckdb {
 
 #define AUTOFIX                    LW_TRUE
 #define LWGEOM_GEOS_ERRMSG_MAXSIZE 256
-char lwgeom_geos_errmsg[LWGEOM_GEOS_ERRMSG_MAXSIZE];
+/* Per thread, since GEOS reports errors through the calling thread's context */
+thread_local char lwgeom_geos_errmsg[LWGEOM_GEOS_ERRMSG_MAXSIZE];
 
 extern void lwgeom_geos_error(const char *fmt, ...) {
 	va_list ap;
@@ -24,11 +24,20 @@
 
 #include "liblwgeom/liblwgeom.hpp"
 #include "liblwgeom/liblwgeom_internal.hpp"
+#include "liblwgeom/lwgeodetic.hpp"
 #include "liblwgeom/lwgeom_geos.hpp"
 #include "liblwgeom/lwinline.hpp"
 #include "liblwgeom/lwunionfind.hpp"
 
+#include <atomic>
+#include <exception>
+#include <math.h>
+#include <memory>
+#include <stdlib.h>
 #include <string.h>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace duckdb {
 
@@ -232,6 +241,84 @@ static int union_dbscan_minpoints_1(LWGEOM **geoms, uint32_t num_geoms, UNIONFIN
 	return success;
 }
 
+/*
+ * Union the components of every pair of geometries that intersect. Candidate
+ * pairs come from an STRtree over the geometries, and a pair whose members
+ * already share a component is not tested, so every geometry joins a large
+ * component through a handful of GEOS calls. Empty geometries stay alone.
+ */
+int union_intersecting_pairs(LWGEOM **geoms, uint32_t num_geoms, UNIONFIND *uf) {
+	uint32_t p, i;
+	struct STRTree tree;
+	struct QueryContext cxt = {.items_found = NULL, .num_items_found = 0, .items_found_size = 0};
+	GEOSGeometry **geos_geoms;
+	int success = LW_SUCCESS;
+
+	if (num_geoms <= 1)
+		return LW_SUCCESS;
+
+	geos_geoms = (GEOSGeometry **)lwalloc(num_geoms * sizeof(GEOSGeometry *));
+	for (p = 0; p < num_geoms; p++) {
+		geos_geoms[p] = LWGEOM2GEOS(geoms[p], 0);
+		if (!geos_geoms[p]) {
+			for (i = 0; i < p; i++)
+				GEOSGeom_destroy(geos_geoms[i]);
+			lwfree(geos_geoms);
+			return LW_FAILURE;
+		}
+	}
+
+	tree = make_strtree((void **)geos_geoms, num_geoms, LW_FALSE);
+	if (tree.tree == NULL) {
+		destroy_strtree(&tree);
+		for (p = 0; p < num_geoms; p++)
+			GEOSGeom_destroy(geos_geoms[p]);
+		lwfree(geos_geoms);
+		return LW_FAILURE;
+	}
+
+	for (p = 0; p < num_geoms && success == LW_SUCCESS; p++) {
+		if (lwgeom_is_empty(geoms[p]))
+			continue;
+
+		cxt.num_items_found = 0;
+		GEOSSTRtree_query(tree.tree, geos_geoms[p], &query_accumulate, &cxt);
+		for (i = 0; i < cxt.num_items_found; i++) {
+			uint32_t q = *((uint32_t *)cxt.items_found[i]);
+			char result;
+
+			/* Each pair is seen from both sides, test it from the lower one */
+			if (q <= p || UF_find(uf, p) == UF_find(uf, q))
+				continue;
+
+			if (geoms[p]->type == POINTTYPE && geoms[q]->type == POINTTYPE) {
+				const POINT2D *pt1 = getPoint2d_cp(lwgeom_as_lwpoint(geoms[p])->point, 0);
+				const POINT2D *pt2 = getPoint2d_cp(lwgeom_as_lwpoint(geoms[q])->point, 0);
+				result = pt1->x == pt2->x && pt1->y == pt2->y;
+			} else {
+				result = GEOSIntersects(geos_geoms[p], geos_geoms[q]);
+			}
+
+			if (result == 2) {
+				success = LW_FAILURE;
+				break;
+			}
+			if (result)
+				UF_union(uf, p, q);
+		}
+	}
+
+	if (cxt.items_found)
+		lwfree(cxt.items_found);
+
+	destroy_strtree(&tree);
+	for (p = 0; p < num_geoms; p++)
+		GEOSGeom_destroy(geos_geoms[p]);
+	lwfree(geos_geoms);
+
+	return success;
+}
+
 static int union_dbscan_general(LWGEOM **geoms, uint32_t num_geoms, UNIONFIND *uf, double eps, uint32_t min_points,
                                 char **in_a_cluster_ret) {
 	uint32_t p, i;
@@ -355,4 +442,364 @@ int union_dbscan(LWGEOM **geoms, uint32_t num_geoms, UNIONFIND *uf, double eps,
 		return union_dbscan_general(geoms, num_geoms, uf, eps, min_points, in_a_cluster_ret);
 }
 
+/* Rows a thread takes at a time, and the fewest geometries worth a thread of their own */
+static const uint32_t GEODETIC_DBSCAN_BLOCK_SIZE = 64;
+static const uint32_t GEODETIC_DBSCAN_MIN_GEOMS_PER_THREAD = 256;
+
+/* Pairs of geometries within eps of each other, each pair once and lower id first */
+typedef std::vector<std::pair<uint32_t, uint32_t>> GEODETIC_DBSCAN_PAIRS;
+
+/*
+ * Call fn(thread, begin, end) over blocks of [0, num_items) on num_threads
+ * threads, the calling one included. Threads take the next block as they
+ * finish one, so uneven blocks even out. An error raised on any thread is
+ * raised again on the calling thread once all of them are done.
+ */
+template <class FN>
+static void geodetic_dbscan_parallel(uint32_t num_threads, uint32_t num_items, FN fn) {
+	std::atomic<uint32_t> next_block(0);
+	std::vector<std::exception_ptr> errors(num_threads);
+	std::vector<std::thread> workers;
+	uint32_t t;
+
+	auto work = [&](uint32_t thread) {
+		try {
+			uint32_t begin;
+			while ((begin = next_block.fetch_add(GEODETIC_DBSCAN_BLOCK_SIZE)) < num_items)
+				fn(thread, begin, FP_MIN(begin + GEODETIC_DBSCAN_BLOCK_SIZE, num_items));
+		} catch (...) {
+			errors[thread] = std::current_exception();
+			next_block = num_items;
+		}
+	};
+	for (t = 1; t < num_threads; t++)
+		workers.emplace_back(work, t);
+	work(0);
+	for (auto &worker : workers)
+		worker.join();
+	for (auto &error : errors) {
+		if (error)
+			std::rethrow_exception(error);
+	}
+}
+
+/* A point on the unit sphere and the grid cell it falls in */
+typedef struct {
+	POINT3D p;
+	int64_t cell[3];
+	uint32_t id;
+} GEODETIC_DBSCAN_POINT;
+
+static int geodetic_dbscan_cell_cmp(const int64_t *a, const int64_t *b) {
+	int i;
+	for (i = 0; i < 3; i++) {
+		if (a[i] != b[i])
+			return a[i] < b[i] ? -1 : 1;
+	}
+	return 0;
+}
+
+static int geodetic_dbscan_point_cmp(const void *a, const void *b) {
+	const GEODETIC_DBSCAN_POINT *pa = (const GEODETIC_DBSCAN_POINT *)a;
+	const GEODETIC_DBSCAN_POINT *pb = (const GEODETIC_DBSCAN_POINT *)b;
+	int cmp = geodetic_dbscan_cell_cmp(pa->cell, pb->cell);
+	if (cmp != 0)
+		return cmp;
+	return pa->id < pb->id ? -1 : (pa->id > pb->id ? 1 : 0);
+}
+
+/* Points are kept sorted by cell, this finds where the points of a cell start */
+static uint32_t geodetic_dbscan_cell_start(const GEODETIC_DBSCAN_POINT *sorted, uint32_t num_points,
+                                           const int64_t *cell) {
+	uint32_t lo = 0, hi = num_points;
+	while (lo < hi) {
+		uint32_t mid = lo + (hi - lo) / 2;
+		if (geodetic_dbscan_cell_cmp(sorted[mid].cell, cell) < 0)
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+	return lo;
+}
+
+/*
+ * Add the points with a higher id than p within the chord distance
+ * max_chord2 (squared) of p to pairs. Points that close lie in the cell of p
+ * or in one of the 26 around it.
+ */
+static void geodetic_dbscan_point_neighbors(const GEODETIC_DBSCAN_POINT *sorted, uint32_t num_points,
+                                            const GEODETIC_DBSCAN_POINT *p, double max_chord2,
+                                            GEODETIC_DBSCAN_PAIRS &pairs) {
+	int64_t cell[3];
+	int dx, dy, dz;
+
+	for (dx = -1; dx <= 1; dx++) {
+		for (dy = -1; dy <= 1; dy++) {
+			for (dz = -1; dz <= 1; dz++) {
+				uint32_t i;
+				cell[0] = p->cell[0] + dx;
+				cell[1] = p->cell[1] + dy;
+				cell[2] = p->cell[2] + dz;
+				for (i = geodetic_dbscan_cell_start(sorted, num_points, cell);
+				     i < num_points && geodetic_dbscan_cell_cmp(sorted[i].cell, cell) == 0; i++) {
+					double ddx = sorted[i].p.x - p->p.x;
+					double ddy = sorted[i].p.y - p->p.y;
+					double ddz = sorted[i].p.z - p->p.z;
+					if (sorted[i].id <= p->id || ddx * ddx + ddy * ddy + ddz * ddz > max_chord2)
+						continue;
+					pairs.emplace_back(p->id, sorted[i].id);
+				}
+			}
+		}
+	}
+}
+
+/*
+ * Pairs of points within the chord max_chord. The points go onto the unit
+ * sphere and into a grid of cubes as wide as the chord, so the neighbours of
+ * a point are found among the points of 27 cells, and the chord comparison is
+ * the exact spherical distance test.
+ */
+static void geodetic_dbscan_point_pairs(LWGEOM **geoms, uint32_t num_geoms, double max_chord, uint32_t num_threads,
+                                        std::vector<GEODETIC_DBSCAN_PAIRS> &pairs) {
+	GEODETIC_DBSCAN_POINT *sorted, **by_id;
+	double max_chord2 = max_chord * max_chord;
+	double cell_size = FP_MAX(max_chord, 1e-12);
+	uint32_t i;
+
+	sorted = (GEODETIC_DBSCAN_POINT *)lwalloc(num_geoms * sizeof(GEODETIC_DBSCAN_POINT));
+	for (i = 0; i < num_geoms; i++) {
+		ll2cart(getPoint2d_cp(lwgeom_as_lwpoint(geoms[i])->point, 0), &sorted[i].p);
+		sorted[i].cell[0] = (int64_t)floor(sorted[i].p.x / cell_size);
+		sorted[i].cell[1] = (int64_t)floor(sorted[i].p.y / cell_size);
+		sorted[i].cell[2] = (int64_t)floor(sorted[i].p.z / cell_size);
+		sorted[i].id = i;
+	}
+	qsort(sorted, num_geoms, sizeof(GEODETIC_DBSCAN_POINT), geodetic_dbscan_point_cmp);
+	by_id = (GEODETIC_DBSCAN_POINT **)lwalloc(num_geoms * sizeof(GEODETIC_DBSCAN_POINT *));
+	for (i = 0; i < num_geoms; i++)
+		by_id[sorted[i].id] = &sorted[i];
+
+	geodetic_dbscan_parallel(num_threads, num_geoms, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+		for (uint32_t p = begin; p < end; p++)
+			geodetic_dbscan_point_neighbors(sorted, num_geoms, by_id[p], max_chord2, pairs[thread]);
+	});
+
+	lwfree(by_id);
+	lwfree(sorted);
+}
+
+/* The geocentric box of a geometry and the geometry it belongs to */
+typedef struct {
+	GBOX box;
+	uint32_t id;
+} GEODETIC_DBSCAN_BOX;
+
+static int geodetic_dbscan_box_cmp(const void *a, const void *b) {
+	const GEODETIC_DBSCAN_BOX *ba = (const GEODETIC_DBSCAN_BOX *)a;
+	const GEODETIC_DBSCAN_BOX *bb = (const GEODETIC_DBSCAN_BOX *)b;
+	if (ba->box.xmin != bb->box.xmin)
+		return ba->box.xmin < bb->box.xmin ? -1 : 1;
+	return ba->id < bb->id ? -1 : (ba->id > bb->id ? 1 : 0);
+}
+
+/*
+ * Pairs of geometries within eps, measured on the unit sphere. Two
+ * geometries that close have geocentric boxes within the chord of eps of
+ * each other, so the boxes are swept in the order of their lowest x and only
+ * the pairs whose boxes come that close are measured.
+ */
+static void geodetic_dbscan_geometry_pairs(LWGEOM **geoms, uint32_t num_geoms, double eps, double max_chord,
+                                           uint32_t num_threads, std::vector<GEODETIC_DBSCAN_PAIRS> &pairs) {
+	GEODETIC_DBSCAN_BOX *sorted;
+	SPHEROID sphere;
+	uint32_t num_boxes = 0;
+	uint32_t i;
+
+	spheroid_init(&sphere, 1.0, 1.0);
+
+	sorted = (GEODETIC_DBSCAN_BOX *)lwalloc(num_geoms * sizeof(GEODETIC_DBSCAN_BOX));
+	for (i = 0; i < num_geoms; i++) {
+		if (lwgeom_is_empty(geoms[i]))
+			continue;
+		if (geoms[i]->bbox && FLAGS_GET_GEODETIC(geoms[i]->bbox->flags))
+			sorted[num_boxes].box = *geoms[i]->bbox;
+		else if (lwgeom_calculate_gbox_geodetic(geoms[i], &sorted[num_boxes].box) == LW_FAILURE)
+			continue;
+		sorted[num_boxes].id = i;
+		num_boxes++;
+	}
+	qsort(sorted, num_boxes, sizeof(GEODETIC_DBSCAN_BOX), geodetic_dbscan_box_cmp);
+
+	geodetic_dbscan_parallel(num_threads, num_boxes, [&](uint32_t thread, uint32_t begin, uint32_t end) {
+		for (uint32_t a = begin; a < end; a++) {
+			const GBOX &box = sorted[a].box;
+			for (uint32_t b = a + 1; b < num_boxes && sorted[b].box.xmin <= box.xmax + max_chord; b++) {
+				const GBOX &other = sorted[b].box;
+				if (other.ymin > box.ymax + max_chord || other.ymax < box.ymin - max_chord ||
+				    other.zmin > box.zmax + max_chord || other.zmax < box.zmin - max_chord)
+					continue;
+
+				uint32_t p = sorted[a].id;
+				uint32_t q = sorted[b].id;
+				double distance = lwgeom_distance_spheroid(geoms[p], geoms[q], &sphere, eps);
+				if (distance < 0 || distance > eps)
+					continue;
+				pairs[thread].emplace_back(FP_MIN(p, q), FP_MAX(p, q));
+			}
+		}
+	});
+
+	lwfree(sorted);
+}
+
+/* Root of i in a union-find whose links are only ever pointed at a lower id */
+static uint32_t geodetic_dbscan_find(std::atomic<uint32_t> *parents, uint32_t i) {
+	uint32_t parent = parents[i].load();
+	while (parent != i) {
+		/* Halve the path on the way, another thread may have done so already */
+		uint32_t grandparent = parents[parent].load();
+		if (grandparent != parent)
+			parents[i].compare_exchange_weak(parent, grandparent);
+		i = parent;
+		parent = parents[i].load();
+	}
+	return i;
+}
+
+/*
+ * Join the trees of i and j, from any number of threads at once. The root
+ * with the higher id goes under the other, so every cluster ends up rooted at
+ * its lowest id whatever order the unions come in.
+ */
+static void geodetic_dbscan_union(std::atomic<uint32_t> *parents, uint32_t i, uint32_t j) {
+	while (true) {
+		i = geodetic_dbscan_find(parents, i);
+		j = geodetic_dbscan_find(parents, j);
+		if (i == j)
+			return;
+		if (i < j) {
+			uint32_t swap = i;
+			i = j;
+			j = swap;
+		}
+		/* Only link i while it is still a root, else find the roots again */
+		uint32_t expected = i;
+		if (parents[i].compare_exchange_strong(expected, j))
+			return;
+	}
+}
+
+/* Lower the border link of i to core point core, unless it has a lower one already */
+static void geodetic_dbscan_border(std::atomic<uint32_t> *borders, uint32_t i, uint32_t core) {
+	uint32_t current = borders[i].load();
+	while (core < current && !borders[i].compare_exchange_weak(current, core)) {
+	}
+}
+
+/*
+ * DBSCAN over geographies, with eps the great circle distance in radians.
+ * Point clouds are matched on a grid on the unit sphere, anything else by
+ * sweeping geocentric boxes and measuring the distance on the unit sphere.
+ *
+ * The neighbour pairs are found on num_threads threads, and clusters are
+ * formed from them through a lock-free union-find on as many. Core points
+ * within eps of each other share a cluster, and a border point joins the
+ * cluster of its lowest core neighbour, so the clusters come out the same
+ * for any thread count. Clusters are handed back through uf, with the same
+ * contract as union_dbscan.
+ */
+int union_dbscan_geodetic(LWGEOM **geoms, uint32_t num_geoms, UNIONFIND *uf, double eps, uint32_t min_points,
+                          char **in_a_cluster_ret, uint32_t num_threads) {
+	std::vector<GEODETIC_DBSCAN_PAIRS> thread_pairs;
+	GEODETIC_DBSCAN_PAIRS pairs;
+	char *in_a_cluster;
+	double max_chord;
+	int all_points = LW_TRUE;
+	uint32_t i;
+
+	in_a_cluster = (char *)lwalloc((num_geoms ? num_geoms : 1) * sizeof(char));
+	memset(in_a_cluster, min_points <= 1 ? LW_TRUE : LW_FALSE, num_geoms * sizeof(char));
+	if (in_a_cluster_ret)
+		*in_a_cluster_ret = in_a_cluster;
+
+	/* Bail if we don't even have enough inputs to make a cluster, as union_dbscan does. */
+	if ((min_points <= 1 && num_geoms <= 1) || (min_points > 1 && num_geoms <= min_points)) {
+		if (!in_a_cluster_ret)
+			lwfree(in_a_cluster);
+		return LW_SUCCESS;
+	}
+
+	/* A few hundred geometries are clustered faster than threads start */
+	num_threads = FP_MAX(1u, FP_MIN(num_threads, num_geoms / GEODETIC_DBSCAN_MIN_GEOMS_PER_THREAD));
+
+	/* Two geometries are within eps of each other when their closest points are within the chord of eps */
+	max_chord = eps >= M_PI ? 2.0 : 2.0 * sin(FP_MAX(eps, 0.0) / 2.0);
+
+	for (i = 0; i < num_geoms; i++) {
+		if (geoms[i]->type != POINTTYPE || lwgeom_is_empty(geoms[i])) {
+			all_points = LW_FALSE;
+			break;
+		}
+	}
+	thread_pairs.resize(num_threads);
+	if (all_points)
+		geodetic_dbscan_point_pairs(geoms, num_geoms, max_chord, num_threads, thread_pairs);
+	else
+		geodetic_dbscan_geometry_pairs(geoms, num_geoms, eps, max_chord, num_threads, thread_pairs);
+	for (auto &found : thread_pairs) {
+		pairs.insert(pairs.end(), found.begin(), found.end());
+		GEODETIC_DBSCAN_PAIRS().swap(found);
+	}
+
+	/* Every geometry is its own neighbour */
+	std::unique_ptr<std::atomic<uint32_t>[]> num_neighbors(new std::atomic<uint32_t>[num_geoms]);
+	std::unique_ptr<std::atomic<uint32_t>[]> parents(new std::atomic<uint32_t>[num_geoms]);
+	std::unique_ptr<std::atomic<uint32_t>[]> borders(new std::atomic<uint32_t>[num_geoms]);
+	for (i = 0; i < num_geoms; i++) {
+		num_neighbors[i] = 1;
+		parents[i] = i;
+		borders[i] = UINT32_MAX;
+	}
+
+	if (min_points > 1) {
+		geodetic_dbscan_parallel(num_threads, (uint32_t)pairs.size(), [&](uint32_t thread, uint32_t begin, uint32_t end) {
+			for (uint32_t k = begin; k < end; k++) {
+				num_neighbors[pairs[k].first].fetch_add(1, std::memory_order_relaxed);
+				num_neighbors[pairs[k].second].fetch_add(1, std::memory_order_relaxed);
+			}
+		});
+	}
+
+	geodetic_dbscan_parallel(num_threads, (uint32_t)pairs.size(), [&](uint32_t thread, uint32_t begin, uint32_t end) {
+		for (uint32_t k = begin; k < end; k++) {
+			uint32_t p = pairs[k].first;
+			uint32_t q = pairs[k].second;
+			int p_is_core = num_neighbors[p] >= min_points;
+			int q_is_core = num_neighbors[q] >= min_points;
+			if (p_is_core && q_is_core)
+				geodetic_dbscan_union(parents.get(), p, q);
+			else if (p_is_core)
+				geodetic_dbscan_border(borders.get(), q, p);
+			else if (q_is_core)
+				geodetic_dbscan_border(borders.get(), p, q);
+		}
+	});
+
+	/* Copy the clusters into uf in the order of the ids, so that the cluster ids come out the same every time */
+	for (i = 0; i < num_geoms; i++) {
+		if (num_neighbors[i] >= min_points) {
+			UF_union(uf, i, geodetic_dbscan_find(parents.get(), i));
+			in_a_cluster[i] = LW_TRUE;
+		} else if (borders[i] != UINT32_MAX) {
+			UF_union(uf, i, borders[i]);
+			in_a_cluster[i] = LW_TRUE;
+		}
+	}
+
+	if (!in_a_cluster_ret)
+		lwfree(in_a_cluster);
+	return LW_SUCCESS;
+}
+
 } // namespace duckdb
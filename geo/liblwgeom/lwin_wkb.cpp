@@ -257,22 +257,26 @@ uint8_t *bytes_from_hexbytes(const char *hexbuf, size_t hexsize) {
  * Check is a bitmask of: LW_PARSER_CHECK_MINPOINTS, LW_PARSER_CHECK_ODD,
  * LW_PARSER_CHECK_CLOSURE, LW_PARSER_CHECK_NONE, LW_PARSER_CHECK_ALL
  */
+static void wkb_parse_state_init(wkb_parse_state *s, const uint8_t *wkb, const size_t wkb_size, const char check) {
+	s->wkb = wkb;
+	s->wkb_size = wkb_size;
+	s->swap_bytes = LW_FALSE;
+	s->check = check;
+	s->lwtype = 0;
+	s->srid = SRID_UNKNOWN;
+	s->has_z = LW_FALSE;
+	s->has_m = LW_FALSE;
+	s->has_srid = LW_FALSE;
+	s->error = LW_FALSE;
+	s->pos = wkb;
+	s->depth = 1;
+}
+
 LWGEOM *lwgeom_from_wkb(const uint8_t *wkb, const size_t wkb_size, const char check) {
 	wkb_parse_state s;
 
 	/* Initialize the state appropriately */
-	s.wkb = wkb;
-	s.wkb_size = wkb_size;
-	s.swap_bytes = LW_FALSE;
-	s.check = check;
-	s.lwtype = 0;
-	s.srid = SRID_UNKNOWN;
-	s.has_z = LW_FALSE;
-	s.has_m = LW_FALSE;
-	s.has_srid = LW_FALSE;
-	s.error = LW_FALSE;
-	s.pos = wkb;
-	s.depth = 1;
+	wkb_parse_state_init(&s, wkb, wkb_size, check);
 
 	if (!wkb || !wkb_size)
 		return NULL;
@@ -673,23 +677,20 @@ static LWCOLLECTION *lwcollection_from_wkb_state(wkb_parse_state *s) {
 }
 
 /**
- * GEOMETRY
- * Generic handling for WKB geometries. The front of every WKB geometry
- * (including those embedded in collections) is an endian byte, a type
- * number and an optional srid number. We handle all those here, then pass
- * to the appropriate handler for the specific type.
+ * Read the front of a WKB geometry: the endian byte, the type number and
+ * the optional srid number, leaving the parse state just after them.
  */
-LWGEOM *lwgeom_from_wkb_state(wkb_parse_state *s) {
+static int wkb_header_from_wkb_state(wkb_parse_state *s) {
 	char wkb_little_endian;
 	uint32_t wkb_type;
 
 	/* Fail when handed incorrect starting byte */
 	wkb_little_endian = byte_from_wkb_state(s);
 	if (s->error)
-		return NULL;
+		return LW_FAILURE;
 	if (wkb_little_endian != 1 && wkb_little_endian != 0) {
 		lwerror("Invalid endian flag value encountered.");
-		return NULL;
+		return LW_FAILURE;
 	}
 
 	/* Check the endianness of our input  */
@@ -705,17 +706,31 @@ LWGEOM *lwgeom_from_wkb_state(wkb_parse_state *s) {
 	/* Read the type number */
 	wkb_type = integer_from_wkb_state(s);
 	if (s->error)
-		return NULL;
+		return LW_FAILURE;
 	lwtype_from_wkb_state(s, wkb_type);
 
 	/* Read the SRID, if necessary */
 	if (s->has_srid) {
 		s->srid = clamp_srid(integer_from_wkb_state(s));
 		if (s->error)
-			return NULL;
+			return LW_FAILURE;
 		/* TODO: warn on explicit UNKNOWN srid ? */
 	}
 
+	return LW_SUCCESS;
+}
+
+/**
+ * GEOMETRY
+ * Generic handling for WKB geometries. The front of every WKB geometry
+ * (including those embedded in collections) is an endian byte, a type
+ * number and an optional srid number. We handle all those here, then pass
+ * to the appropriate handler for the specific type.
+ */
+LWGEOM *lwgeom_from_wkb_state(wkb_parse_state *s) {
+	if (wkb_header_from_wkb_state(s) == LW_FAILURE)
+		return NULL;
+
 	/* Do the right thing */
 	switch (s->lwtype) {
 	case POINTTYPE:
@@ -757,6 +772,478 @@ LWGEOM *lwgeom_from_wkb_state(wkb_parse_state *s) {
 	return NULL;
 }
 
+/**
+ * Emptiness of the geometry at the current parse position, decided from as
+ * few bytes as possible. Empty geometries are skipped over entirely, so a
+ * collection can keep walking its members until one of them is not empty.
+ * Returns LW_FAILURE for types that need a full parse.
+ */
+static int wkb_is_empty_from_wkb_state(wkb_parse_state *s, int *is_empty) {
+	uint32_t ndims, count, npoints, i;
+
+	if (wkb_header_from_wkb_state(s) == LW_FAILURE)
+		return LW_FAILURE;
+
+	ndims = 2;
+	if (s->has_z)
+		ndims++;
+	if (s->has_m)
+		ndims++;
+
+	switch (s->lwtype) {
+	case POINTTYPE: {
+		double x, y;
+		wkb_parse_state_check(s, ndims * WKB_DOUBLE_SIZE);
+		if (s->error)
+			return LW_FAILURE;
+		x = double_from_wkb_state(s);
+		y = double_from_wkb_state(s);
+		s->pos += (ndims - 2) * WKB_DOUBLE_SIZE;
+		/* POINT(NaN NaN) is POINT EMPTY */
+		*is_empty = std::isnan(x) && std::isnan(y);
+		return LW_SUCCESS;
+	}
+	case LINETYPE:
+		npoints = integer_from_wkb_state(s);
+		if (s->error)
+			return LW_FAILURE;
+		*is_empty = npoints == 0;
+		return LW_SUCCESS;
+	case POLYGONTYPE:
+		count = integer_from_wkb_state(s);
+		if (s->error)
+			return LW_FAILURE;
+		*is_empty = LW_TRUE;
+		/* A polygon is empty when it has no rings or its shell has no points */
+		for (i = 0; i < count; i++) {
+			npoints = integer_from_wkb_state(s);
+			if (s->error)
+				return LW_FAILURE;
+			if (i == 0 && npoints > 0) {
+				*is_empty = LW_FALSE;
+				return LW_SUCCESS;
+			}
+			wkb_parse_state_check(s, (size_t)npoints * ndims * WKB_DOUBLE_SIZE);
+			if (s->error)
+				return LW_FAILURE;
+			s->pos += (size_t)npoints * ndims * WKB_DOUBLE_SIZE;
+		}
+		return LW_SUCCESS;
+	case MULTIPOINTTYPE:
+	case MULTILINETYPE:
+	case MULTIPOLYGONTYPE:
+	case COLLECTIONTYPE:
+		count = integer_from_wkb_state(s);
+		if (s->error)
+			return LW_FAILURE;
+		s->depth++;
+		if (s->depth >= LW_PARSER_MAX_DEPTH) {
+			lwerror("Geometry has too many chained collections");
+			return LW_FAILURE;
+		}
+		*is_empty = LW_TRUE;
+		for (i = 0; i < count; i++) {
+			if (wkb_is_empty_from_wkb_state(s, is_empty) == LW_FAILURE)
+				return LW_FAILURE;
+			if (!*is_empty)
+				return LW_SUCCESS;
+		}
+		s->depth--;
+		return LW_SUCCESS;
+	/* Curves, triangles and surfaces */
+	default:
+		return LW_FAILURE;
+	}
+}
+
+/**
+ * Expand gbox by the 2D extent of a point array at the current parse
+ * position, advancing past it. Sets *found once a point was seen.
+ */
+static int wkb_gbox_add_points(wkb_parse_state *s, uint32_t npoints, uint32_t ndims, GBOX *gbox, int *found) {
+	uint32_t i;
+	double x, y;
+
+	wkb_parse_state_check(s, (size_t)npoints * ndims * WKB_DOUBLE_SIZE);
+	if (s->error)
+		return LW_FAILURE;
+
+	/*
+	 * Native byte order: reduce the coordinate stream with branch free
+	 * min/max, which the compiler turns into vector code. A NaN ordinate
+	 * loses every comparison and so never makes it into the box.
+	 */
+	if (!s->swap_bytes && npoints > 1) {
+		const uint8_t *pos = s->pos;
+		const size_t stride = ndims * WKB_DOUBLE_SIZE;
+		double xmin = INFINITY, xmax = -INFINITY;
+		double ymin = INFINITY, ymax = -INFINITY;
+
+		for (i = 0; i < npoints; i++, pos += stride) {
+			memcpy(&x, pos, WKB_DOUBLE_SIZE);
+			memcpy(&y, pos + WKB_DOUBLE_SIZE, WKB_DOUBLE_SIZE);
+			xmin = x < xmin ? x : xmin;
+			xmax = x > xmax ? x : xmax;
+			ymin = y < ymin ? y : ymin;
+			ymax = y > ymax ? y : ymax;
+		}
+		s->pos = pos;
+
+		if (xmin > xmax || ymin > ymax)
+			return LW_SUCCESS;
+		if (!*found) {
+			gbox->xmin = xmin;
+			gbox->xmax = xmax;
+			gbox->ymin = ymin;
+			gbox->ymax = ymax;
+			*found = LW_TRUE;
+			return LW_SUCCESS;
+		}
+		gbox->xmin = FP_MIN(gbox->xmin, xmin);
+		gbox->xmax = FP_MAX(gbox->xmax, xmax);
+		gbox->ymin = FP_MIN(gbox->ymin, ymin);
+		gbox->ymax = FP_MAX(gbox->ymax, ymax);
+		return LW_SUCCESS;
+	}
+
+	for (i = 0; i < npoints; i++) {
+		x = double_from_wkb_state(s);
+		y = double_from_wkb_state(s);
+		s->pos += (ndims - 2) * WKB_DOUBLE_SIZE;
+		if (std::isnan(x) && std::isnan(y))
+			continue;
+		if (!*found) {
+			gbox->xmin = gbox->xmax = x;
+			gbox->ymin = gbox->ymax = y;
+			*found = LW_TRUE;
+			continue;
+		}
+		gbox->xmin = FP_MIN(gbox->xmin, x);
+		gbox->xmax = FP_MAX(gbox->xmax, x);
+		gbox->ymin = FP_MIN(gbox->ymin, y);
+		gbox->ymax = FP_MAX(gbox->ymax, y);
+	}
+	return LW_SUCCESS;
+}
+
+/**
+ * Accumulate the 2D extent of the geometry at the current parse position.
+ * Returns LW_FAILURE for curved types, whose arcs can leave the box of
+ * their control points.
+ */
+static int wkb_gbox_from_wkb_state(wkb_parse_state *s, GBOX *gbox, int *found) {
+	uint32_t ndims, count, i;
+
+	if (wkb_header_from_wkb_state(s) == LW_FAILURE)
+		return LW_FAILURE;
+
+	ndims = 2;
+	if (s->has_z)
+		ndims++;
+	if (s->has_m)
+		ndims++;
+
+	switch (s->lwtype) {
+	case POINTTYPE:
+		return wkb_gbox_add_points(s, 1, ndims, gbox, found);
+	case LINETYPE:
+		count = integer_from_wkb_state(s);
+		if (s->error)
+			return LW_FAILURE;
+		return wkb_gbox_add_points(s, count, ndims, gbox, found);
+	case POLYGONTYPE:
+	case TRIANGLETYPE:
+		count = integer_from_wkb_state(s);
+		if (s->error)
+			return LW_FAILURE;
+		for (i = 0; i < count; i++) {
+			uint32_t npoints = integer_from_wkb_state(s);
+			if (s->error || wkb_gbox_add_points(s, npoints, ndims, gbox, found) == LW_FAILURE)
+				return LW_FAILURE;
+		}
+		return LW_SUCCESS;
+	case MULTIPOINTTYPE:
+	case MULTILINETYPE:
+	case MULTIPOLYGONTYPE:
+	case POLYHEDRALSURFACETYPE:
+	case TINTYPE:
+	case COLLECTIONTYPE:
+		count = integer_from_wkb_state(s);
+		if (s->error)
+			return LW_FAILURE;
+		s->depth++;
+		if (s->depth >= LW_PARSER_MAX_DEPTH) {
+			lwerror("Geometry has too many chained collections");
+			return LW_FAILURE;
+		}
+		for (i = 0; i < count; i++) {
+			if (wkb_gbox_from_wkb_state(s, gbox, found) == LW_FAILURE)
+				return LW_FAILURE;
+		}
+		s->depth--;
+		return LW_SUCCESS;
+	/* Curves */
+	default:
+		return LW_FAILURE;
+	}
+}
+
+int wkb_peek_type(const uint8_t *wkb, const size_t wkb_size, uint8_t *type) {
+	wkb_parse_state s;
+	wkb_parse_state_init(&s, wkb, wkb_size, LW_PARSER_CHECK_NONE);
+
+	if (!wkb || !wkb_size || wkb_header_from_wkb_state(&s) == LW_FAILURE)
+		return LW_FAILURE;
+
+	*type = s.lwtype;
+	return LW_SUCCESS;
+}
+
+int wkb_peek_srid(const uint8_t *wkb, const size_t wkb_size, int32_t *srid) {
+	wkb_parse_state s;
+	wkb_parse_state_init(&s, wkb, wkb_size, LW_PARSER_CHECK_NONE);
+
+	if (!wkb || !wkb_size || wkb_header_from_wkb_state(&s) == LW_FAILURE)
+		return LW_FAILURE;
+
+	*srid = s.srid;
+	return LW_SUCCESS;
+}
+
+int wkb_peek_gbox(const uint8_t *wkb, const size_t wkb_size, GBOX *gbox) {
+	wkb_parse_state s;
+	int found = LW_FALSE;
+	wkb_parse_state_init(&s, wkb, wkb_size, LW_PARSER_CHECK_NONE);
+
+	if (!wkb || !wkb_size)
+		return LW_FAILURE;
+
+	gbox_init(gbox);
+	if (wkb_gbox_from_wkb_state(&s, gbox, &found) == LW_FAILURE || !found)
+		return LW_FAILURE;
+	return LW_SUCCESS;
+}
+
+int wkb_peek_is_empty(const uint8_t *wkb, const size_t wkb_size, int *is_empty) {
+	wkb_parse_state s;
+	wkb_parse_state_init(&s, wkb, wkb_size, LW_PARSER_CHECK_NONE);
+
+	if (!wkb || !wkb_size)
+		return LW_FAILURE;
+
+	return wkb_is_empty_from_wkb_state(&s, is_empty);
+}
+
+int wkb_peek_ngeoms(const uint8_t *wkb, const size_t wkb_size, uint32_t *ngeoms) {
+	wkb_parse_state s;
+	wkb_parse_state_init(&s, wkb, wkb_size, LW_PARSER_CHECK_NONE);
+
+	if (!wkb || !wkb_size || wkb_header_from_wkb_state(&s) == LW_FAILURE)
+		return LW_FAILURE;
+	if (!lwtype_is_collection(s.lwtype))
+		return LW_FAILURE;
+
+	*ngeoms = integer_from_wkb_state(&s);
+	if (s.error)
+		return LW_FAILURE;
+	return LW_SUCCESS;
+}
+
+int wkb_peek_first_point(const uint8_t *wkb, const size_t wkb_size, POINT4D *out_point) {
+	wkb_parse_state s;
+	double *dlist = (double *)out_point;
+	uint32_t ndims = 2;
+	uint32_t i;
+	wkb_parse_state_init(&s, wkb, wkb_size, LW_PARSER_CHECK_NONE);
+
+	if (!wkb || !wkb_size || wkb_header_from_wkb_state(&s) == LW_FAILURE)
+		return LW_FAILURE;
+	if (s.lwtype != POINTTYPE)
+		return LW_FAILURE;
+
+	if (s.has_z)
+		ndims++;
+	if (s.has_m)
+		ndims++;
+	wkb_parse_state_check(&s, ndims * WKB_DOUBLE_SIZE);
+	if (s.error)
+		return LW_FAILURE;
+
+	out_point->z = out_point->m = 0.0;
+	for (i = 0; i < ndims; i++)
+		dlist[i] = double_from_wkb_state(&s);
+	/* XYM, the third ordinate is M */
+	if (s.has_m && !s.has_z) {
+		out_point->m = out_point->z;
+		out_point->z = 0.0;
+	}
+
+	/* POINT(NaN NaN) is POINT EMPTY */
+	if (std::isnan(out_point->x) && std::isnan(out_point->y))
+		return LW_FAILURE;
+	return LW_SUCCESS;
+}
+
+/**
+ * Append the non-empty leaves of the geometry at the current parse position
+ * to the component list, in the order lwgeom_dump visits them. Only native
+ * byte order points, lines, polygons and their collections are handled.
+ */
+static int wkb_components_from_wkb_state(wkb_parse_state *s, int parent_type, WKB_COMPONENT **components,
+                                         uint32_t *ncomponents, uint32_t *maxcomponents) {
+	uint32_t ndims, count, npoints, i;
+	const uint8_t *start;
+	int is_empty, type;
+
+	if (wkb_header_from_wkb_state(s) == LW_FAILURE || s->swap_bytes)
+		return LW_FAILURE;
+	/* Leave invalid members to the full parse, which reports them */
+	if (parent_type && !lwcollection_allows_subtype(parent_type, s->lwtype))
+		return LW_FAILURE;
+
+	ndims = 2;
+	if (s->has_z)
+		ndims++;
+	if (s->has_m)
+		ndims++;
+
+	start = s->pos;
+	switch (s->lwtype) {
+	case POINTTYPE: {
+		double x, y;
+		wkb_parse_state_check(s, ndims * WKB_DOUBLE_SIZE);
+		if (s->error)
+			return LW_FAILURE;
+		x = double_from_wkb_state(s);
+		y = double_from_wkb_state(s);
+		s->pos += (ndims - 2) * WKB_DOUBLE_SIZE;
+		/* POINT(NaN NaN) is POINT EMPTY */
+		is_empty = std::isnan(x) && std::isnan(y);
+		break;
+	}
+	case LINETYPE:
+		npoints = integer_from_wkb_state(s);
+		if (s->error)
+			return LW_FAILURE;
+		wkb_parse_state_check(s, (size_t)npoints * ndims * WKB_DOUBLE_SIZE);
+		if (s->error)
+			return LW_FAILURE;
+		s->pos += (size_t)npoints * ndims * WKB_DOUBLE_SIZE;
+		is_empty = npoints == 0;
+		break;
+	case POLYGONTYPE:
+		count = integer_from_wkb_state(s);
+		if (s->error)
+			return LW_FAILURE;
+		/* A polygon is empty when it has no rings or its shell has no points */
+		is_empty = LW_TRUE;
+		for (i = 0; i < count; i++) {
+			npoints = integer_from_wkb_state(s);
+			if (s->error)
+				return LW_FAILURE;
+			if (i == 0 && npoints > 0)
+				is_empty = LW_FALSE;
+			wkb_parse_state_check(s, (size_t)npoints * ndims * WKB_DOUBLE_SIZE);
+			if (s->error)
+				return LW_FAILURE;
+			s->pos += (size_t)npoints * ndims * WKB_DOUBLE_SIZE;
+		}
+		break;
+	case MULTIPOINTTYPE:
+	case MULTILINETYPE:
+	case MULTIPOLYGONTYPE:
+	case COLLECTIONTYPE:
+		count = integer_from_wkb_state(s);
+		if (s->error)
+			return LW_FAILURE;
+		s->depth++;
+		if (s->depth >= LW_PARSER_MAX_DEPTH) {
+			lwerror("Geometry has too many chained collections");
+			return LW_FAILURE;
+		}
+		type = s->lwtype;
+		for (i = 0; i < count; i++) {
+			if (wkb_components_from_wkb_state(s, type, components, ncomponents, maxcomponents) == LW_FAILURE)
+				return LW_FAILURE;
+		}
+		s->depth--;
+		return LW_SUCCESS;
+	/* Curves, triangles and surfaces */
+	default:
+		return LW_FAILURE;
+	}
+
+	if (is_empty)
+		return LW_SUCCESS;
+
+	if (*ncomponents == *maxcomponents) {
+		*maxcomponents *= 2;
+		*components = (WKB_COMPONENT *)lwrealloc(*components, *maxcomponents * sizeof(WKB_COMPONENT));
+	}
+	(*components)[*ncomponents].type = s->lwtype;
+	(*components)[*ncomponents].has_z = s->has_z;
+	(*components)[*ncomponents].has_m = s->has_m;
+	(*components)[*ncomponents].offset = start - s->wkb;
+	(*components)[*ncomponents].size = s->pos - start;
+	(*ncomponents)++;
+	return LW_SUCCESS;
+}
+
+int wkb_peek_components(const uint8_t *wkb, const size_t wkb_size, int32_t *srid, WKB_COMPONENT **components,
+                        uint32_t *ncomponents) {
+	wkb_parse_state s;
+	uint32_t maxcomponents = 8;
+	wkb_parse_state_init(&s, wkb, wkb_size, LW_PARSER_CHECK_NONE);
+
+	if (!wkb || !wkb_size)
+		return LW_FAILURE;
+
+	*ncomponents = 0;
+	*components = (WKB_COMPONENT *)lwalloc(maxcomponents * sizeof(WKB_COMPONENT));
+	if (wkb_components_from_wkb_state(&s, 0, components, ncomponents, &maxcomponents) == LW_FAILURE) {
+		lwfree(*components);
+		*components = NULL;
+		return LW_FAILURE;
+	}
+	*srid = s.srid;
+	return LW_SUCCESS;
+}
+
+size_t wkb_component_size(const WKB_COMPONENT *component, int32_t srid) {
+	size_t size = WKB_BYTE_SIZE + WKB_INT_SIZE + component->size;
+	if (srid != SRID_UNKNOWN)
+		size += WKB_INT_SIZE;
+	return size;
+}
+
+/*
+ * Header laid out the way lwgeom_to_wkb writes a standalone WKB_EXTENDED
+ * geometry, the body is copied through untouched.
+ */
+size_t wkb_component_write(const uint8_t *wkb, const WKB_COMPONENT *component, int32_t srid, uint8_t *buf) {
+	uint8_t *pos = buf;
+	uint32_t wkb_type = component->type;
+
+	if (component->has_z)
+		wkb_type |= WKBZOFFSET;
+	if (component->has_m)
+		wkb_type |= WKBMOFFSET;
+	if (srid != SRID_UNKNOWN)
+		wkb_type |= WKBSRIDFLAG;
+
+	*pos = IS_BIG_ENDIAN ? 0 : 1;
+	pos += WKB_BYTE_SIZE;
+	memcpy(pos, &wkb_type, WKB_INT_SIZE);
+	pos += WKB_INT_SIZE;
+	if (srid != SRID_UNKNOWN) {
+		memcpy(pos, &srid, WKB_INT_SIZE);
+		pos += WKB_INT_SIZE;
+	}
+	memcpy(pos, wkb + component->offset, component->size);
+	pos += component->size;
+	return pos - buf;
+}
+
 LWGEOM *lwgeom_from_hexwkb(const char *hexwkb, const char check) {
 	int hexwkb_len;
 	uint8_t *wkb;
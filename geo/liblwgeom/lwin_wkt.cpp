@@ -46,11 +46,14 @@ const char *parser_error_messages[] = {"",
                                        "geometry has too many points",
                                        "parse error - invalid geometry"};
 
+/*
+ * The error location is filled in by WKT_ERROR() in the grammar, which
+ * has the current token location from the pure parser.
+ */
 #define SET_PARSER_ERROR(errno)                                                                                        \
 	{                                                                                                                  \
 		global_parser_result.message = parser_error_messages[(errno)];                                                 \
 		global_parser_result.errcode = (errno);                                                                        \
-		global_parser_result.errlocation = wkt_yylloc.last_column;                                                     \
 	}
 
 void lwgeom_parser_result_init(LWGEOM_PARSER_RESULT *parser_result) {
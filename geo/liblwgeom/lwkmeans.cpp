@@ -0,0 +1,272 @@
+/**********************************************************************
+ *
+ * PostGIS - Spatial Types for PostgreSQL
+ * http://postgis.net
+ *
+ * PostGIS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * PostGIS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PostGIS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **********************************************************************/
+
+#include "liblwgeom/liblwgeom_internal.hpp"
+#include "liblwgeom/lwgeodetic.hpp"
+
+#include <float.h>
+#include <math.h>
+#include <string.h>
+
+namespace duckdb {
+
+/* Lloyd iterations stop here even when some points still move */
+#define KMEANS_MAX_ITERATIONS 1000
+
+/* Fixed seed, so that the same input always gives the same clusters */
+#define KMEANS_SEED 0x9E3779B97F4A7C15ULL
+
+/*
+ * The points are kept as unit vectors in three flat coordinate arrays, and
+ * the centres likewise. The squared chord between two unit vectors grows
+ * with their great circle distance, so it orders the centres of a point as
+ * the distance on the sphere does.
+ */
+typedef struct {
+	uint32_t n;
+	double *xs, *ys, *zs;
+	uint32_t k;
+	double *cx, *cy, *cz;
+	double *best_d2; /* squared chord from each point to its centre */
+	int *labels;
+} KMEANS;
+
+/* splitmix64 */
+static uint64_t kmeans_random(uint64_t *state) {
+	uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+static double kmeans_random_uniform(uint64_t *state) {
+	return (kmeans_random(state) >> 11) * (1.0 / 9007199254740992.0);
+}
+
+static inline double kmeans_chord2(const KMEANS *km, uint32_t i, uint32_t c) {
+	double dx = km->xs[i] - km->cx[c];
+	double dy = km->ys[i] - km->cy[c];
+	double dz = km->zs[i] - km->cz[c];
+	return dx * dx + dy * dy + dz * dz;
+}
+
+static void kmeans_set_centre(KMEANS *km, uint32_t c, uint32_t i) {
+	km->cx[c] = km->xs[i];
+	km->cy[c] = km->ys[i];
+	km->cz[c] = km->zs[i];
+}
+
+/*
+ * k-means++ seeding: every further centre is drawn among the points with a
+ * probability proportional to the squared distance to the nearest centre
+ * drawn so far. When every point sits on a centre already there are fewer
+ * distinct points than clusters, and km->k shrinks to the centres found.
+ */
+static void kmeans_seed(KMEANS *km, uint32_t k) {
+	uint64_t state = KMEANS_SEED;
+	double *d2 = km->best_d2;
+	uint32_t i, c;
+
+	kmeans_set_centre(km, 0, (uint32_t)(kmeans_random(&state) % km->n));
+	for (i = 0; i < km->n; i++)
+		d2[i] = kmeans_chord2(km, i, 0);
+
+	for (c = 1; c < k; c++) {
+		double total = 0, target, sum = 0;
+		uint32_t pick = km->n - 1;
+
+		for (i = 0; i < km->n; i++)
+			total += d2[i];
+		if (total <= 0)
+			break;
+
+		target = kmeans_random_uniform(&state) * total;
+		for (i = 0; i < km->n; i++) {
+			sum += d2[i];
+			if (d2[i] > 0 && sum > target) {
+				pick = i;
+				break;
+			}
+		}
+		kmeans_set_centre(km, c, pick);
+		for (i = 0; i < km->n; i++)
+			d2[i] = FP_MIN(d2[i], kmeans_chord2(km, i, c));
+	}
+	km->k = c;
+}
+
+/*
+ * Assign every point to its nearest centre. The centres are the outer loop
+ * and the points the inner one, which has no branches, so the compiler can
+ * vectorize it over the points. Returns the number of points that moved.
+ */
+static uint32_t kmeans_assign(KMEANS *km, int *next) {
+	uint32_t i, c, moved = 0;
+
+	for (i = 0; i < km->n; i++) {
+		km->best_d2[i] = DBL_MAX;
+		next[i] = 0;
+	}
+	for (c = 0; c < km->k; c++) {
+		double cx = km->cx[c], cy = km->cy[c], cz = km->cz[c];
+		for (i = 0; i < km->n; i++) {
+			double dx = km->xs[i] - cx, dy = km->ys[i] - cy, dz = km->zs[i] - cz;
+			double d2 = dx * dx + dy * dy + dz * dz;
+			int closer = d2 < km->best_d2[i];
+			km->best_d2[i] = closer ? d2 : km->best_d2[i];
+			next[i] = closer ? (int)c : next[i];
+		}
+	}
+	for (i = 0; i < km->n; i++) {
+		moved += next[i] != km->labels[i];
+		km->labels[i] = next[i];
+	}
+	return moved;
+}
+
+/*
+ * Move every centre to the mean of its points, pushed back onto the sphere.
+ * A centre left without points takes over the point farthest from its own
+ * centre.
+ */
+static void kmeans_update(KMEANS *km) {
+	double *sx = (double *)lwalloc(sizeof(double) * km->k);
+	double *sy = (double *)lwalloc(sizeof(double) * km->k);
+	double *sz = (double *)lwalloc(sizeof(double) * km->k);
+	uint32_t *counts = (uint32_t *)lwalloc(sizeof(uint32_t) * km->k);
+	uint32_t i, c;
+
+	memset(sx, 0, sizeof(double) * km->k);
+	memset(sy, 0, sizeof(double) * km->k);
+	memset(sz, 0, sizeof(double) * km->k);
+	memset(counts, 0, sizeof(uint32_t) * km->k);
+	for (i = 0; i < km->n; i++) {
+		c = km->labels[i];
+		sx[c] += km->xs[i];
+		sy[c] += km->ys[i];
+		sz[c] += km->zs[i];
+		counts[c]++;
+	}
+
+	for (c = 0; c < km->k; c++) {
+		double norm = sqrt(sx[c] * sx[c] + sy[c] * sy[c] + sz[c] * sz[c]);
+		if (counts[c] > 0 && norm > 0) {
+			km->cx[c] = sx[c] / norm;
+			km->cy[c] = sy[c] / norm;
+			km->cz[c] = sz[c] / norm;
+			continue;
+		}
+		if (counts[c] == 0) {
+			uint32_t far = 0;
+			for (i = 1; i < km->n; i++) {
+				if (km->best_d2[i] > km->best_d2[far])
+					far = i;
+			}
+			if (km->best_d2[far] > 0) {
+				kmeans_set_centre(km, c, far);
+				km->best_d2[far] = 0;
+			}
+		}
+		/* points around the whole sphere that cancel out keep their centre */
+	}
+
+	lwfree(sx);
+	lwfree(sy);
+	lwfree(sz);
+	lwfree(counts);
+}
+
+static void kmeans_run(KMEANS *km, uint32_t k, int *next) {
+	uint32_t i, iteration;
+
+	kmeans_seed(km, k);
+	for (i = 0; i < km->n; i++)
+		km->labels[i] = -1;
+	for (iteration = 0; iteration < KMEANS_MAX_ITERATIONS; iteration++) {
+		if (kmeans_assign(km, next) == 0)
+			break;
+		kmeans_update(km);
+	}
+}
+
+/*
+ * k-means over points given as longitude/latitude in degrees, on the unit
+ * sphere. Returns the cluster of every point, numbered from 0. With a
+ * max_radius (radians) above zero, k grows until no point is farther than
+ * max_radius from the centre of its cluster.
+ */
+int *lwgeodetic_cluster_kmeans(const POINT2D *points, uint32_t n, uint32_t k, double max_radius) {
+	KMEANS km;
+	int *next;
+	uint32_t i;
+	double max_chord2;
+
+	if (n == 0)
+		return NULL;
+	if (k == 0) {
+		lwerror("%s: number of clusters must be greater than zero", __func__);
+		return NULL;
+	}
+	if (k > n)
+		k = n;
+
+	km.n = n;
+	km.xs = (double *)lwalloc(sizeof(double) * n);
+	km.ys = (double *)lwalloc(sizeof(double) * n);
+	km.zs = (double *)lwalloc(sizeof(double) * n);
+	km.cx = (double *)lwalloc(sizeof(double) * n);
+	km.cy = (double *)lwalloc(sizeof(double) * n);
+	km.cz = (double *)lwalloc(sizeof(double) * n);
+	km.best_d2 = (double *)lwalloc(sizeof(double) * n);
+	km.labels = (int *)lwalloc(sizeof(int) * n);
+	next = (int *)lwalloc(sizeof(int) * n);
+	for (i = 0; i < n; i++) {
+		POINT3D p;
+		ll2cart(&points[i], &p);
+		km.xs[i] = p.x;
+		km.ys[i] = p.y;
+		km.zs[i] = p.z;
+	}
+
+	max_chord2 = max_radius >= M_PI ? 4.0 : POW2(2.0 * sin(max_radius / 2.0));
+	for (;;) {
+		double worst = 0;
+		kmeans_run(&km, k, next);
+		if (max_radius <= 0 || km.k < k || k == n)
+			break;
+		for (i = 0; i < n; i++)
+			worst = FP_MAX(worst, km.best_d2[i]);
+		if (worst <= max_chord2)
+			break;
+		k++;
+	}
+
+	lwfree(km.xs);
+	lwfree(km.ys);
+	lwfree(km.zs);
+	lwfree(km.cx);
+	lwfree(km.cy);
+	lwfree(km.cz);
+	lwfree(km.best_d2);
+	lwfree(next);
+	return km.labels;
+}
+
+} // namespace duckdb
@@ -269,7 +269,7 @@ static uint8_t *double_to_wkb_buf(const double d, uint8_t *buf, uint8_t variant)
  * @param size_out If supplied, will return the size of the returned memory segment,
  * including the null terminator in the case of ASCII.
  */
-static ptrdiff_t lwgeom_to_wkb_write_buf(const LWGEOM *geom, uint8_t variant, uint8_t *buffer) {
+ptrdiff_t lwgeom_to_wkb_write_buf(const LWGEOM *geom, uint8_t variant, uint8_t *buffer) {
 	/* If neither or both variants are specified, choose the native order */
 	if (!(variant & WKB_NDR || variant & WKB_XDR) || (variant & WKB_NDR && variant & WKB_XDR)) {
 		if (IS_BIG_ENDIAN)
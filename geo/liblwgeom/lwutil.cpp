@@ -28,6 +28,8 @@
 
 #include "liblwgeom/liblwgeom.hpp"
 
+#include <string.h>
+
 namespace duckdb {
 
 const char *lwtype_name(uint8_t type) {
@@ -46,16 +48,192 @@ lwallocator lwalloc_var = default_allocator;
 lwreallocator lwrealloc_var = default_reallocator;
 lwfreeor lwfree_var = default_freeor;
 
+/*
+ * Per-thread arena
+ *
+ * While a scope opened by lwarena_begin() is active on a thread, lwalloc
+ * bumps from large blocks instead of going to malloc for every POINTARRAY,
+ * ring array or serialized copy. Each allocation is prefixed with its size
+ * so that lwrealloc can copy it. lwfree only hands back the most recent
+ * allocation; the rest is reclaimed at once by the outermost lwarena_end().
+ * A scope therefore grows with everything it allocates, so once its blocks
+ * hold LWARENA_MAX_SCOPE_SIZE bytes further allocations go to the default
+ * allocator. That also bounds the block chain lwfree and lwrealloc search
+ * to a couple of dozen entries. The largest block is kept for the next
+ * scope on the same thread.
+ */
+#define LWARENA_ALIGN          16
+#define LWARENA_MIN_BLOCK_SIZE (64 * 1024)
+#define LWARENA_MAX_BLOCK_SIZE (4 * 1024 * 1024)
+#define LWARENA_MAX_SCOPE_SIZE (64 * 1024 * 1024)
+#define LWARENA_ALIGN_SIZE(s)  (((s) + LWARENA_ALIGN - 1) & ~((size_t)LWARENA_ALIGN - 1))
+
+typedef struct lwarena_block_t {
+	struct lwarena_block_t *next;
+	size_t size; /* usable bytes following the header */
+	size_t used;
+} lwarena_block_t;
+
+#define LWARENA_HEADER_SIZE   LWARENA_ALIGN_SIZE(sizeof(lwarena_block_t))
+#define LWARENA_DATA(block)   ((uint8_t *)(block) + LWARENA_HEADER_SIZE)
+#define LWARENA_PREFIX(mem)   ((size_t *)((uint8_t *)(mem)-LWARENA_ALIGN))
+#define LWARENA_SPAN(size)    (LWARENA_ALIGN + LWARENA_ALIGN_SIZE(size))
+
+typedef struct lwarena_t {
+	lwarena_block_t *head;  /* block currently bumped from, followed by the older ones */
+	lwarena_block_t *spare; /* block retained between scopes */
+	size_t reserved;        /* bytes held by the blocks of the current scope */
+	int depth;
+
+	~lwarena_t() {
+		if (spare)
+			default_freeor(spare);
+	}
+} lwarena_t;
+
+static thread_local lwarena_t lwarena = {NULL, NULL, 0, 0};
+
+static lwarena_block_t *lwarena_add_block(size_t span) {
+	lwarena_block_t *block;
+	size_t size = lwarena.head ? lwarena.head->size * 2 : LWARENA_MIN_BLOCK_SIZE;
+	if (size > LWARENA_MAX_BLOCK_SIZE)
+		size = LWARENA_MAX_BLOCK_SIZE;
+	if (size < span)
+		size = span;
+	if (lwarena.reserved + size > LWARENA_MAX_SCOPE_SIZE)
+		return NULL;
+
+	if (lwarena.spare && lwarena.spare->size >= size) {
+		block = lwarena.spare;
+		lwarena.spare = NULL;
+	} else {
+		block = (lwarena_block_t *)default_allocator(LWARENA_HEADER_SIZE + size);
+		if (!block)
+			return NULL;
+		block->size = size;
+	}
+	block->used = 0;
+	block->next = lwarena.head;
+	lwarena.head = block;
+	lwarena.reserved += block->size;
+	return block;
+}
+
+/* Most lookups hit the head block; the scope cap keeps the rest of the chain short */
+static lwarena_block_t *lwarena_find(const void *mem) {
+	for (lwarena_block_t *block = lwarena.head; block; block = block->next) {
+		const uint8_t *data = LWARENA_DATA(block);
+		if ((const uint8_t *)mem >= data && (const uint8_t *)mem < data + block->used)
+			return block;
+	}
+	return NULL;
+}
+
+static void *lwarena_alloc(size_t size) {
+	size_t span = LWARENA_SPAN(size);
+	lwarena_block_t *block = lwarena.head;
+	uint8_t *mem;
+
+	if (!block || block->size - block->used < span) {
+		block = lwarena_add_block(span);
+		if (!block)
+			return lwalloc_var(size); /* over the scope cap, or out of memory */
+	}
+	mem = LWARENA_DATA(block) + block->used;
+	block->used += span;
+	*(size_t *)mem = size;
+	return mem + LWARENA_ALIGN;
+}
+
+/* True when mem is the most recent allocation of the current block */
+static inline int lwarena_is_last(const lwarena_block_t *block, const void *mem) {
+	return block == lwarena.head &&
+	       (const uint8_t *)mem + LWARENA_ALIGN_SIZE(*LWARENA_PREFIX(mem)) == LWARENA_DATA(block) + block->used;
+}
+
+static void *lwarena_realloc(lwarena_block_t *block, void *mem, size_t size) {
+	size_t old_size = *LWARENA_PREFIX(mem);
+	void *ret;
+
+	if (lwarena_is_last(block, mem)) {
+		size_t start = (uint8_t *)mem - LWARENA_DATA(block) - LWARENA_ALIGN;
+		if (start + LWARENA_SPAN(size) <= block->size) {
+			block->used = start + LWARENA_SPAN(size);
+			*LWARENA_PREFIX(mem) = size;
+			return mem;
+		}
+	}
+	ret = lwarena_alloc(size);
+	if (ret)
+		memcpy(ret, mem, old_size < size ? old_size : size);
+	return ret;
+}
+
+static void lwarena_reset(void) {
+	lwarena_block_t *block = lwarena.head;
+	while (block) {
+		lwarena_block_t *next = block->next;
+		if (block->size <= LWARENA_MAX_BLOCK_SIZE && (!lwarena.spare || block->size > lwarena.spare->size)) {
+			if (lwarena.spare)
+				default_freeor(lwarena.spare);
+			lwarena.spare = block;
+		} else {
+			default_freeor(block);
+		}
+		block = next;
+	}
+	lwarena.head = NULL;
+	lwarena.reserved = 0;
+}
+
+void lwarena_begin(void) {
+	lwarena.depth++;
+}
+
+void lwarena_end(void) {
+	if (lwarena.depth > 0 && --lwarena.depth == 0)
+		lwarena_reset();
+}
+
+int lwarena_suspend(void) {
+	int depth = lwarena.depth;
+	lwarena.depth = 0;
+	return depth;
+}
+
+void lwarena_resume(int depth) {
+	lwarena.depth = depth;
+}
+
 void *lwalloc(size_t size) {
-	void *mem = lwalloc_var(size);
+	void *mem = lwarena.depth ? lwarena_alloc(size) : lwalloc_var(size);
 	return mem;
 }
 
+void *lwalloc_persistent(size_t size) {
+	return lwalloc_var(size);
+}
+
 void *lwrealloc(void *mem, size_t size) {
+	if (lwarena.depth) {
+		if (!mem)
+			return lwarena_alloc(size);
+		lwarena_block_t *block = lwarena_find(mem);
+		if (block)
+			return lwarena_realloc(block, mem, size);
+	}
 	return lwrealloc_var(mem, size);
 }
 
 void lwfree(void *mem) {
+	if (lwarena.depth && mem) {
+		lwarena_block_t *block = lwarena_find(mem);
+		if (block) {
+			if (lwarena_is_last(block, mem))
+				block->used = (uint8_t *)mem - LWARENA_DATA(block) - LWARENA_ALIGN;
+			return;
+		}
+	}
 	lwfree_var(mem);
 }
 
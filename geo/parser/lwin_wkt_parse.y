@@ -10,13 +10,13 @@
 /*namespace duckdb {*/
 
 /* Prototypes to quiet the compiler */
-int wkt_yyparse(void);
-void wkt_yyerror(const char *str);
-int wkt_yylex(void);
+int wkt_yyparse(void *scanner);
+void wkt_yyerror(YYLTYPE *llocp, void *scanner, const char *str);
+int wkt_yylex(YYSTYPE *lvalp, YYLTYPE *llocp, void *scanner);
 
 
-/* Declare the global parser variable */
-LWGEOM_PARSER_RESULT global_parser_result;
+/* Declare the parser state. It is kept per thread so that concurrent parses do not share it. */
+thread_local LWGEOM_PARSER_RESULT global_parser_result;
 
 /* Turn on/off verbose parsing (turn off for production) */
 int wkt_yydebug = 0;
@@ -27,45 +27,39 @@ int wkt_yydebug = 0;
 * from WKT_ERROR in the grammar, but we keep this one
 * around just in case.
 */
-void wkt_yyerror(__attribute__((__unused__)) const char *str)
+void wkt_yyerror(YYLTYPE *llocp, __attribute__((__unused__)) void *scanner, __attribute__((__unused__)) const char *str)
 {
 	/* If we haven't already set a message and location, let's set one now. */
 	if ( ! global_parser_result.message )
 	{
 		global_parser_result.message = parser_error_messages[PARSER_ERROR_OTHER];
 		global_parser_result.errcode = PARSER_ERROR_OTHER;
-		global_parser_result.errlocation = wkt_yylloc.last_column;
+		global_parser_result.errlocation = llocp->last_column;
 	}
 }
 
 /**
-* Parse a WKT geometry string into an LWGEOM structure. Note that this
-* process uses globals and is not re-entrant, so don't call it within itself
-* (eg, from within other functions in lwin_wkt.c) or from a threaded program.
+* Parse a WKT geometry string into an LWGEOM structure. The lexer is
+* reentrant and the parser is pure, so the scan state lives on this call;
+* only global_parser_result is shared, and that is per thread. Don't call
+* this from within itself (eg, from within other functions in lwin_wkt.c).
 * Note that parser_result.wkinput picks up a reference to wktstr.
 */
 int lwgeom_parse_wkt(LWGEOM_PARSER_RESULT *parser_result, char *wktstr, int parser_check_flags)
 {
 	int parse_rv = 0;
+	void *scanner = NULL;
 
 	/* Clean up our global parser result. */
 	lwgeom_parser_result_init(&global_parser_result);
-	/* Work-around possible bug in GNU Bison 3.0.2 resulting in wkt_yylloc
-	 * members not being initialized on yyparse() as documented here:
-	 * https://www.gnu.org/software/bison/manual/html_node/Location-Type.html
-	 * See discussion here:
-	 * http://lists.osgeo.org/pipermail/postgis-devel/2014-September/024506.html
-	 */
-	wkt_yylloc.last_column = wkt_yylloc.last_line = \
-		wkt_yylloc.first_column = wkt_yylloc.first_line = 1;
 
 	/* Set the input text string, and parse checks. */
 	global_parser_result.wkinput = wktstr;
 	global_parser_result.parser_check_flags = parser_check_flags;
 
-	wkt_lexer_init(wktstr); /* Lexer ready */
-	parse_rv = wkt_yyparse(); /* Run the parse */
-	wkt_lexer_close(); /* Clean up lexer */
+	wkt_lexer_init(&scanner, wktstr); /* Lexer ready */
+	parse_rv = wkt_yyparse(scanner); /* Run the parse */
+	wkt_lexer_close(scanner); /* Clean up lexer */
 
 	/* A non-zero parser return is an error. */
 	if ( parse_rv || global_parser_result.errcode )
@@ -74,7 +68,6 @@ int lwgeom_parse_wkt(LWGEOM_PARSER_RESULT *parser_result, char *wktstr, int pars
 		{
 			global_parser_result.errcode = PARSER_ERROR_OTHER;
 			global_parser_result.message = parser_error_messages[PARSER_ERROR_OTHER];
-			global_parser_result.errlocation = wkt_yylloc.last_column;
 		}
 		else if (global_parser_result.geom)
 		{
@@ -84,23 +77,44 @@ int lwgeom_parse_wkt(LWGEOM_PARSER_RESULT *parser_result, char *wktstr, int pars
 
 		/* Copy the global values into the return pointer */
 		*parser_result = global_parser_result;
-		wkt_yylex_destroy();
 		return LW_FAILURE;
 	}
 
 	/* Copy the global value into the return pointer */
 	*parser_result = global_parser_result;
-	wkt_yylex_destroy();
 	return LW_SUCCESS;
 }
 
-#define WKT_ERROR() { if ( global_parser_result.errcode != 0 ) { YYERROR; } }
+/*
+* The constructors in lwin_wkt.c only set the error code and message, the
+* location of the lookahead token is filled in here from the parser state.
+*/
+#define WKT_ERROR() { if ( global_parser_result.errcode != 0 ) { \
+	if ( ! global_parser_result.errlocation ) \
+		global_parser_result.errlocation = yylloc.last_column; \
+	YYERROR; } }
 
 
 %}
 
+%define api.pure full
+%define api.header.include {"parser/lwin_wkt_parse.hpp"}
+%lex-param {void *scanner}
+%parse-param {void *scanner}
+
 %locations
-%error-verbose
+%define parse.error verbose
+
+%initial-action
+{
+	/* Work-around possible bug in GNU Bison 3.0.2 resulting in yylloc
+	 * members not being initialized on yyparse() as documented here:
+	 * https://www.gnu.org/software/bison/manual/html_node/Location-Type.html
+	 * See discussion here:
+	 * http://lists.osgeo.org/pipermail/postgis-devel/2014-September/024506.html
+	 */
+	@$.last_column = @$.last_line = @$.first_column = @$.first_line = 1;
+}
 
 %union {
 	int integervalue;
@@ -3,6 +3,7 @@
 #include "postgis/geography_centroid.hpp"
 #include "postgis/geography_inout.hpp"
 #include "postgis/geography_measurement.hpp"
+#include "postgis/geography_measurement_trees.hpp"
 #include "postgis/lwgeom_dump.hpp"
 #include "postgis/lwgeom_export.hpp"
 #include "postgis/lwgeom_functions_analytic.hpp"
@@ -28,10 +29,30 @@ GSERIALIZED *Postgis::LWGEOM_getGserialized(const void *base, size_t size) {
 	return duckdb::LWGEOM_getGserialized(base, size);
 }
 
+LWGEOM *Postgis::LWGEOM_getLWGeom(const void *base, size_t size) {
+	return duckdb::LWGEOM_getLWGeom(base, size);
+}
+
+LWGEOM *Postgis::LWGEOM_getLWGeom(GSERIALIZED *gser) {
+	return duckdb::LWGEOM_getLWGeom(gser);
+}
+
+bool Postgis::LWGEOM_getGBox(const void *base, size_t size, int32_t *srid, GBOX *gbox) {
+	return duckdb::LWGEOM_getGBox(base, size, srid, gbox);
+}
+
+bool Postgis::LWGEOM_getPoint(const void *base, size_t size, int32_t *srid, POINT2D *point) {
+	return duckdb::LWGEOM_getPoint(base, size, srid, point);
+}
+
 char *Postgis::LWGEOM_base(GSERIALIZED *gser) {
 	return duckdb::LWGEOM_base(gser);
 }
 
+idx_t Postgis::LWGEOM_write(LWGEOM *lwgeom, char *buffer) {
+	return duckdb::LWGEOM_write(lwgeom, buffer);
+}
+
 string Postgis::LWGEOM_asBinary(const void *data, size_t size) {
 	return duckdb::LWGEOM_asBinary(data, size);
 }
@@ -40,14 +61,26 @@ lwvarlena_t *Postgis::LWGEOM_asBinary(GSERIALIZED *gser, string text) {
 	return duckdb::LWGEOM_asBinary(gser, text);
 }
 
+lwvarlena_t *Postgis::LWGEOM_asBinary(LWGEOM *lwgeom, string text) {
+	return duckdb::LWGEOM_asBinary(lwgeom, text);
+}
+
 string Postgis::LWGEOM_asText(GSERIALIZED *gser, size_t max_digits) {
 	return duckdb::LWGEOM_asText(gser, max_digits);
 }
 
+string Postgis::LWGEOM_asText(LWGEOM *lwgeom, size_t max_digits) {
+	return duckdb::LWGEOM_asText(lwgeom, max_digits);
+}
+
 lwvarlena_t *Postgis::LWGEOM_asGeoJson(GSERIALIZED *gser, size_t m_dec_digits) {
 	return duckdb::LWGEOM_asGeoJson(gser, m_dec_digits);
 }
 
+lwvarlena_t *Postgis::LWGEOM_asGeoJson(LWGEOM *lwgeom, size_t m_dec_digits) {
+	return duckdb::LWGEOM_asGeoJson(lwgeom, m_dec_digits);
+}
+
 string Postgis::LWGEOM_asGeoJson(const void *data, size_t size) {
 	return duckdb::LWGEOM_asGeoJson(data, size);
 }
@@ -56,14 +89,26 @@ lwvarlena_t *Postgis::ST_GeoHash(GSERIALIZED *gser, size_t m_chars) {
 	return duckdb::ST_GeoHash(gser, m_chars);
 }
 
+lwvarlena_t *Postgis::ST_GeoHash(LWGEOM *lwgeom, size_t m_chars) {
+	return duckdb::ST_GeoHash(lwgeom, m_chars);
+}
+
 idx_t Postgis::LWGEOM_size(GSERIALIZED *gser) {
 	return duckdb::LWGEOM_size(gser);
 }
 
+idx_t Postgis::LWGEOM_size(LWGEOM *lwgeom) {
+	return duckdb::LWGEOM_size(lwgeom);
+}
+
 void Postgis::LWGEOM_free(GSERIALIZED *gser) {
 	duckdb::LWGEOM_free(gser);
 }
 
+void Postgis::LWGEOM_free(LWGEOM *lwgeom) {
+	duckdb::LWGEOM_free(lwgeom);
+}
+
 GSERIALIZED *Postgis::LWGEOM_makepoint(double x, double y) {
 	return duckdb::LWGEOM_makepoint(x, y);
 }
@@ -120,6 +165,26 @@ GSERIALIZED *Postgis::pgis_union_geometry_array(GSERIALIZED *gserArray[], int ne
 	return duckdb::pgis_union_geometry_array(gserArray, nelems);
 }
 
+UnionAggState *Postgis::union_agg_state_create() {
+	return duckdb::union_agg_state_create();
+}
+
+void Postgis::union_agg_state_add(UnionAggState *state, const void *base, size_t size) {
+	duckdb::union_agg_state_add(state, base, size);
+}
+
+void Postgis::union_agg_state_combine(UnionAggState *target, const UnionAggState *source) {
+	duckdb::union_agg_state_combine(target, source);
+}
+
+GSERIALIZED *Postgis::union_agg_state_finalize(UnionAggState *state) {
+	return duckdb::union_agg_state_finalize(state);
+}
+
+void Postgis::union_agg_state_free(UnionAggState *state) {
+	duckdb::union_agg_state_free(state);
+}
+
 GSERIALIZED *Postgis::ST_Intersection(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return duckdb::ST_Intersection(geom1, geom2);
 }
@@ -132,6 +197,26 @@ GSERIALIZED *Postgis::convexhull(GSERIALIZED *geom) {
 	return duckdb::convexhull(geom);
 }
 
+ConvexHullAggState *Postgis::convexhull_agg_state_create() {
+	return duckdb::convexhull_agg_state_create();
+}
+
+void Postgis::convexhull_agg_state_add(ConvexHullAggState *state, const void *base, size_t size) {
+	duckdb::convexhull_agg_state_add(state, base, size);
+}
+
+void Postgis::convexhull_agg_state_combine(ConvexHullAggState *target, const ConvexHullAggState *source) {
+	duckdb::convexhull_agg_state_combine(target, source);
+}
+
+GSERIALIZED *Postgis::convexhull_agg_state_finalize(ConvexHullAggState *state) {
+	return duckdb::convexhull_agg_state_finalize(state);
+}
+
+void Postgis::convexhull_agg_state_free(ConvexHullAggState *state) {
+	duckdb::convexhull_agg_state_free(state);
+}
+
 GSERIALIZED *Postgis::LWGEOM_snaptogrid(GSERIALIZED *geom, double size) {
 	return duckdb::LWGEOM_snaptogrid(geom, 0, 0, size, size);
 }
@@ -160,6 +245,35 @@ bool Postgis::ST_Intersects(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return duckdb::ST_Intersects(geom1, geom2);
 }
 
+PrepGeomCache *Postgis::GetPrepGeomCache(const void *base, size_t size) {
+	return duckdb::GetPrepGeomCache(base, size);
+}
+
+void Postgis::FreePrepGeomCache(PrepGeomCache *cache) {
+	duckdb::FreePrepGeomCache(cache);
+}
+
+bool Postgis::contains(PrepGeomCache *cache, int argnum, GSERIALIZED *geom) {
+	return duckdb::contains_prepared(cache, argnum, geom);
+}
+
+bool Postgis::within(PrepGeomCache *cache, int argnum, GSERIALIZED *geom) {
+	return duckdb::contains_prepared(cache, 3 - argnum, geom);
+}
+
+bool Postgis::ST_Intersects(PrepGeomCache *cache, GSERIALIZED *geom) {
+	return duckdb::ST_Intersects_prepared(cache, geom);
+}
+
+bool Postgis::pip_prepared_batchable(const PrepGeomCache *cache) {
+	return duckdb::pip_prepared_batchable(cache);
+}
+
+void Postgis::pip_prepared_points(const PrepGeomCache *cache, const double *xs, const double *ys, uint32_t n,
+                                  int *results) {
+	duckdb::pip_prepared_points(cache, xs, ys, n, results);
+}
+
 bool Postgis::covers(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return duckdb::covers(geom1, geom2);
 }
@@ -176,6 +290,35 @@ bool Postgis::geography_dwithin(GSERIALIZED *geom1, GSERIALIZED *geom2, double d
 	return duckdb::geography_dwithin(geom1, geom2, distance, use_sphroid);
 }
 
+bool Postgis::geography_dwithin(LWGEOM *lwgeom1, LWGEOM *lwgeom2, double distance, bool use_spheroid) {
+	return duckdb::geography_dwithin(lwgeom1, lwgeom2, distance, use_spheroid);
+}
+
+bool Postgis::geography_dwithin(CircTreeGeomCache *cache, int argnum, LWGEOM *lwgeom, double distance,
+                                bool use_spheroid) {
+	if (argnum == 1)
+		return duckdb::geography_dwithin(cache->lwgeom, lwgeom, distance, use_spheroid, cache->index, NULL);
+	return duckdb::geography_dwithin(lwgeom, cache->lwgeom, distance, use_spheroid, NULL, cache->index);
+}
+
+void Postgis::geography_dwithin_points(const POINT2D *points1, const POINT2D *points2, const double *distances,
+                                       uint32_t count, int32_t srid, bool use_spheroid, bool *results) {
+	duckdb::geography_dwithin_points(points1, points2, distances, count, srid, use_spheroid, results);
+}
+
+uint64_t Postgis::geography_dwithin_cell(const POINT2D *point, int32_t srid, double distance) {
+	return duckdb::geography_dwithin_cell(point, srid, distance);
+}
+
+void Postgis::geography_dwithin_cells(const POINT2D *point, int32_t srid, double distance,
+                                      std::vector<uint64_t> &cells) {
+	duckdb::geography_dwithin_cells(point, srid, distance, cells);
+}
+
+int Postgis::geography_dwithin_cells(const LWGEOM *lwgeom, double distance, std::vector<uint64_t> &cells) {
+	return duckdb::geography_dwithin_cells(lwgeom, distance, cells);
+}
+
 double Postgis::ST_Area(GSERIALIZED *geom) {
 	return duckdb::ST_Area(geom);
 }
@@ -184,6 +327,10 @@ double Postgis::geography_area(GSERIALIZED *geom, bool use_spheroid) {
 	return duckdb::geography_area(geom, use_spheroid);
 }
 
+double Postgis::geography_area(LWGEOM *lwgeom, bool use_spheroid) {
+	return duckdb::geography_area(lwgeom, use_spheroid);
+}
+
 double Postgis::LWGEOM_angle(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return duckdb::LWGEOM_angle(geom1, geom2);
 }
@@ -200,6 +347,10 @@ double Postgis::geography_perimeter(GSERIALIZED *geom, bool use_spheroid) {
 	return duckdb::geography_perimeter(geom, use_spheroid);
 }
 
+double Postgis::geography_perimeter(LWGEOM *lwgeom, bool use_spheroid) {
+	return duckdb::geography_perimeter(lwgeom, use_spheroid);
+}
+
 double Postgis::LWGEOM_azimuth(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return duckdb::LWGEOM_azimuth(geom1, geom2);
 }
@@ -208,6 +359,10 @@ double Postgis::geography_azimuth(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return duckdb::geography_azimuth(geom1, geom2);
 }
 
+double Postgis::geography_azimuth(LWGEOM *lwgeom1, LWGEOM *lwgeom2) {
+	return duckdb::geography_azimuth(lwgeom1, lwgeom2);
+}
+
 double Postgis::LWGEOM_length2d_linestring(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_length2d_linestring(geom);
 }
@@ -216,6 +371,10 @@ double Postgis::geography_length(GSERIALIZED *geom, bool use_spheroid) {
 	return duckdb::geography_length(geom, use_spheroid);
 }
 
+double Postgis::geography_length(LWGEOM *lwgeom, bool use_spheroid) {
+	return duckdb::geography_length(lwgeom, use_spheroid);
+}
+
 GSERIALIZED *Postgis::LWGEOM_envelope(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_envelope(geom);
 }
@@ -228,22 +387,85 @@ double Postgis::geography_maxdistance(GSERIALIZED *geom1, GSERIALIZED *geom2, bo
 	return duckdb::geography_maxdistance(geom1, geom2, use_spheroid);
 }
 
+double Postgis::geography_maxdistance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid) {
+	return duckdb::geography_maxdistance(lwgeom1, lwgeom2, use_spheroid);
+}
+
+double Postgis::geography_maxdistance(CircTreeGeomCache *cache, int argnum, LWGEOM *lwgeom, bool use_spheroid) {
+	if (argnum == 1)
+		return duckdb::geography_maxdistance(cache->lwgeom, lwgeom, use_spheroid, cache->index, NULL);
+	return duckdb::geography_maxdistance(lwgeom, cache->lwgeom, use_spheroid, NULL, cache->index);
+}
+
 GSERIALIZED *Postgis::LWGEOM_envelope_garray(GSERIALIZED *gserArray[], int nelems) {
 	return duckdb::LWGEOM_envelope_garray(gserArray, nelems);
 }
 
-std::vector<int> Postgis::ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int nelems, double tolerance, int minpoints) {
-	return duckdb::ST_ClusterDBSCAN(gserArray, nelems, tolerance, minpoints);
+GSERIALIZED *Postgis::LWGEOM_envelope_gbox(const GBOX *box, int32_t srid) {
+	return duckdb::LWGEOM_envelope_gbox(box, srid);
+}
+
+bool Postgis::LWGEOM_extent_gbox(const void *base, size_t size, int32_t *srid, GBOX *box) {
+	return duckdb::LWGEOM_extent_gbox(base, size, srid, box);
+}
+
+bool Postgis::LWGEOM_hilbert(const void *base, size_t size, const GBOX *extent, uint64_t *key) {
+	return duckdb::LWGEOM_hilbert(base, size, extent, key);
+}
+
+bool Postgis::LWGEOM_zorder(const void *base, size_t size, const GBOX *extent, uint64_t *key) {
+	return duckdb::LWGEOM_zorder(base, size, extent, key);
+}
+
+std::vector<int> Postgis::ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int nelems, double tolerance, int minpoints,
+                                           int nthreads) {
+	return duckdb::ST_ClusterDBSCAN(gserArray, nelems, tolerance, minpoints, nthreads);
+}
+
+std::vector<int> Postgis::ST_ClusterDBSCAN(LWGEOM *geoms[], int nelems, double tolerance, int minpoints,
+                                           int nthreads) {
+	return duckdb::ST_ClusterDBSCAN(geoms, nelems, tolerance, minpoints, nthreads);
+}
+
+std::vector<GSERIALIZED *> Postgis::ST_ClusterWithin(GSERIALIZED *gserArray[], int nelems, double tolerance,
+                                                     int nthreads) {
+	return duckdb::ST_ClusterWithin(gserArray, nelems, tolerance, nthreads);
+}
+
+bool Postgis::ST_ClusterKMeansCentre(GSERIALIZED *gser, POINT2D *centre) {
+	return duckdb::ST_ClusterKMeansCentre(gser, centre);
+}
+
+std::vector<int> Postgis::ST_ClusterKMeans(const POINT2D *centres, int ncentres, int k, double max_radius) {
+	return duckdb::ST_ClusterKMeans(centres, ncentres, k, max_radius);
 }
 
 int Postgis::LWGEOM_dimension(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_dimension(geom);
 }
 
+int Postgis::LWGEOM_dimension(LWGEOM *lwgeom) {
+	return duckdb::LWGEOM_dimension(lwgeom);
+}
+
 std::vector<GSERIALIZED *> Postgis::LWGEOM_dump(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_dump(geom);
 }
 
+bool Postgis::LWGEOM_dump_components(const void *base, size_t size, int32_t *srid,
+                                     std::vector<WKB_COMPONENT> &components) {
+	return duckdb::LWGEOM_dump_components(base, size, srid, components);
+}
+
+size_t Postgis::LWGEOM_dump_component_size(const WKB_COMPONENT &component, int32_t srid) {
+	return duckdb::LWGEOM_dump_component_size(component, srid);
+}
+
+size_t Postgis::LWGEOM_dump_component_write(const void *base, const WKB_COMPONENT &component, int32_t srid,
+                                            char *buffer) {
+	return duckdb::LWGEOM_dump_component_write(base, component, srid, buffer);
+}
+
 GSERIALIZED *Postgis::LWGEOM_endpoint_linestring(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_endpoint_linestring(geom);
 }
@@ -252,18 +474,42 @@ std::string Postgis::geometry_geometrytype(GSERIALIZED *geom) {
 	return duckdb::geometry_geometrytype(geom);
 }
 
+std::string Postgis::geometry_geometrytype(LWGEOM *lwgeom) {
+	return duckdb::geometry_geometrytype(lwgeom);
+}
+
+std::string Postgis::geometry_geometrytype(const void *base, size_t size) {
+	return duckdb::geometry_geometrytype(base, size);
+}
+
 bool Postgis::LWGEOM_isclosed(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_isclosed(geom);
 }
 
+bool Postgis::LWGEOM_isclosed(LWGEOM *lwgeom) {
+	return duckdb::LWGEOM_isclosed(lwgeom);
+}
+
 bool Postgis::ST_IsCollection(GSERIALIZED *geom) {
 	return duckdb::ST_IsCollection(geom);
 }
 
+bool Postgis::ST_IsCollection(LWGEOM *lwgeom) {
+	return duckdb::ST_IsCollection(lwgeom);
+}
+
 bool Postgis::LWGEOM_isempty(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_isempty(geom);
 }
 
+bool Postgis::LWGEOM_isempty(LWGEOM *lwgeom) {
+	return duckdb::LWGEOM_isempty(lwgeom);
+}
+
+bool Postgis::LWGEOM_isempty(const void *base, size_t size) {
+	return duckdb::LWGEOM_isempty(base, size);
+}
+
 bool Postgis::LWGEOM_isring(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_isring(geom);
 }
@@ -272,14 +518,30 @@ int Postgis::LWGEOM_npoints(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_npoints(geom);
 }
 
+int Postgis::LWGEOM_npoints(LWGEOM *lwgeom) {
+	return duckdb::LWGEOM_npoints(lwgeom);
+}
+
 int Postgis::LWGEOM_numgeometries_collection(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_numgeometries_collection(geom);
 }
 
+int Postgis::LWGEOM_numgeometries_collection(LWGEOM *lwgeom) {
+	return duckdb::LWGEOM_numgeometries_collection(lwgeom);
+}
+
+int Postgis::LWGEOM_numgeometries_collection(const void *base, size_t size) {
+	return duckdb::LWGEOM_numgeometries_collection(base, size);
+}
+
 int Postgis::LWGEOM_numpoints_linestring(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_numpoints_linestring(geom);
 }
 
+int Postgis::LWGEOM_numpoints_linestring(LWGEOM *lwgeom) {
+	return duckdb::LWGEOM_numpoints_linestring(lwgeom);
+}
+
 GSERIALIZED *Postgis::LWGEOM_pointn_linestring(GSERIALIZED *geom, int index) {
 	return duckdb::LWGEOM_pointn_linestring(geom, index);
 }
@@ -292,10 +554,26 @@ double Postgis::LWGEOM_x_point(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_x_point(geom);
 }
 
+double Postgis::LWGEOM_x_point(LWGEOM *lwgeom) {
+	return duckdb::LWGEOM_x_point(lwgeom);
+}
+
+double Postgis::LWGEOM_x_point(const void *base, size_t size) {
+	return duckdb::LWGEOM_x_point(base, size);
+}
+
 double Postgis::LWGEOM_y_point(GSERIALIZED *geom) {
 	return duckdb::LWGEOM_y_point(geom);
 }
 
+double Postgis::LWGEOM_y_point(LWGEOM *lwgeom) {
+	return duckdb::LWGEOM_y_point(lwgeom);
+}
+
+double Postgis::LWGEOM_y_point(const void *base, size_t size) {
+	return duckdb::LWGEOM_y_point(base, size);
+}
+
 double Postgis::ST_distance(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return duckdb::ST_distance(geom1, geom2);
 }
@@ -304,6 +582,42 @@ double Postgis::geography_distance(GSERIALIZED *geom1, GSERIALIZED *geom2, bool
 	return duckdb::geography_distance(geom1, geom2, use_spheroid);
 }
 
+double Postgis::geography_distance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid) {
+	return duckdb::geography_distance(lwgeom1, lwgeom2, use_spheroid);
+}
+
+double Postgis::geography_distance(CircTreeGeomCache *cache, int argnum, LWGEOM *lwgeom, bool use_spheroid) {
+	if (argnum == 1)
+		return duckdb::geography_distance(cache->lwgeom, lwgeom, use_spheroid, cache->index, NULL);
+	return duckdb::geography_distance(lwgeom, cache->lwgeom, use_spheroid, NULL, cache->index);
+}
+
+void Postgis::geography_distance_points(const POINT2D *points1, const POINT2D *points2, uint32_t count,
+                                        int32_t srid, bool use_spheroid, double *distances) {
+	duckdb::geography_distance_points(points1, points2, count, srid, use_spheroid, distances);
+}
+
+CircTreeGeomCache *Postgis::GetCircTreeGeomCache(const void *base, size_t size) {
+	return duckdb::GetCircTreeGeomCache(base, size);
+}
+
+void Postgis::FreeCircTreeGeomCache(CircTreeGeomCache *cache) {
+	duckdb::FreeCircTreeGeomCache(cache);
+}
+
+CircTreeKnnIndex *Postgis::GetCircTreeKnnIndex(const void *const *bases, const size_t *sizes, uint32_t ngeoms) {
+	return duckdb::GetCircTreeKnnIndex(bases, sizes, ngeoms);
+}
+
+void Postgis::FreeCircTreeKnnIndex(CircTreeKnnIndex *index) {
+	duckdb::FreeCircTreeKnnIndex(index);
+}
+
+uint32_t Postgis::geography_knn(const CircTreeKnnIndex *index, const LWGEOM *lwgeom, uint32_t k, bool use_spheroid,
+                                uint32_t *results) {
+	return duckdb::geography_knn(index, lwgeom, k, use_spheroid, results);
+}
+
 GSERIALIZED *Postgis::centroid(GSERIALIZED *geom) {
 	return duckdb::centroid(geom);
 }
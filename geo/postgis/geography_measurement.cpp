@@ -33,6 +33,9 @@
 #include "libpgcommon/lwgeom_transform.hpp"
 #include "postgis/geography_measurement_trees.hpp"
 
+#include <queue>
+#include <vector>
+
 namespace duckdb {
 
 #ifdef PROJ_GEODESIC
@@ -43,25 +46,59 @@ namespace duckdb {
 #define INVMINDIST 1.0e7
 #endif
 
+/*
+ * Bounds worked out on the sphere (the circles of the knn index, the reach
+ * of a dwithin grid cell) hold for spheroidal distances only once scaled:
+ * a geodesic on the spheroid can come out up to about 0.6% shorter than the
+ * great circle at the mean radius.
+ */
+#define SPHEROID_BOUND_FACTOR 0.99
+
+/*
+ * Smallest cell height of the dwithin grid, in degrees, so that row and
+ * column numbers fit in 32 bits.
+ */
+#define DWITHIN_GRID_MIN_CELL 1.0e-7
+
+/*
+ * Most cells geography_dwithin_cells lists for one geography. The grid is
+ * fixed by the distance alone, so that both sides of a join agree on it, and
+ * a wide geography at a short distance would otherwise cover billions.
+ */
+#define DWITHIN_GRID_MAX_CELLS (1 << 20)
+
 /*
  ** geography_distance(GSERIALIZED *g1, GSERIALIZED *g2, double tolerance, boolean use_spheroid)
  ** returns double distance in meters
  */
 double geography_distance(GSERIALIZED *g1, GSERIALIZED *g2, bool use_spheroid) {
+	LWGEOM *lwgeom1 = lwgeom_from_gserialized(g1);
+	LWGEOM *lwgeom2 = lwgeom_from_gserialized(g2);
+	double distance = geography_distance(lwgeom1, lwgeom2, use_spheroid);
+	lwgeom_free(lwgeom1);
+	lwgeom_free(lwgeom2);
+	return distance;
+}
+
+/*
+ * circ_tree1 and circ_tree2, when given, are cached circ trees of the arguments.
+ */
+double geography_distance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid, const CIRC_NODE *circ_tree1,
+                          const CIRC_NODE *circ_tree2) {
 	double distance;
 	SPHEROID s;
 
-	gserialized_error_if_srid_mismatch(g1, g2, __func__);
+	lwgeom_error_if_srid_mismatch(lwgeom1, lwgeom2, __func__);
 
 	/* Initialize spheroid */
-	spheroid_init_from_srid(gserialized_get_srid(g1), &s);
+	spheroid_init_from_srid(lwgeom1->srid, &s);
 
 	/* Set to sphere if requested */
 	if (!use_spheroid)
 		s.a = s.b = s.radius;
 
 	/* Return NULL on empty arguments. */
-	if (gserialized_is_empty(g1) || gserialized_is_empty(g2)) {
+	if (lwgeom_is_empty(lwgeom1) || lwgeom_is_empty(lwgeom2)) {
 		PG_ERROR_NULL();
 	}
 
@@ -70,14 +107,7 @@ double geography_distance(GSERIALIZED *g1, GSERIALIZED *g2, bool use_spheroid) {
 	// {
 	/* default to using tree-based distance calculation at all times */
 	/* in standard distance call. */
-	geography_tree_distance(g1, g2, &s, FP_TOLERANCE, &distance);
-	/*
-	LWGEOM* lwgeom1 = lwgeom_from_gserialized(g1);
-	LWGEOM* lwgeom2 = lwgeom_from_gserialized(g2);
-	distance = lwgeom_distance_spheroid(lwgeom1, lwgeom2, &s, tolerance);
-	lwgeom_free(lwgeom1);
-	lwgeom_free(lwgeom2);
-	*/
+	geography_tree_distance(lwgeom1, lwgeom2, &s, FP_TOLERANCE, &distance, circ_tree1, circ_tree2);
 	// }
 
 	/* Knock off any funny business at the nanometer level, ticket #2168 */
@@ -96,37 +126,36 @@ double geography_distance(GSERIALIZED *g1, GSERIALIZED *g2, bool use_spheroid) {
  ** returns double distance in meters
  */
 double geography_maxdistance(GSERIALIZED *g1, GSERIALIZED *g2, bool use_spheroid) {
+	LWGEOM *lwgeom1 = lwgeom_from_gserialized(g1);
+	LWGEOM *lwgeom2 = lwgeom_from_gserialized(g2);
+	double maxdistance = geography_maxdistance(lwgeom1, lwgeom2, use_spheroid);
+	lwgeom_free(lwgeom1);
+	lwgeom_free(lwgeom2);
+	return maxdistance;
+}
+
+double geography_maxdistance(LWGEOM *lwgeom1, LWGEOM *lwgeom2, bool use_spheroid, const CIRC_NODE *circ_tree1,
+                             const CIRC_NODE *circ_tree2) {
 	double maxdistance;
 	SPHEROID s;
 
-	gserialized_error_if_srid_mismatch(g1, g2, __func__);
+	lwgeom_error_if_srid_mismatch(lwgeom1, lwgeom2, __func__);
 
 	/* Initialize spheroid */
-	spheroid_init_from_srid(gserialized_get_srid(g1), &s);
+	spheroid_init_from_srid(lwgeom1->srid, &s);
 
 	/* Set to sphere if requested */
 	if (!use_spheroid)
 		s.a = s.b = s.radius;
 
 	/* Return NULL on empty arguments. */
-	if (gserialized_is_empty(g1) || gserialized_is_empty(g2)) {
+	if (lwgeom_is_empty(lwgeom1) || lwgeom_is_empty(lwgeom2)) {
 		PG_ERROR_NULL();
 	}
 
-	/* Do the brute force calculation if the cached calculation doesn't tick over */
-	// if (LW_FAILURE == geography_distance_cache(fcinfo, shared_geom1, shared_geom2, &s, &distance))
-	// {
 	/* default to using tree-based distance calculation at all times */
 	/* in standard distance call. */
-	geography_tree_maxdistance(g1, g2, &s, FP_TOLERANCE, &maxdistance);
-	/*
-	LWGEOM* lwgeom1 = lwgeom_from_gserialized(g1);
-	LWGEOM* lwgeom2 = lwgeom_from_gserialized(g2);
-	distance = lwgeom_distance_spheroid(lwgeom1, lwgeom2, &s, tolerance);
-	lwgeom_free(lwgeom1);
-	lwgeom_free(lwgeom2);
-	*/
-	// }
+	geography_tree_maxdistance(lwgeom1, lwgeom2, &s, FP_TOLERANCE, &maxdistance, circ_tree1, circ_tree2);
 
 	/* Knock off any funny business at the nanometer level, ticket #2168 */
 	maxdistance = round(maxdistance * INVMINDIST) / INVMINDIST;
@@ -144,26 +173,23 @@ double geography_maxdistance(GSERIALIZED *g1, GSERIALIZED *g2, bool use_spheroid
 ** returns double area in meters square
 */
 double geography_area(GSERIALIZED *g, bool use_spheroid) {
-	LWGEOM *lwgeom = NULL;
-	GBOX gbox;
+	LWGEOM *lwgeom = lwgeom_from_gserialized(g);
+	double area = geography_area(lwgeom, use_spheroid);
+	lwgeom_free(lwgeom);
+	return area;
+}
+
+double geography_area(LWGEOM *lwgeom, bool use_spheroid) {
 	double area;
 	SPHEROID s;
 
-	/* Initialize spheroid */
-	spheroid_init_from_srid(gserialized_get_srid(g), &s);
-
-	lwgeom = lwgeom_from_gserialized(g);
-
 	/* EMPTY things have no area */
 	if (lwgeom_is_empty(lwgeom)) {
-		lwgeom_free(lwgeom);
 		return 0.0;
 	}
 
-	if (lwgeom->bbox)
-		gbox = *(lwgeom->bbox);
-	else
-		lwgeom_calculate_gbox_geodetic(lwgeom, &gbox);
+	/* Initialize spheroid */
+	spheroid_init_from_srid(lwgeom->srid, &s);
 
 	/* User requests spherical calculation, turn our spheroid into a sphere */
 	if (!use_spheroid)
@@ -175,9 +201,6 @@ double geography_area(GSERIALIZED *g, bool use_spheroid) {
 	else
 		area = lwgeom_area_sphere(lwgeom, &s);
 
-	/* Clean up */
-	lwgeom_free(lwgeom);
-
 	/* Something went wrong... */
 	if (area < 0.0) {
 		throw "lwgeom_area_spher(oid) returned area < 0.0";
@@ -192,27 +215,36 @@ double geography_area(GSERIALIZED *g, bool use_spheroid) {
 ** returns double perimeter in meters for area features
 */
 double geography_perimeter(GSERIALIZED *g, bool use_spheroid) {
-	LWGEOM *lwgeom = NULL;
+	/* Only return for area features. */
+	int type = gserialized_get_type(g);
+	if (!(type == POLYGONTYPE || type == MULTIPOLYGONTYPE || type == COLLECTIONTYPE)) {
+		return 0.0;
+	}
+
+	LWGEOM *lwgeom = lwgeom_from_gserialized(g);
+	double length = geography_perimeter(lwgeom, use_spheroid);
+	lwgeom_free(lwgeom);
+	return length;
+}
+
+double geography_perimeter(LWGEOM *lwgeom, bool use_spheroid) {
 	double length;
 	SPHEROID s;
 	int type;
 
 	/* Only return for area features. */
-	type = gserialized_get_type(g);
+	type = lwgeom->type;
 	if (!(type == POLYGONTYPE || type == MULTIPOLYGONTYPE || type == COLLECTIONTYPE)) {
 		return 0.0;
 	}
 
-	lwgeom = lwgeom_from_gserialized(g);
-
 	/* EMPTY things have no perimeter */
 	if (lwgeom_is_empty(lwgeom)) {
-		lwgeom_free(lwgeom);
 		return 0.0;
 	}
 
 	/* Initialize spheroid */
-	spheroid_init_from_srid(gserialized_get_srid(g), &s);
+	spheroid_init_from_srid(lwgeom->srid, &s);
 
 	/* User requests spherical calculation, turn our spheroid into a sphere */
 	if (!use_spheroid)
@@ -227,9 +259,6 @@ double geography_perimeter(GSERIALIZED *g, bool use_spheroid) {
 		return 0.0;
 	}
 
-	/* Clean up, but not all the way to the point arrays */
-	lwgeom_free(lwgeom);
-
 	return length;
 }
 
@@ -239,41 +268,41 @@ double geography_perimeter(GSERIALIZED *g, bool use_spheroid) {
 ** azimuth (bearing) and distance
 */
 double geography_azimuth(GSERIALIZED *g1, GSERIALIZED *g2) {
-	LWGEOM *lwgeom1 = NULL;
-	LWGEOM *lwgeom2 = NULL;
+	/* Only return for points. */
+	if (gserialized_get_type(g1) != POINTTYPE || gserialized_get_type(g2) != POINTTYPE) {
+		return std::numeric_limits<double>::quiet_NaN();
+	}
+
+	LWGEOM *lwgeom1 = lwgeom_from_gserialized(g1);
+	LWGEOM *lwgeom2 = lwgeom_from_gserialized(g2);
+	double azimuth = geography_azimuth(lwgeom1, lwgeom2);
+	lwgeom_free(lwgeom1);
+	lwgeom_free(lwgeom2);
+	return azimuth;
+}
+
+double geography_azimuth(LWGEOM *lwgeom1, LWGEOM *lwgeom2) {
 	double azimuth;
 	SPHEROID s;
-	uint32_t type1, type2;
 
 	/* Only return for points. */
-	type1 = gserialized_get_type(g1);
-	type2 = gserialized_get_type(g2);
-	if (type1 != POINTTYPE || type2 != POINTTYPE) {
+	if (lwgeom1->type != POINTTYPE || lwgeom2->type != POINTTYPE) {
 		// throw "ST_Azimuth(geography, geography) is only valid for point inputs";
 		return std::numeric_limits<double>::quiet_NaN();
 	}
 
-	lwgeom1 = lwgeom_from_gserialized(g1);
-	lwgeom2 = lwgeom_from_gserialized(g2);
-
 	/* EMPTY things cannot be used */
 	if (lwgeom_is_empty(lwgeom1) || lwgeom_is_empty(lwgeom2)) {
-		lwgeom_free(lwgeom1);
-		lwgeom_free(lwgeom2);
 		// throw "ST_Azimuth(geography, geography) cannot work with empty points";
 		return std::numeric_limits<double>::quiet_NaN();
 	}
 
 	/* Initialize spheroid */
-	spheroid_init_from_srid(gserialized_get_srid(g1), &s);
+	spheroid_init_from_srid(lwgeom1->srid, &s);
 
 	/* Calculate the direction */
 	azimuth = lwgeom_azumith_spheroid(lwgeom_as_lwpoint(lwgeom1), lwgeom_as_lwpoint(lwgeom2), &s);
 
-	/* Clean up */
-	lwgeom_free(lwgeom1);
-	lwgeom_free(lwgeom2);
-
 	/* Return NULL for unknown (same point) azimuth */
 	if (std::isnan(azimuth)) {
 		return std::numeric_limits<double>::quiet_NaN();
@@ -287,21 +316,24 @@ double geography_azimuth(GSERIALIZED *g1, GSERIALIZED *g2) {
 ** returns double length in meters
 */
 double geography_length(GSERIALIZED *g, bool use_spheroid) {
-	LWGEOM *lwgeom = NULL;
+	/* Get our geometry object loaded into memory. */
+	LWGEOM *lwgeom = lwgeom_from_gserialized(g);
+	double length = geography_length(lwgeom, use_spheroid);
+	lwgeom_free(lwgeom);
+	return length;
+}
+
+double geography_length(LWGEOM *lwgeom, bool use_spheroid) {
 	double length;
 	SPHEROID s;
 
-	/* Get our geometry object loaded into memory. */
-	lwgeom = lwgeom_from_gserialized(g);
-
 	/* EMPTY things have no length */
 	if (lwgeom_is_empty(lwgeom) || lwgeom->type == POLYGONTYPE || lwgeom->type == MULTIPOLYGONTYPE) {
-		lwgeom_free(lwgeom);
 		return 0.0;
 	}
 
 	/* Initialize spheroid */
-	spheroid_init_from_srid(gserialized_get_srid(g), &s);
+	spheroid_init_from_srid(lwgeom->srid, &s);
 
 	/* User requests spherical calculation, turn our spheroid into a sphere */
 	if (!use_spheroid)
@@ -316,9 +348,6 @@ double geography_length(GSERIALIZED *g, bool use_spheroid) {
 		return 0.0;
 	}
 
-	/* Clean up */
-	lwgeom_free(lwgeom);
-
 	return length;
 }
 
@@ -327,34 +356,376 @@ double geography_length(GSERIALIZED *g, bool use_spheroid) {
 ** returns double distance in meters
 */
 bool geography_dwithin(GSERIALIZED *g1, GSERIALIZED *g2, double tolerance, bool use_spheroid) {
+	LWGEOM *lwgeom1 = lwgeom_from_gserialized(g1);
+	LWGEOM *lwgeom2 = lwgeom_from_gserialized(g2);
+	bool dwithin = geography_dwithin(lwgeom1, lwgeom2, tolerance, use_spheroid);
+	lwgeom_free(lwgeom1);
+	lwgeom_free(lwgeom2);
+	return dwithin;
+}
+
+/*
+ * With a cached circ tree of either argument the distance comes from the
+ * trees, as in PostGIS's cached dwithin, instead of the brute force
+ * calculation.
+ */
+bool geography_dwithin(LWGEOM *lwgeom1, LWGEOM *lwgeom2, double tolerance, bool use_spheroid,
+                       const CIRC_NODE *circ_tree1, const CIRC_NODE *circ_tree2) {
 	SPHEROID s;
 	double distance;
-	int dwithin = LW_FALSE;
 
-	gserialized_error_if_srid_mismatch(g1, g2, __func__);
+	lwgeom_error_if_srid_mismatch(lwgeom1, lwgeom2, __func__);
 
 	/* Initialize spheroid */
-	spheroid_init_from_srid(gserialized_get_srid(g1), &s);
+	spheroid_init_from_srid(lwgeom1->srid, &s);
 
 	/* Set to sphere if requested */
 	if (!use_spheroid)
 		s.a = s.b = s.radius;
 
 	/* Return FALSE on empty arguments. */
-	if (gserialized_is_empty(g1) || gserialized_is_empty(g2))
+	if (lwgeom_is_empty(lwgeom1) || lwgeom_is_empty(lwgeom2))
 		return false;
 
-	LWGEOM *lwgeom1 = lwgeom_from_gserialized(g1);
-	LWGEOM *lwgeom2 = lwgeom_from_gserialized(g2);
-	distance = lwgeom_distance_spheroid(lwgeom1, lwgeom2, &s, tolerance);
+	if (circ_tree1 || circ_tree2)
+		geography_tree_distance(lwgeom1, lwgeom2, &s, tolerance, &distance, circ_tree1, circ_tree2);
+	else
+		distance = lwgeom_distance_spheroid(lwgeom1, lwgeom2, &s, tolerance);
 	/* Something went wrong... */
 	if (distance < 0.0)
 		return false;
-	dwithin = (distance <= tolerance);
-	lwgeom_free(lwgeom1);
-	lwgeom_free(lwgeom2);
 
-	return dwithin;
+	return distance <= tolerance;
+}
+
+/*
+ * geography_distance over count pairs of non-empty points of one srid,
+ * measured straight from their coordinates without building geometries
+ * or circ trees.
+ */
+void geography_distance_points(const POINT2D *points1, const POINT2D *points2, uint32_t count, int32_t srid,
+                               bool use_spheroid, double *distances) {
+	SPHEROID s;
+	uint32_t i;
+
+	/* Initialize spheroid */
+	spheroid_init_from_srid(srid, &s);
+
+	/* Set to sphere if requested */
+	if (!use_spheroid)
+		s.a = s.b = s.radius;
+
+	lwpoints_distance_spheroid(points1, points2, count, &s, NULL, distances);
+
+	for (i = 0; i < count; i++) {
+		/* Knock off any funny business at the nanometer level, ticket #2168 */
+		distances[i] = round(distances[i] * INVMINDIST) / INVMINDIST;
+	}
+}
+
+/*
+ * geography_dwithin over count pairs of non-empty points of one srid, with
+ * one tolerance per pair.
+ */
+void geography_dwithin_points(const POINT2D *points1, const POINT2D *points2, const double *tolerances,
+                              uint32_t count, int32_t srid, bool use_spheroid, bool *results) {
+	SPHEROID s;
+	uint32_t i;
+	double *distances = (double *)lwalloc(sizeof(double) * count);
+
+	/* Initialize spheroid */
+	spheroid_init_from_srid(srid, &s);
+
+	/* Set to sphere if requested */
+	if (!use_spheroid)
+		s.a = s.b = s.radius;
+
+	lwpoints_distance_spheroid(points1, points2, count, &s, tolerances, distances);
+
+	for (i = 0; i < count; i++)
+		results[i] = distances[i] <= tolerances[i];
+
+	lwfree(distances);
+}
+
+/*
+ * An entry of the knn search queue: a node of the index with a lower bound
+ * of its distance, or a member with its exact distance when node is NULL.
+ */
+struct KnnQueueEntry {
+	double distance;
+	const CIRC_NODE *node;
+	uint32_t member;
+};
+
+/*
+ * Orders the queue nearest first. On a tie nodes come out before members, so
+ * that every member at that distance is measured before any is reported, and
+ * members come out by position.
+ */
+struct KnnQueueCompare {
+	bool operator()(const KnnQueueEntry &a, const KnnQueueEntry &b) const {
+		if (a.distance != b.distance)
+			return a.distance > b.distance;
+		if ((a.node == NULL) != (b.node == NULL))
+			return a.node == NULL;
+		return a.member > b.member;
+	}
+};
+
+/*
+ * Write the positions in index of the (at most) k members nearest to lwgeom
+ * to results, nearest first, and return how many were written. The index is
+ * walked best first: the circles of its nodes give lower bounds, and only
+ * the members that reach the head of the queue are measured exactly, so the
+ * members reported are those geography_distance would rank first.
+ */
+uint32_t geography_knn(const CircTreeKnnIndex *index, const LWGEOM *lwgeom, uint32_t k, bool use_spheroid,
+                       uint32_t *results) {
+	std::priority_queue<KnnQueueEntry, std::vector<KnnQueueEntry>, KnnQueueCompare> queue;
+	CIRC_NODE *circ_tree;
+	SPHEROID s;
+	double bound_scale;
+	uint32_t i, num_results = 0;
+
+	if (!index->root || k == 0 || lwgeom_is_empty(lwgeom))
+		return 0;
+
+	/* Initialize spheroid */
+	spheroid_init_from_srid(lwgeom->srid, &s);
+
+	/* Set to sphere if requested */
+	if (!use_spheroid)
+		s.a = s.b = s.radius;
+	bound_scale = use_spheroid ? s.radius * SPHEROID_BOUND_FACTOR : s.radius;
+
+	circ_tree = lwgeom_calculate_circ_tree(lwgeom);
+	queue.push({circ_node_min_distance(circ_tree, index->root) * bound_scale, index->root, 0});
+
+	while (!queue.empty() && num_results < k) {
+		KnnQueueEntry entry = queue.top();
+		queue.pop();
+
+		/* A measured member, nothing left in the queue can be nearer */
+		if (!entry.node) {
+			results[num_results++] = entry.member;
+			continue;
+		}
+
+		/* A leaf of the index stands for one member, measure it */
+		if (entry.node->num_nodes == 0) {
+			const CircTreeGeomCache *member = index->geoms[entry.node->edge_num];
+			double distance;
+
+			lwgeom_error_if_srid_mismatch(lwgeom, member->lwgeom, __func__);
+			geography_tree_distance(lwgeom, member->lwgeom, &s, FP_TOLERANCE, &distance, circ_tree, member->index);
+
+			/* Knock off any funny business at the nanometer level, ticket #2168 */
+			distance = round(distance * INVMINDIST) / INVMINDIST;
+			queue.push({distance, NULL, (uint32_t)entry.node->edge_num});
+			continue;
+		}
+
+		for (i = 0; i < entry.node->num_nodes; i++) {
+			const CIRC_NODE *child = entry.node->nodes[i];
+			queue.push({circ_node_min_distance(circ_tree, child) * bound_scale, child, 0});
+		}
+	}
+
+	circ_tree_free(circ_tree);
+	return num_results;
+}
+
+/*
+ * The dwithin grid cuts the sphere into rows of latitude as high as the
+ * search distance, and every row into as many columns as keep their width
+ * at least that distance at the row edge farthest from the equator. A point
+ * lies in one cell, and every point within the distance of a geography lies
+ * in one of the cells geography_dwithin_cells lists for it, so pairs that
+ * share a cell are the only candidates of a dwithin join.
+ */
+typedef struct {
+	double cell;    /* row height in degrees */
+	uint32_t nrows;
+	double reach;   /* search distance in degrees, with the spheroid slack */
+} DWITHIN_GRID;
+
+static void dwithin_grid_init(int32_t srid, double distance, DWITHIN_GRID *grid) {
+	SPHEROID s;
+	spheroid_init_from_srid(srid, &s);
+	grid->reach = rad2deg(distance / (s.radius * SPHEROID_BOUND_FACTOR));
+	grid->cell = FP_MIN(FP_MAX(grid->reach, DWITHIN_GRID_MIN_CELL), 180.0);
+	grid->nrows = (uint32_t)ceil(180.0 / grid->cell);
+}
+
+static uint32_t dwithin_grid_row(const DWITHIN_GRID *grid, double lat) {
+	double row = floor((lat + 90.0) / grid->cell);
+	if (row < 0)
+		return 0;
+	return row >= grid->nrows ? grid->nrows - 1 : (uint32_t)row;
+}
+
+static uint32_t dwithin_grid_ncols(const DWITHIN_GRID *grid, uint32_t row) {
+	double lat1 = fabs(-90.0 + row * grid->cell);
+	double lat2 = fabs(FP_MIN(-90.0 + (row + 1) * grid->cell, 90.0));
+	double ncols = floor(360.0 * cos(deg2rad(FP_MAX(lat1, lat2))) / grid->cell);
+	return ncols < 1 ? 1 : (uint32_t)ncols;
+}
+
+/* Column of a longitude, counted without wrapping around the antimeridian */
+static int64_t dwithin_grid_col(double lon, uint32_t ncols) {
+	return (int64_t)floor((lon + 180.0) / 360.0 * ncols);
+}
+
+static uint64_t dwithin_grid_key(uint32_t row, int64_t col, uint32_t ncols) {
+	col %= ncols;
+	if (col < 0)
+		col += ncols;
+	return ((uint64_t)row << 32) | (uint64_t)col;
+}
+
+/* Columns col1 to col2 of a row with ncols columns, all of them once the span wraps around */
+static void dwithin_grid_cols(const DWITHIN_GRID *grid, uint32_t row, double lon1, double lon2, bool full,
+                              uint32_t *ncols, int64_t *col1, int64_t *col2) {
+	*ncols = dwithin_grid_ncols(grid, row);
+	*col1 = full ? 0 : dwithin_grid_col(lon1, *ncols);
+	*col2 = full ? *ncols - 1 : dwithin_grid_col(lon2, *ncols);
+	if (*col2 - *col1 + 1 >= *ncols) {
+		*col1 = 0;
+		*col2 = *ncols - 1;
+	}
+}
+
+/*
+ * The cells of rows row1 to row2 that hold longitudes lon1 to lon2, or all
+ * of them when full. Counts them first, and lists none when they are more
+ * than DWITHIN_GRID_MAX_CELLS.
+ */
+static int dwithin_grid_add_cells(const DWITHIN_GRID *grid, uint32_t row1, uint32_t row2, double lon1, double lon2,
+                                  bool full, std::vector<uint64_t> &cells) {
+	uint32_t row, ncols;
+	int64_t col, col1, col2;
+	uint64_t total = 0;
+
+	if (row2 - row1 >= DWITHIN_GRID_MAX_CELLS)
+		return LW_FAILURE;
+	for (row = row1; row <= row2; row++) {
+		dwithin_grid_cols(grid, row, lon1, lon2, full, &ncols, &col1, &col2);
+		total += col2 - col1 + 1;
+		if (total > DWITHIN_GRID_MAX_CELLS)
+			return LW_FAILURE;
+	}
+
+	cells.reserve(cells.size() + total);
+	for (row = row1; row <= row2; row++) {
+		dwithin_grid_cols(grid, row, lon1, lon2, full, &ncols, &col1, &col2);
+		for (col = col1; col <= col2; col++)
+			cells.push_back(dwithin_grid_key(row, col, ncols));
+	}
+	return LW_SUCCESS;
+}
+
+/*
+ * The cells that hold every point within reach of a geography whose points
+ * lie at latitudes lat1 to lat2 and longitudes lon1 to lon2 (any longitude
+ * when all_lons). Around a point at latitude lat the longitudes within reach
+ * are bounded by asin(sin(reach) / cos(lat)), unless the reach takes in a
+ * pole.
+ */
+static int dwithin_grid_add_reach(const DWITHIN_GRID *grid, double lat1, double lat2, double lon1, double lon2,
+                                  bool all_lons, std::vector<uint64_t> &cells) {
+	double max_lat = FP_MAX(fabs(lat1), fabs(lat2));
+	double dlon = 0;
+	bool full = all_lons || max_lat + grid->reach >= 90.0;
+
+	if (!full) {
+		double ratio = sin(deg2rad(grid->reach)) / cos(deg2rad(max_lat));
+		full = ratio >= 1.0;
+		if (!full)
+			dlon = rad2deg(asin(ratio));
+	}
+	return dwithin_grid_add_cells(grid, dwithin_grid_row(grid, lat1 - grid->reach),
+	                              dwithin_grid_row(grid, lat2 + grid->reach), lon1 - dlon, lon2 + dlon, full, cells);
+}
+
+/*
+ * The cell of the dwithin grid for distance that holds point.
+ */
+uint64_t geography_dwithin_cell(const POINT2D *point, int32_t srid, double distance) {
+	DWITHIN_GRID grid;
+	uint32_t row, ncols;
+
+	dwithin_grid_init(srid, distance, &grid);
+	row = dwithin_grid_row(&grid, point->y);
+	ncols = dwithin_grid_ncols(&grid, row);
+	return dwithin_grid_key(row, dwithin_grid_col(point->x, ncols), ncols);
+}
+
+/*
+ * The cells of the dwithin grid for distance that hold every point within
+ * distance of point. A point reaches at most a few hundred cells, even next
+ * to a pole, so these always fit DWITHIN_GRID_MAX_CELLS.
+ */
+void geography_dwithin_cells(const POINT2D *point, int32_t srid, double distance, std::vector<uint64_t> &cells) {
+	DWITHIN_GRID grid;
+	dwithin_grid_init(srid, distance, &grid);
+	dwithin_grid_add_reach(&grid, point->y, point->y, point->x, point->x, false, cells);
+}
+
+/*
+ * geography_dwithin_cells for any geography. Lines and polygons are bounded
+ * by their geodetic box, which follows the edges between the vertices: its
+ * z range gives the latitudes, and unless it holds the axis of the sphere
+ * the corners of its x/y range give the longitudes.
+ * Returns LW_FAILURE, listing nothing, when the geography reaches more than
+ * DWITHIN_GRID_MAX_CELLS cells at this distance.
+ */
+int geography_dwithin_cells(const LWGEOM *lwgeom, double distance, std::vector<uint64_t> &cells) {
+	DWITHIN_GRID grid;
+	GBOX gbox;
+	double lat1, lat2, lon1 = 0, lon2 = 0;
+	bool all_lons;
+
+	if (lwgeom_is_empty(lwgeom))
+		return LW_SUCCESS;
+
+	if (lwgeom->type == POINTTYPE) {
+		POINT4D pt;
+		POINT2D point;
+		lwpoint_getPoint4d_p((LWPOINT *)lwgeom, &pt);
+		point.x = pt.x;
+		point.y = pt.y;
+		geography_dwithin_cells(&point, lwgeom->srid, distance, cells);
+		return LW_SUCCESS;
+	}
+
+	lwgeom_calculate_gbox_geodetic(lwgeom, &gbox);
+	lat1 = rad2deg(asin(FP_MAX(gbox.zmin, -1.0)));
+	lat2 = rad2deg(asin(FP_MIN(gbox.zmax, 1.0)));
+
+	all_lons = gbox.xmin <= 0 && gbox.xmax >= 0 && gbox.ymin <= 0 && gbox.ymax >= 0;
+	if (!all_lons) {
+		/* The box misses the axis, so its corners span less than half a turn around the centre direction */
+		double xs[2] = {gbox.xmin, gbox.xmax};
+		double ys[2] = {gbox.ymin, gbox.ymax};
+		double center = rad2deg(atan2((gbox.ymin + gbox.ymax) / 2, (gbox.xmin + gbox.xmax) / 2));
+		int i, j;
+		lon1 = lon2 = center;
+		for (i = 0; i < 2; i++) {
+			for (j = 0; j < 2; j++) {
+				double offset = rad2deg(atan2(ys[j], xs[i])) - center;
+				if (offset > 180.0)
+					offset -= 360.0;
+				else if (offset < -180.0)
+					offset += 360.0;
+				lon1 = FP_MIN(lon1, center + offset);
+				lon2 = FP_MAX(lon2, center + offset);
+			}
+		}
+	}
+
+	dwithin_grid_init(lwgeom->srid, distance, &grid);
+	return dwithin_grid_add_reach(&grid, lat1, lat2, lon1, lon2, all_lons, cells);
 }
 
 } // namespace duckdb
@@ -29,8 +29,8 @@
 
 namespace duckdb {
 
-static int CircTreePIP(const CIRC_NODE *tree1, const GSERIALIZED *g1, const POINT4D *in_point) {
-	int tree1_type = gserialized_get_type(g1);
+static int CircTreePIP(const CIRC_NODE *tree1, const LWGEOM *lwgeom1, const POINT4D *in_point) {
+	int tree1_type = lwgeom1->type;
 	GBOX gbox1;
 	GEOGRAPHIC_POINT in_gpoint;
 	POINT3D in_point3d;
@@ -38,11 +38,10 @@ static int CircTreePIP(const CIRC_NODE *tree1, const GSERIALIZED *g1, const POIN
 	/* If the tree'ed argument is a polygon, do the P-i-P using the tree-based P-i-P */
 	if (tree1_type == POLYGONTYPE || tree1_type == MULTIPOLYGONTYPE) {
 		/* Need a gbox to calculate an outside point */
-		if (LW_FAILURE == gserialized_get_gbox_p(g1, &gbox1)) {
-			LWGEOM *lwgeom1 = lwgeom_from_gserialized(g1);
-			lwgeom_calculate_gbox_geodetic(lwgeom1, &gbox1);
-			lwgeom_free(lwgeom1);
-		}
+		if (lwgeom1->bbox)
+			gbox1 = *(lwgeom1->bbox);
+		else
+			lwgeom_calculate_gbox(lwgeom1, &gbox1);
 
 		/* Flip the candidate point into geographics */
 		geographic_point_init(in_point->x, in_point->y, &in_gpoint);
@@ -70,57 +69,144 @@ static int CircTreePIP(const CIRC_NODE *tree1, const GSERIALIZED *g1, const POIN
 	}
 }
 
+CircTreeGeomCache *GetCircTreeGeomCache(const void *base, size_t size) {
+	LWGEOM *lwgeom = lwgeom_from_wkb(static_cast<const uint8_t *>(base), size, LW_PARSER_CHECK_NONE);
+	if (!lwgeom)
+		return NULL;
+
+	/* CircTreePIP needs the box, compute it once instead of on every call */
+	lwgeom_add_bbox(lwgeom);
+
+	CircTreeGeomCache *cache = (CircTreeGeomCache *)lwalloc(sizeof(CircTreeGeomCache));
+	cache->lwgeom = lwgeom;
+	cache->index = lwgeom_calculate_circ_tree(lwgeom);
+	return cache;
+}
+
+void FreeCircTreeGeomCache(CircTreeGeomCache *cache) {
+	if (!cache)
+		return;
+	if (cache->index)
+		circ_tree_free(cache->index);
+	lwgeom_free(cache->lwgeom);
+	lwfree(cache);
+}
+
+/*
+ * Members with a NULL base are left out of the index. Returns NULL when a
+ * member can not be decoded.
+ */
+CircTreeKnnIndex *GetCircTreeKnnIndex(const void *const *bases, const size_t *sizes, uint32_t ngeoms) {
+	CircTreeKnnIndex *index = (CircTreeKnnIndex *)lwalloc(sizeof(CircTreeKnnIndex));
+	CIRC_NODE **roots;
+	uint32_t i;
+
+	index->ngeoms = ngeoms;
+	index->geoms = (CircTreeGeomCache **)lwalloc(sizeof(CircTreeGeomCache *) * (ngeoms ? ngeoms : 1));
+	index->root = NULL;
+	for (i = 0; i < ngeoms; i++)
+		index->geoms[i] = NULL;
+
+	roots = (CIRC_NODE **)lwalloc(sizeof(CIRC_NODE *) * (ngeoms ? ngeoms : 1));
+	for (i = 0; i < ngeoms; i++) {
+		roots[i] = NULL;
+		if (!bases[i])
+			continue;
+		index->geoms[i] = GetCircTreeGeomCache(bases[i], sizes[i]);
+		if (!index->geoms[i]) {
+			lwfree(roots);
+			FreeCircTreeKnnIndex(index);
+			return NULL;
+		}
+		/* Empty members have no tree and never turn up in a search */
+		roots[i] = index->geoms[i]->index;
+	}
+
+	index->root = circ_tree_new_forest(roots, ngeoms);
+	lwfree(roots);
+	return index;
+}
+
+void FreeCircTreeKnnIndex(CircTreeKnnIndex *index) {
+	uint32_t i;
+	if (!index)
+		return;
+	if (index->root)
+		circ_tree_free(index->root);
+	for (i = 0; i < index->ngeoms; i++)
+		FreeCircTreeGeomCache(index->geoms[i]);
+	lwfree(index->geoms);
+	lwfree(index);
+}
+
 int geography_tree_distance(const GSERIALIZED *g1, const GSERIALIZED *g2, const SPHEROID *s, double tolerance,
                             double *distance) {
-	CIRC_NODE *circ_tree1 = NULL;
-	CIRC_NODE *circ_tree2 = NULL;
-	LWGEOM *lwgeom1 = NULL;
-	LWGEOM *lwgeom2 = NULL;
+	LWGEOM *lwgeom1 = lwgeom_from_gserialized(g1);
+	LWGEOM *lwgeom2 = lwgeom_from_gserialized(g2);
+	int ret = geography_tree_distance(lwgeom1, lwgeom2, s, tolerance, distance);
+	lwgeom_free(lwgeom1);
+	lwgeom_free(lwgeom2);
+	return ret;
+}
+
+/*
+ * circ_tree1 and circ_tree2 may be passed in when the caller keeps the tree
+ * of an argument cached, the missing ones are built here.
+ */
+int geography_tree_distance(const LWGEOM *lwgeom1, const LWGEOM *lwgeom2, const SPHEROID *s, double tolerance,
+                            double *distance, const CIRC_NODE *circ_tree1, const CIRC_NODE *circ_tree2) {
+	CIRC_NODE *built_tree1 = NULL;
+	CIRC_NODE *built_tree2 = NULL;
 	POINT4D pt1, pt2;
 
-	lwgeom1 = lwgeom_from_gserialized(g1);
-	lwgeom2 = lwgeom_from_gserialized(g2);
-	circ_tree1 = lwgeom_calculate_circ_tree(lwgeom1);
-	circ_tree2 = lwgeom_calculate_circ_tree(lwgeom2);
+	if (!circ_tree1)
+		circ_tree1 = built_tree1 = lwgeom_calculate_circ_tree(lwgeom1);
+	if (!circ_tree2)
+		circ_tree2 = built_tree2 = lwgeom_calculate_circ_tree(lwgeom2);
 	lwgeom_startpoint(lwgeom1, &pt1);
 	lwgeom_startpoint(lwgeom2, &pt2);
 
-	if (CircTreePIP(circ_tree1, g1, &pt2) || CircTreePIP(circ_tree2, g2, &pt1)) {
+	if (CircTreePIP(circ_tree1, lwgeom1, &pt2) || CircTreePIP(circ_tree2, lwgeom2, &pt1)) {
 		*distance = 0.0;
 	} else {
 		/* Calculate tree/tree distance */
 		*distance = circ_tree_distance_tree(circ_tree1, circ_tree2, s, tolerance);
 	}
 
-	circ_tree_free(circ_tree1);
-	circ_tree_free(circ_tree2);
-	lwgeom_free(lwgeom1);
-	lwgeom_free(lwgeom2);
+	if (built_tree1)
+		circ_tree_free(built_tree1);
+	if (built_tree2)
+		circ_tree_free(built_tree2);
 	return LW_SUCCESS;
 }
 
 int geography_tree_maxdistance(const GSERIALIZED *g1, const GSERIALIZED *g2, const SPHEROID *s, double tolerance,
                                double *maxdistance) {
-	CIRC_NODE *circ_tree1 = NULL;
-	CIRC_NODE *circ_tree2 = NULL;
-	LWGEOM *lwgeom1 = NULL;
-	LWGEOM *lwgeom2 = NULL;
-	POINT4D pt1, pt2;
+	LWGEOM *lwgeom1 = lwgeom_from_gserialized(g1);
+	LWGEOM *lwgeom2 = lwgeom_from_gserialized(g2);
+	int ret = geography_tree_maxdistance(lwgeom1, lwgeom2, s, tolerance, maxdistance);
+	lwgeom_free(lwgeom1);
+	lwgeom_free(lwgeom2);
+	return ret;
+}
 
-	lwgeom1 = lwgeom_from_gserialized(g1);
-	lwgeom2 = lwgeom_from_gserialized(g2);
-	circ_tree1 = lwgeom_calculate_circ_tree(lwgeom1);
-	circ_tree2 = lwgeom_calculate_circ_tree(lwgeom2);
-	lwgeom_startpoint(lwgeom1, &pt1);
-	lwgeom_startpoint(lwgeom2, &pt2);
+int geography_tree_maxdistance(const LWGEOM *lwgeom1, const LWGEOM *lwgeom2, const SPHEROID *s, double tolerance,
+                               double *maxdistance, const CIRC_NODE *circ_tree1, const CIRC_NODE *circ_tree2) {
+	CIRC_NODE *built_tree1 = NULL;
+	CIRC_NODE *built_tree2 = NULL;
+
+	if (!circ_tree1)
+		circ_tree1 = built_tree1 = lwgeom_calculate_circ_tree(lwgeom1);
+	if (!circ_tree2)
+		circ_tree2 = built_tree2 = lwgeom_calculate_circ_tree(lwgeom2);
 
 	/* Calculate tree/tree maxdistance */
 	*maxdistance = circ_tree_maxdistance_tree(circ_tree1, circ_tree2, s, tolerance);
 
-	circ_tree_free(circ_tree1);
-	circ_tree_free(circ_tree2);
-	lwgeom_free(lwgeom1);
-	lwgeom_free(lwgeom2);
+	if (built_tree1)
+		circ_tree_free(built_tree1);
+	if (built_tree2)
+		circ_tree_free(built_tree2);
 	return LW_SUCCESS;
 }
 
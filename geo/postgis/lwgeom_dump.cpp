@@ -76,4 +76,28 @@ std::vector<GSERIALIZED *> LWGEOM_dump(GSERIALIZED *geom) {
 	return ret;
 }
 
+/*
+ * Locate the dumped components inside the stored EWKB without decoding
+ * it. Returns false when the geometry needs the LWGEOM_dump path.
+ */
+bool LWGEOM_dump_components(const void *base, size_t size, int32_t *srid, std::vector<WKB_COMPONENT> &components) {
+	WKB_COMPONENT *comps;
+	uint32_t ncomps;
+
+	if (wkb_peek_components(static_cast<const uint8_t *>(base), size, srid, &comps, &ncomps) == LW_FAILURE)
+		return false;
+
+	components.assign(comps, comps + ncomps);
+	lwfree(comps);
+	return true;
+}
+
+size_t LWGEOM_dump_component_size(const WKB_COMPONENT &component, int32_t srid) {
+	return wkb_component_size(&component, srid);
+}
+
+size_t LWGEOM_dump_component_write(const void *base, const WKB_COMPONENT &component, int32_t srid, char *buffer) {
+	return wkb_component_write(static_cast<const uint8_t *>(base), &component, srid, (uint8_t *)buffer);
+}
+
 } // namespace duckdb
@@ -29,17 +29,18 @@
 namespace duckdb {
 
 lwvarlena_t *LWGEOM_asGeoJson(GSERIALIZED *geom, size_t m_dec_digits) {
-	LWGEOM *lwgeom;
+	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
+	auto geojson = LWGEOM_asGeoJson(lwgeom, m_dec_digits);
+	lwgeom_free(lwgeom);
+	return geojson;
+}
+
+lwvarlena_t *LWGEOM_asGeoJson(LWGEOM *lwgeom, size_t m_dec_digits) {
 	int precision = m_dec_digits;
 	int output_bbox = LW_FALSE;
 	const char *srs = NULL;
-	// int32_t srid;
-	// srid = gserialized_get_srid(geom);
 
-	lwgeom = lwgeom_from_gserialized(geom);
-	auto geojson = lwgeom_to_geojson(lwgeom, srs, precision, output_bbox);
-	lwgeom_free(lwgeom);
-	return geojson;
+	return lwgeom_to_geojson(lwgeom, srs, precision, output_bbox);
 }
 
 } // namespace duckdb
@@ -26,9 +26,12 @@
 
 #include "liblwgeom/gserialized.hpp"
 #include "liblwgeom/liblwgeom.hpp"
+#include "liblwgeom/liblwgeom_internal.hpp"
 #include "liblwgeom/lwinline.hpp"
 #include "libpgcommon/lwgeom_pg.hpp"
 
+#include <float.h>
+
 namespace duckdb {
 
 static int point_in_ring(POINTARRAY *pts, const POINT2D *point);
@@ -254,6 +257,45 @@ static int isOnSegment(const POINT2D *seg1, const POINT2D *seg2, const POINT2D *
 	return 1;
 }
 
+/*
+ * Add the winding of segment seg1-seg2 around point to wn. Returns 1 when
+ * the point lies on the segment, which settles the ring test.
+ */
+static inline int point_ring_segment(const POINT2D *seg1, const POINT2D *seg2, const POINT2D *point, int *wn) {
+	double side = determineSide(seg1, seg2, point);
+
+	/* zero length segments are ignored. */
+	if ((seg2->x == seg1->x) && (seg2->y == seg1->y)) {
+		return 0;
+	}
+
+	/* a point on the boundary of a ring is not contained. */
+	/* WAS: if (fabs(side) < 1e-12), see #852 */
+	if (side == 0.0) {
+		if (isOnSegment(seg1, seg2, point) == 1) {
+			return 1;
+		}
+	}
+
+	/*
+	 * If the point is to the left of the line, and it's rising,
+	 * then the line is to the right of the point and
+	 * circling counter-clockwise, so increment.
+	 */
+	if ((seg1->y <= point->y) && (point->y < seg2->y) && (side > 0)) {
+		++*wn;
+	}
+	/*
+	 * If the point is to the right of the line, and it's falling,
+	 * then the line is to the right of the point and circling
+	 * clockwise, so decrement.
+	 */
+	else if ((seg2->y <= point->y) && (point->y < seg1->y) && (side < 0)) {
+		--*wn;
+	}
+	return 0;
+}
+
 /*
  * return -1 iff point is outside ring pts
  * return 1 iff point is inside ring pts
@@ -262,7 +304,6 @@ static int isOnSegment(const POINT2D *seg1, const POINT2D *seg2, const POINT2D *
 static int point_in_ring(POINTARRAY *pts, const POINT2D *point) {
 	int wn = 0;
 	uint32_t i;
-	double side;
 	const POINT2D *seg1;
 	const POINT2D *seg2;
 
@@ -270,43 +311,330 @@ static int point_in_ring(POINTARRAY *pts, const POINT2D *point) {
 	for (i = 0; i < pts->npoints - 1; i++) {
 		seg1 = seg2;
 		seg2 = getPoint2d_cp(pts, i + 1);
+		if (point_ring_segment(seg1, seg2, point, &wn))
+			return 0;
+	}
+
+	if (wn == 0)
+		return -1;
+	return 1;
+}
+
+/*
+ * Only the segments whose y range holds the point can be crossed by the ray
+ * of point_in_ring or have the point on them. The ring index groups the
+ * segments in ring order, RING_INDEX_NODE_CAPACITY at a time, into nodes
+ * holding the y range of their members, and the nodes into parents the same
+ * way up to a single root. Neighbouring segments of a ring are close, so
+ * the ranges stay tight and a test only walks down to the few segments
+ * around the point's latitude.
+ */
+#define RING_INDEX_NODE_CAPACITY 16
+
+struct RING_INDEX {
+	const POINTARRAY *pts;
+	uint32_t nsegs;
+	uint32_t nlevels;
+	uint32_t *level_offsets; /* first node of each level, level 0 groups the segments */
+	double *ymin;
+	double *ymax;
+};
+
+static RING_INDEX *ring_index_build(const POINTARRAY *pts) {
+	RING_INDEX *index = (RING_INDEX *)lwalloc(sizeof(RING_INDEX));
+	uint32_t i, j, level, count, nnodes;
+
+	index->pts = pts;
+	index->nsegs = pts->npoints > 1 ? pts->npoints - 1 : 0;
+
+	index->nlevels = 0;
+	nnodes = 0;
+	count = index->nsegs;
+	do {
+		count = (count + RING_INDEX_NODE_CAPACITY - 1) / RING_INDEX_NODE_CAPACITY;
+		nnodes += count;
+		index->nlevels++;
+	} while (count > 1);
+
+	index->level_offsets = (uint32_t *)lwalloc(sizeof(uint32_t) * (index->nlevels + 1));
+	index->ymin = (double *)lwalloc(sizeof(double) * (nnodes ? nnodes : 1));
+	index->ymax = (double *)lwalloc(sizeof(double) * (nnodes ? nnodes : 1));
+
+	index->level_offsets[0] = 0;
+	count = index->nsegs;
+	for (level = 0; level < index->nlevels; level++) {
+		uint32_t nparents = (count + RING_INDEX_NODE_CAPACITY - 1) / RING_INDEX_NODE_CAPACITY;
+		uint32_t first = index->level_offsets[level];
+		for (i = 0; i < nparents; i++) {
+			uint32_t end = FP_MIN((i + 1) * RING_INDEX_NODE_CAPACITY, count);
+			double ymin = DBL_MAX, ymax = -DBL_MAX;
+			for (j = i * RING_INDEX_NODE_CAPACITY; j < end; j++) {
+				if (level == 0) {
+					double y1 = getPoint2d_cp(pts, j)->y;
+					double y2 = getPoint2d_cp(pts, j + 1)->y;
+					ymin = FP_MIN(ymin, FP_MIN(y1, y2));
+					ymax = FP_MAX(ymax, FP_MAX(y1, y2));
+				} else {
+					ymin = FP_MIN(ymin, index->ymin[index->level_offsets[level - 1] + j]);
+					ymax = FP_MAX(ymax, index->ymax[index->level_offsets[level - 1] + j]);
+				}
+			}
+			index->ymin[first + i] = ymin;
+			index->ymax[first + i] = ymax;
+		}
+		index->level_offsets[level + 1] = first + nparents;
+		count = nparents;
+	}
+	return index;
+}
+
+static void ring_index_free(RING_INDEX *index) {
+	lwfree(index->level_offsets);
+	lwfree(index->ymin);
+	lwfree(index->ymax);
+	lwfree(index);
+}
+
+/* Walk the nodes under node of level whose y range holds the point. Returns 1 when the point is on the ring. */
+static int ring_index_visit(const RING_INDEX *index, uint32_t level, uint32_t node, const POINT2D *point, int *wn) {
+	uint32_t i, first, end, pos = index->level_offsets[level] + node;
+
+	if (point->y < index->ymin[pos] || point->y > index->ymax[pos])
+		return 0;
+
+	first = node * RING_INDEX_NODE_CAPACITY;
+	if (level == 0) {
+		end = FP_MIN(first + RING_INDEX_NODE_CAPACITY, index->nsegs);
+		for (i = first; i < end; i++) {
+			if (point_ring_segment(getPoint2d_cp(index->pts, i), getPoint2d_cp(index->pts, i + 1), point, wn))
+				return 1;
+		}
+		return 0;
+	}
+
+	end = FP_MIN(first + RING_INDEX_NODE_CAPACITY, index->level_offsets[level] - index->level_offsets[level - 1]);
+	for (i = first; i < end; i++) {
+		if (ring_index_visit(index, level - 1, i, point, wn))
+			return 1;
+	}
+	return 0;
+}
+
+/* point_in_ring through the index of the ring */
+static int point_in_ring_index(const RING_INDEX *index, const POINT2D *point) {
+	int wn = 0;
+
+	if (index->nsegs == 0)
+		return -1;
+	if (ring_index_visit(index, index->nlevels - 1, 0, point, &wn))
+		return 0;
+
+	if (wn == 0)
+		return -1;
+	return 1;
+}
+
+POLY_INDEX *poly_index_build(const LWPOLY *poly) {
+	POLY_INDEX *index = (POLY_INDEX *)lwalloc(sizeof(POLY_INDEX));
+	uint32_t i;
+
+	index->nrings = poly->nrings;
+	index->rings = (RING_INDEX **)lwalloc(sizeof(RING_INDEX *) * (poly->nrings ? poly->nrings : 1));
+	for (i = 0; i < poly->nrings; i++)
+		index->rings[i] = ring_index_build(poly->rings[i]);
+	if (poly->nrings)
+		ptarray_calculate_gbox_cartesian(poly->rings[0], &index->box);
+	return index;
+}
+
+void poly_index_free(POLY_INDEX *index) {
+	uint32_t i;
+	if (!index)
+		return;
+	for (i = 0; i < index->nrings; i++)
+		ring_index_free(index->rings[i]);
+	lwfree(index->rings);
+	lwfree(index);
+}
+
+/*
+ * point_in_polygon through the index of the polygon: the same answer, found
+ * in time logarithmic in the ring sizes for the usual rings.
+ */
+int point_in_poly_index(const POLY_INDEX *index, const POINT2D *pt) {
+	uint32_t i;
+	int result, in_ring;
+
+	/* everything is outside of an empty polygon */
+	if (index->nrings == 0)
+		return -1;
+
+	/* outside the box of the exterior ring, outside the polygon */
+	if (pt->x < index->box.xmin || pt->x > index->box.xmax || pt->y < index->box.ymin || pt->y > index->box.ymax)
+		return -1;
+
+	in_ring = point_in_ring_index(index->rings[0], pt);
+	if (in_ring == -1) /* outside the exterior ring */
+		return -1;
+	result = in_ring;
+
+	for (i = 1; i < index->nrings; i++) {
+		in_ring = point_in_ring_index(index->rings[i], pt);
+		if (in_ring == 1) /* inside a hole => outside the polygon */
+			return -1;
+		if (in_ring == 0) /* on the edge of a hole */
+			return 0;
+	}
+	return result; /* -1 = outside, 0 = boundary, 1 = inside */
+}
 
-		side = determineSide(seg1, seg2, point);
+/* point_in_multipolygon through the indexes of its npolys polygons */
+int point_in_poly_indexes(POLY_INDEX *const *indexes, uint32_t npolys, const POINT2D *pt) {
+	uint32_t i;
+
+	/* the first polygon the point is not outside of decides, as in point_in_multipolygon */
+	for (i = 0; i < npolys; i++) {
+		int in_poly = point_in_poly_index(indexes[i], pt);
+		if (in_poly != -1)
+			return in_poly;
+	}
+	return -1;
+}
+
+/* Polygons with at most this many segments are tested against a batch of points segment by segment */
+#define POINT_IN_POLY_BATCH_MAX_SEGS 256
+
+/*
+ * point_in_ring for n points at once, with the segments in the outer loop
+ * and the points in the inner one. The inner loop has no branches, so the
+ * compiler can vectorize it across the points.
+ */
+static void point_in_ring_batch(const POINTARRAY *pts, const double *xs, const double *ys, uint32_t n,
+                                int32_t *wn, uint8_t *on, int *results) {
+	uint32_t i, j;
+
+	memset(wn, 0, sizeof(int32_t) * n);
+	memset(on, 0, sizeof(uint8_t) * n);
+	for (i = 0; i + 1 < pts->npoints; i++) {
+		const POINT2D *seg1 = getPoint2d_cp(pts, i);
+		const POINT2D *seg2 = getPoint2d_cp(pts, i + 1);
+		double x1 = seg1->x, y1 = seg1->y, x2 = seg2->x, y2 = seg2->y;
+		double minx = FP_MIN(x1, x2), maxx = FP_MAX(x1, x2);
+		double miny = FP_MIN(y1, y2), maxy = FP_MAX(y1, y2);
 
 		/* zero length segments are ignored. */
-		if ((seg2->x == seg1->x) && (seg2->y == seg1->y)) {
+		if (x1 == x2 && y1 == y2)
 			continue;
+
+		/* the steps of point_ring_segment, with the tests combined instead of branched on */
+		for (j = 0; j < n; j++) {
+			double x = xs[j], y = ys[j];
+			double side = (x2 - x1) * (y - y1) - (x - x1) * (y2 - y1);
+			on[j] |= (side == 0.0) & (x >= minx) & (x <= maxx) & (y >= miny) & (y <= maxy);
+			wn[j] += ((y1 <= y) & (y < y2) & (side > 0)) - ((y2 <= y) & (y < y1) & (side < 0));
 		}
+	}
 
-		/* a point on the boundary of a ring is not contained. */
-		/* WAS: if (fabs(side) < 1e-12), see #852 */
-		if (side == 0.0) {
-			if (isOnSegment(seg1, seg2, point) == 1) {
-				return 0;
-			}
+	for (j = 0; j < n; j++)
+		results[j] = on[j] ? 0 : (wn[j] ? 1 : -1);
+}
+
+/*
+ * point_in_poly_index for the points of sel that are still undecided, as
+ * results[sel[k]]. Points inside the box of the exterior ring of a small
+ * polygon go through the batch kernel, a large polygon is walked through
+ * its ring indexes one point at a time.
+ */
+static void point_in_poly_index_batch(const POLY_INDEX *index, const double *xs, const double *ys,
+                                      const uint32_t *sel, uint32_t nsel, int *results) {
+	uint32_t i, k, nsegs = 0, n = 0;
+	double *bx, *by;
+	uint32_t *bsel;
+	int32_t *wn;
+	uint8_t *on;
+	int *ring_results, *poly_results;
+
+	for (i = 0; i < index->nrings; i++)
+		nsegs += index->rings[i]->nsegs;
+	if (index->nrings == 0 || nsegs > POINT_IN_POLY_BATCH_MAX_SEGS) {
+		for (k = 0; k < nsel; k++) {
+			POINT2D pt;
+			pt.x = xs[sel[k]];
+			pt.y = ys[sel[k]];
+			results[sel[k]] = point_in_poly_index(index, &pt);
 		}
+		return;
+	}
 
-		/*
-		 * If the point is to the left of the line, and it's rising,
-		 * then the line is to the right of the point and
-		 * circling counter-clockwise, so increment.
-		 */
-		if ((seg1->y <= point->y) && (point->y < seg2->y) && (side > 0)) {
-			++wn;
+	bx = (double *)lwalloc(sizeof(double) * (nsel ? nsel : 1));
+	by = (double *)lwalloc(sizeof(double) * (nsel ? nsel : 1));
+	bsel = (uint32_t *)lwalloc(sizeof(uint32_t) * (nsel ? nsel : 1));
+	for (k = 0; k < nsel; k++) {
+		double x = xs[sel[k]], y = ys[sel[k]];
+		/* outside the box of the exterior ring, outside the polygon */
+		if (x < index->box.xmin || x > index->box.xmax || y < index->box.ymin || y > index->box.ymax) {
+			results[sel[k]] = -1;
+			continue;
 		}
-		/*
-		 * If the point is to the right of the line, and it's falling,
-		 * then the line is to the right of the point and circling
-		 * clockwise, so decrement.
-		 */
-		else if ((seg2->y <= point->y) && (point->y < seg1->y) && (side < 0)) {
-			--wn;
+		bx[n] = x;
+		by[n] = y;
+		bsel[n++] = sel[k];
+	}
+
+	wn = (int32_t *)lwalloc(sizeof(int32_t) * (n ? n : 1));
+	on = (uint8_t *)lwalloc(sizeof(uint8_t) * (n ? n : 1));
+	ring_results = (int *)lwalloc(sizeof(int) * (n ? n : 1));
+	poly_results = (int *)lwalloc(sizeof(int) * (n ? n : 1));
+
+	/* the exterior ring, then the holes in order, as in point_in_polygon */
+	point_in_ring_batch(index->rings[0]->pts, bx, by, n, wn, on, poly_results);
+	for (i = 1; i < index->nrings; i++) {
+		point_in_ring_batch(index->rings[i]->pts, bx, by, n, wn, on, ring_results);
+		for (k = 0; k < n; k++) {
+			if (poly_results[k] == -1 || poly_results[k] == 2)
+				continue;
+			if (ring_results[k] == 1) /* inside a hole => outside the polygon */
+				poly_results[k] = -1;
+			else if (ring_results[k] == 0) /* on the edge of a hole */
+				poly_results[k] = 2;
 		}
 	}
+	for (k = 0; k < n; k++)
+		results[bsel[k]] = poly_results[k] == 2 ? 0 : poly_results[k];
+
+	lwfree(bx);
+	lwfree(by);
+	lwfree(bsel);
+	lwfree(wn);
+	lwfree(on);
+	lwfree(ring_results);
+	lwfree(poly_results);
+}
 
-	if (wn == 0)
-		return -1;
-	return 1;
+/*
+ * point_in_poly_indexes for n points given as coordinate arrays: results[i]
+ * is what point_in_poly_indexes answers for point i. Every polygon only
+ * sees the points that no polygon before it has decided.
+ */
+void point_in_poly_indexes_batch(POLY_INDEX *const *indexes, uint32_t npolys, const double *xs, const double *ys,
+                                 uint32_t n, int *results) {
+	uint32_t *sel = (uint32_t *)lwalloc(sizeof(uint32_t) * (n ? n : 1));
+	uint32_t i, k, nsel = n;
+
+	for (k = 0; k < n; k++) {
+		sel[k] = k;
+		results[k] = -1;
+	}
+	for (i = 0; i < npolys && nsel > 0; i++) {
+		uint32_t remaining = 0;
+		point_in_poly_index_batch(indexes[i], xs, ys, sel, nsel, results);
+		for (k = 0; k < nsel; k++) {
+			if (results[sel[k]] == -1)
+				sel[remaining++] = sel[k];
+		}
+		nsel = remaining;
+	}
+	lwfree(sel);
 }
 
 } // namespace duckdb
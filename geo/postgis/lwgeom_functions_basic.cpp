@@ -206,10 +206,17 @@ double ST_distance(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 }
 
 lwvarlena_t *ST_GeoHash(GSERIALIZED *geom, size_t m_chars) {
+	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
+	auto output = ST_GeoHash(lwgeom, m_chars);
+	lwgeom_free(lwgeom);
+	return output;
+}
+
+lwvarlena_t *ST_GeoHash(LWGEOM *lwgeom, size_t m_chars) {
 	int precision = m_chars;
 	lwvarlena_t *geohash = NULL;
 
-	geohash = lwgeom_geohash((LWGEOM *)(lwgeom_from_gserialized(geom)), precision);
+	geohash = lwgeom_geohash(lwgeom, precision);
 
 	if (geohash) {
 		size_t size = geohash->size / 4 - LWVARHDRSZ + 1;
@@ -228,21 +235,44 @@ bool ST_IsCollection(GSERIALIZED *geom) {
 	return lwtype_is_collection(type);
 }
 
+bool ST_IsCollection(LWGEOM *lwgeom) {
+	return lwtype_is_collection(lwgeom->type);
+}
+
 bool LWGEOM_isempty(GSERIALIZED *geom) {
 	return gserialized_is_empty(geom);
 }
 
+bool LWGEOM_isempty(LWGEOM *lwgeom) {
+	return lwgeom_is_empty(lwgeom);
+}
+
+bool LWGEOM_isempty(const void *base, size_t size) {
+	const uint8_t *wkb = static_cast<const uint8_t *>(base);
+	int is_empty;
+
+	if (wkb_peek_is_empty(wkb, size, &is_empty) == LW_FAILURE) {
+		LWGEOM *lwgeom = lwgeom_from_wkb(wkb, size, LW_PARSER_CHECK_NONE);
+		is_empty = lwgeom_is_empty(lwgeom);
+		lwgeom_free(lwgeom);
+	}
+
+	return is_empty;
+}
+
 /** number of points in an object */
 int LWGEOM_npoints(GSERIALIZED *geom) {
 	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
-	int npoints = 0;
-
-	npoints = lwgeom_count_vertices(lwgeom);
+	int npoints = LWGEOM_npoints(lwgeom);
 	lwgeom_free(lwgeom);
 
 	return npoints;
 }
 
+int LWGEOM_npoints(LWGEOM *lwgeom) {
+	return lwgeom_count_vertices(lwgeom);
+}
+
 /**
 Returns the point in first input geometry that is closest to the second input geometry in 2d
 */
@@ -502,10 +532,7 @@ double LWGEOM_length2d_linestring(GSERIALIZED *geom) {
 GSERIALIZED *LWGEOM_envelope(GSERIALIZED *geom) {
 	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
 	int32_t srid = lwgeom->srid;
-	POINT4D pt;
 	GBOX box;
-	POINTARRAY *pa;
-	GSERIALIZED *result;
 
 	if (lwgeom_is_empty(lwgeom)) {
 		/* must be the EMPTY geometry */
@@ -517,6 +544,25 @@ GSERIALIZED *LWGEOM_envelope(GSERIALIZED *geom) {
 		return geom;
 	}
 
+	return LWGEOM_envelope_gbox(&box, srid);
+}
+
+/*
+ * Envelope geometry of a box. A NULL box, the extent of nothing but
+ * empties, gives an empty collection.
+ */
+GSERIALIZED *LWGEOM_envelope_gbox(const GBOX *box, int32_t srid) {
+	POINT4D pt;
+	POINTARRAY *pa;
+	GSERIALIZED *result;
+
+	if (!box) {
+		LWGEOM *empty = lwcollection_as_lwgeom(lwcollection_construct_empty(COLLECTIONTYPE, srid, 0, 0));
+		result = geometry_serialize(empty);
+		lwgeom_free(empty);
+		return result;
+	}
+
 	/*
 	 * Alter envelope type so that a valid geometry is always
 	 * returned depending upon the size of the geometry. The
@@ -528,22 +574,22 @@ GSERIALIZED *LWGEOM_envelope(GSERIALIZED *geom) {
 	 *     - Otherwise return a POLYGON
 	 */
 
-	if ((box.xmin == box.xmax) && (box.ymin == box.ymax)) {
+	if ((box->xmin == box->xmax) && (box->ymin == box->ymax)) {
 		/* Construct and serialize point */
-		LWPOINT *point = lwpoint_make2d(srid, box.xmin, box.ymin);
+		LWPOINT *point = lwpoint_make2d(srid, box->xmin, box->ymin);
 		result = geometry_serialize(lwpoint_as_lwgeom(point));
 		lwpoint_free(point);
-	} else if ((box.xmin == box.xmax) || (box.ymin == box.ymax)) {
+	} else if ((box->xmin == box->xmax) || (box->ymin == box->ymax)) {
 		LWLINE *line;
 		/* Construct point array */
 		pa = ptarray_construct_empty(0, 0, 2);
 
 		/* Assign coordinates to POINT2D array */
-		pt.x = box.xmin;
-		pt.y = box.ymin;
+		pt.x = box->xmin;
+		pt.y = box->ymin;
 		ptarray_append_point(pa, &pt, LW_TRUE);
-		pt.x = box.xmax;
-		pt.y = box.ymax;
+		pt.x = box->xmax;
+		pt.y = box->ymax;
 		ptarray_append_point(pa, &pt, LW_TRUE);
 
 		/* Construct and serialize linestring */
@@ -557,20 +603,20 @@ GSERIALIZED *LWGEOM_envelope(GSERIALIZED *geom) {
 		ppa[0] = pa;
 
 		/* Assign coordinates to POINT2D array */
-		pt.x = box.xmin;
-		pt.y = box.ymin;
+		pt.x = box->xmin;
+		pt.y = box->ymin;
 		ptarray_append_point(pa, &pt, LW_TRUE);
-		pt.x = box.xmin;
-		pt.y = box.ymax;
+		pt.x = box->xmin;
+		pt.y = box->ymax;
 		ptarray_append_point(pa, &pt, LW_TRUE);
-		pt.x = box.xmax;
-		pt.y = box.ymax;
+		pt.x = box->xmax;
+		pt.y = box->ymax;
 		ptarray_append_point(pa, &pt, LW_TRUE);
-		pt.x = box.xmax;
-		pt.y = box.ymin;
+		pt.x = box->xmax;
+		pt.y = box->ymin;
 		ptarray_append_point(pa, &pt, LW_TRUE);
-		pt.x = box.xmin;
-		pt.y = box.ymin;
+		pt.x = box->xmin;
+		pt.y = box->ymin;
 		ptarray_append_point(pa, &pt, LW_TRUE);
 
 		/* Construct polygon  */
@@ -600,6 +646,66 @@ double LWGEOM_maxdistance2d_linestring(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return 0.0;
 }
 
+/*
+ * 2D extent of one EWKB geometry for the extent aggregate, read straight
+ * from the coordinates and only decoded for curves. Returns false for
+ * empty geometries, srid is set either way.
+ */
+bool LWGEOM_extent_gbox(const void *base, size_t size, int32_t *srid, GBOX *box) {
+	LWGEOM *lwgeom;
+	bool ret;
+
+	if (LWGEOM_getGBox(base, size, srid, box))
+		return true;
+
+	lwgeom = lwgeom_from_wkb(static_cast<const uint8_t *>(base), size, LW_PARSER_CHECK_NONE);
+	if (!lwgeom)
+		throw "LWGEOM_extent_gbox: could not decode geometry";
+	*srid = lwgeom->srid;
+	ret = !lwgeom_is_empty(lwgeom) && lwgeom_calculate_gbox(lwgeom, box) == LW_SUCCESS;
+	lwgeom_free(lwgeom);
+	return ret;
+}
+
+/* Grid cell of a coordinate along one axis of the extent, clamped to it */
+static uint32_t sortkey_grid_cell(double v, double min, double max) {
+	double cell;
+	if (!(max > min))
+		return 0;
+	cell = (v - min) / (max - min) * UINT32_MAX;
+	if (!(cell > 0))
+		return 0;
+	if (cell >= UINT32_MAX)
+		return UINT32_MAX;
+	return (uint32_t)cell;
+}
+
+/*
+ * Position of the box centre of a geometry on a space filling curve laid
+ * over extent, for ST_Hilbert and ST_ZOrder. The box is read from the EWKB
+ * as for the extent aggregate. Returns false for empty geometries.
+ */
+static bool LWGEOM_sortkey(const void *base, size_t size, const GBOX *extent, uint64_t (*curve)(uint32_t, uint32_t),
+                           uint64_t *key) {
+	int32_t srid;
+	GBOX box;
+
+	if (!LWGEOM_extent_gbox(base, size, &srid, &box))
+		return false;
+
+	*key = curve(sortkey_grid_cell((box.xmin + box.xmax) / 2, extent->xmin, extent->xmax),
+	             sortkey_grid_cell((box.ymin + box.ymax) / 2, extent->ymin, extent->ymax));
+	return true;
+}
+
+bool LWGEOM_hilbert(const void *base, size_t size, const GBOX *extent, uint64_t *key) {
+	return LWGEOM_sortkey(base, size, extent, hilbert_point_as_int, key);
+}
+
+bool LWGEOM_zorder(const void *base, size_t size, const GBOX *extent, uint64_t *key) {
+	return LWGEOM_sortkey(base, size, extent, morton_point_as_int, key);
+}
+
 GSERIALIZED *LWGEOM_envelope_garray(GSERIALIZED *gserArray[], int nelems) {
 	GSERIALIZED *result = NULL, *colgser = NULL;
 	LWGEOM **geoms;
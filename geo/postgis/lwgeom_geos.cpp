@@ -34,6 +34,8 @@
 #include "libpgcommon/lwgeom_pg.hpp"
 #include "postgis/lwgeom_functions_analytic.hpp" /* for point_in_polygon */
 
+#include <cstring>
+
 namespace duckdb {
 
 GSERIALIZED *GEOS2POSTGIS(GEOSGeom geom, char want3d) {
@@ -287,6 +289,267 @@ GSERIALIZED *pgis_union_geometry_array(GSERIALIZED *gserArray[], int nelems) {
 	return gser_out;
 }
 
+/*
+ * What the geometry aggregates track besides their own fold: the SRID and
+ * dimensions of the first input, which the others must match, and the
+ * largest type among the empties, which is the result when nothing else
+ * went in.
+ */
+struct GeomAggInfo {
+	int32_t srid;
+	int gotsrid;
+	int is3d;
+	int empty_type;
+};
+
+static void geom_agg_info_init(GeomAggInfo *info) {
+	info->srid = SRID_UNKNOWN;
+	info->gotsrid = LW_FALSE;
+	info->is3d = LW_FALSE;
+	info->empty_type = 0;
+}
+
+/* The first input sets SRID and dimensions, the others must match its SRID */
+static int geom_agg_set_srid(GeomAggInfo *info, int32_t srid, int is3d) {
+	if (!info->gotsrid) {
+		info->srid = srid;
+		info->is3d = is3d;
+		info->gotsrid = LW_TRUE;
+	}
+	return info->srid == srid ? LW_SUCCESS : LW_FAILURE;
+}
+
+/*
+ * Decode one EWKB input of an aggregate. Empties only count towards the
+ * type of the empty result and come back as NULL.
+ */
+static LWGEOM *geom_agg_decode(GeomAggInfo *info, const void *base, size_t size, const char *func) {
+	LWGEOM *lwgeom = lwgeom_from_wkb(static_cast<const uint8_t *>(base), size, LW_PARSER_CHECK_NONE);
+
+	if (!lwgeom)
+		throw "One of the geometries in the set could not be decoded";
+
+	if (geom_agg_set_srid(info, lwgeom->srid, lwgeom_has_z(lwgeom)) == LW_FAILURE) {
+		int32_t srid = lwgeom->srid;
+		lwgeom_free(lwgeom);
+		lwerror("%s: Operation on mixed SRID geometries %d != %d", func, srid, info->srid);
+	}
+
+	if (lwgeom_is_empty(lwgeom)) {
+		if (lwgeom->type > info->empty_type)
+			info->empty_type = lwgeom->type;
+		lwgeom_free(lwgeom);
+		return NULL;
+	}
+	return lwgeom;
+}
+
+static void geom_agg_info_combine(GeomAggInfo *target, const GeomAggInfo *source, const char *func) {
+	if (source->gotsrid && geom_agg_set_srid(target, source->srid, source->is3d) == LW_FAILURE)
+		lwerror("%s: Operation on mixed SRID geometries %d != %d", func, source->srid, target->srid);
+	if (source->empty_type > target->empty_type)
+		target->empty_type = source->empty_type;
+}
+
+/* If it was only empties, we'll return the largest type number, NULL when nothing but NULL went in */
+static GSERIALIZED *geom_agg_empty_result(const GeomAggInfo *info, int is3d) {
+	GSERIALIZED *gser_out;
+	LWGEOM *lwgeom;
+
+	if (info->empty_type == 0)
+		return NULL;
+	lwgeom = lwgeom_construct_empty(info->empty_type, info->srid, is3d, 0);
+	gser_out = geometry_serialize(lwgeom);
+	lwgeom_free(lwgeom);
+	return gser_out;
+}
+
+/*
+ * State of the union aggregate. Inputs are buffered as GEOS geometries and
+ * every UNION_AGG_BATCH_SIZE of them are cascaded into one partial union.
+ * Partials are merged like a binary counter, levels[k] holding the union of
+ * 2^k batches, so each input takes part in a logarithmic number of unions
+ * and the state only ever holds the partials and one batch.
+ */
+#define UNION_AGG_BATCH_SIZE 256
+
+struct UnionAggState {
+	GeomAggInfo info;
+	GEOSGeometry **geoms;
+	uint32_t ngeoms;
+	uint32_t geoms_size;
+	GEOSGeometry **levels;
+	uint32_t nlevels;
+};
+
+UnionAggState *union_agg_state_create(void) {
+	UnionAggState *state = (UnionAggState *)lwalloc(sizeof(UnionAggState));
+	geom_agg_info_init(&state->info);
+	state->geoms = NULL;
+	state->ngeoms = 0;
+	state->geoms_size = 0;
+	state->levels = NULL;
+	state->nlevels = 0;
+	return state;
+}
+
+/* Push a partial union at the given level, merging equal levels upwards */
+static void union_agg_carry(UnionAggState *state, GEOSGeometry *g, uint32_t level) {
+	while (level < state->nlevels && state->levels[level]) {
+		GEOSGeometry *g_union = GEOSUnion(state->levels[level], g);
+		GEOSGeom_destroy(state->levels[level]);
+		GEOSGeom_destroy(g);
+		state->levels[level] = NULL;
+		if (!g_union)
+			throw "GEOSUnion";
+		g = g_union;
+		level++;
+	}
+	if (level >= state->nlevels) {
+		state->levels = (GEOSGeometry **)lwrealloc(state->levels, sizeof(GEOSGeometry *) * (level + 1));
+		while (state->nlevels <= level)
+			state->levels[state->nlevels++] = NULL;
+	}
+	state->levels[level] = g;
+}
+
+/* Cascade the buffered inputs into one partial union */
+static void union_agg_flush(UnionAggState *state) {
+	GEOSGeometry *g, *g_union;
+
+	if (state->ngeoms == 0)
+		return;
+
+	g = GEOSGeom_createCollection(GEOS_GEOMETRYCOLLECTION, state->geoms, state->ngeoms);
+	state->ngeoms = 0;
+	if (!g)
+		throw "Could not create GEOS COLLECTION from geometry array";
+
+	g_union = GEOSUnaryUnion(g);
+	GEOSGeom_destroy(g);
+	if (!g_union)
+		throw "GEOSUnaryUnion";
+
+	union_agg_carry(state, g_union, 0);
+}
+
+static void union_agg_push(UnionAggState *state, GEOSGeometry *g) {
+	if (state->ngeoms == state->geoms_size) {
+		state->geoms_size = state->geoms_size ? state->geoms_size * 2 : 8;
+		state->geoms = (GEOSGeometry **)lwrealloc(state->geoms, sizeof(GEOSGeometry *) * state->geoms_size);
+	}
+	state->geoms[state->ngeoms++] = g;
+	if (state->ngeoms == UNION_AGG_BATCH_SIZE)
+		union_agg_flush(state);
+}
+
+/*
+ * Add one EWKB geometry to the aggregate. Empties only count towards the
+ * type of the empty result.
+ */
+void union_agg_state_add(UnionAggState *state, const void *base, size_t size) {
+	LWGEOM *lwgeom = geom_agg_decode(&state->info, base, size, __func__);
+	GEOSGeometry *g;
+
+	/* Don't include empties in the union */
+	if (!lwgeom)
+		return;
+
+	initGEOS(lwnotice, lwgeom_geos_error);
+	g = LWGEOM2GEOS(lwgeom, 0);
+	lwgeom_free(lwgeom);
+
+	/* Uh oh! Exception thrown at construction... */
+	if (!g)
+		throw "One of the geometries in the set could not be converted to GEOS";
+
+	union_agg_push(state, g);
+}
+
+/*
+ * Merge the partial unions of source into target. Source is left intact,
+ * the same state may be combined into several targets.
+ */
+void union_agg_state_combine(UnionAggState *target, const UnionAggState *source) {
+	uint32_t i;
+
+	geom_agg_info_combine(&target->info, &source->info, __func__);
+
+	initGEOS(lwnotice, lwgeom_geos_error);
+	for (i = 0; i < source->ngeoms; i++)
+		union_agg_push(target, GEOSGeom_clone(source->geoms[i]));
+	for (i = 0; i < source->nlevels; i++) {
+		if (source->levels[i])
+			union_agg_carry(target, GEOSGeom_clone(source->levels[i]), i);
+	}
+}
+
+/*
+ * Union of everything added, NULL when only NULLs went in. Consumes the
+ * partial unions of the state.
+ */
+GSERIALIZED *union_agg_state_finalize(UnionAggState *state) {
+	GEOSGeometry *g = NULL;
+	GSERIALIZED *gser_out;
+	uint32_t i;
+
+	initGEOS(lwnotice, lwgeom_geos_error);
+
+	/* One geom, good geom? Return it */
+	if (state->ngeoms == 1 && state->nlevels == 0) {
+		g = state->geoms[0];
+		state->ngeoms = 0;
+	} else {
+		union_agg_flush(state);
+	}
+
+	/* Smallest partials first, into the larger ones */
+	for (i = 0; i < state->nlevels; i++) {
+		GEOSGeometry *level = state->levels[i];
+		GEOSGeometry *g_union;
+		if (!level)
+			continue;
+		state->levels[i] = NULL;
+		if (!g) {
+			g = level;
+			continue;
+		}
+		g_union = GEOSUnion(g, level);
+		GEOSGeom_destroy(g);
+		GEOSGeom_destroy(level);
+		if (!g_union)
+			throw "GEOSUnion";
+		g = g_union;
+	}
+
+	if (!g)
+		return geom_agg_empty_result(&state->info, state->info.is3d);
+
+	GEOSSetSRID(g, state->info.srid);
+	gser_out = GEOS2POSTGIS(g, state->info.is3d);
+	GEOSGeom_destroy(g);
+	return gser_out;
+}
+
+void union_agg_state_free(UnionAggState *state) {
+	uint32_t i;
+
+	if (!state)
+		return;
+	initGEOS(lwnotice, lwgeom_geos_error);
+	for (i = 0; i < state->ngeoms; i++)
+		GEOSGeom_destroy(state->geoms[i]);
+	for (i = 0; i < state->nlevels; i++) {
+		if (state->levels[i])
+			GEOSGeom_destroy(state->levels[i]);
+	}
+	if (state->geoms)
+		lwfree(state->geoms);
+	if (state->levels)
+		lwfree(state->levels);
+	lwfree(state);
+}
+
 GSERIALIZED *ST_Intersection(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	GSERIALIZED *result;
 	LWGEOM *lwgeom1, *lwgeom2, *lwresult;
@@ -359,6 +622,202 @@ GSERIALIZED *convexhull(GSERIALIZED *geom1) {
 	return result;
 }
 
+/*
+ * State of the convex hull aggregate. Only coordinates are kept:
+ * points[0..nhull) are the vertices of the hull of everything merged so
+ * far, the points after them are pending. Once CONVEXHULL_AGG_BATCH_SIZE
+ * points are pending, a monotone chain over the hull and the pending
+ * points cuts them back to the new hull, so the state stays about the
+ * size of the hull. The hull geometry itself is built once, at the end.
+ */
+#define CONVEXHULL_AGG_BATCH_SIZE 1024
+
+/* Relative bound on the rounding error of the orientation determinant */
+#define CONVEXHULL_AGG_ERRBOUND 1e-15
+
+struct ConvexHullAggState {
+	GeomAggInfo info;
+	POINT2D *points;
+	uint32_t npoints;
+	uint32_t nhull;
+	uint32_t points_size;
+};
+
+ConvexHullAggState *convexhull_agg_state_create(void) {
+	ConvexHullAggState *state = (ConvexHullAggState *)lwalloc(sizeof(ConvexHullAggState));
+	geom_agg_info_init(&state->info);
+	state->points = NULL;
+	state->npoints = 0;
+	state->nhull = 0;
+	state->points_size = 0;
+	return state;
+}
+
+static int convexhull_agg_point_cmp(const void *a, const void *b) {
+	const POINT2D *pa = (const POINT2D *)a;
+	const POINT2D *pb = (const POINT2D *)b;
+	if (pa->x != pb->x)
+		return pa->x < pb->x ? -1 : 1;
+	if (pa->y != pb->y)
+		return pa->y < pb->y ? -1 : 1;
+	return 0;
+}
+
+/*
+ * Whether a is a left turn from o towards b. Turns too close to call are
+ * taken as left, so the point is kept and GEOS decides it at the end.
+ */
+static int convexhull_agg_left_turn(const POINT2D *o, const POINT2D *a, const POINT2D *b) {
+	double l = (a->x - o->x) * (b->y - o->y);
+	double r = (a->y - o->y) * (b->x - o->x);
+	double det = l - r;
+	if (det == 0)
+		return LW_FALSE;
+	return det > -CONVEXHULL_AGG_ERRBOUND * (fabs(l) + fabs(r));
+}
+
+/* Replace the hull and the pending points with the hull of them all */
+static void convexhull_agg_reduce(ConvexHullAggState *state) {
+	POINT2D *pts = state->points;
+	POINT2D *hull;
+	uint32_t i, n, k, lower;
+
+	if (state->npoints == state->nhull)
+		return;
+
+	/* Sorted and without repeats */
+	qsort(pts, state->npoints, sizeof(POINT2D), convexhull_agg_point_cmp);
+	n = 0;
+	for (i = 0; i < state->npoints; i++) {
+		if (n == 0 || pts[i].x != pts[n - 1].x || pts[i].y != pts[n - 1].y)
+			pts[n++] = pts[i];
+	}
+	if (n < 3) {
+		state->npoints = state->nhull = n;
+		return;
+	}
+
+	/* Lower chain left to right, then upper chain back, counterclockwise */
+	hull = (POINT2D *)lwalloc(sizeof(POINT2D) * 2 * n);
+	k = 0;
+	for (i = 0; i < n; i++) {
+		while (k >= 2 && !convexhull_agg_left_turn(&hull[k - 2], &hull[k - 1], &pts[i]))
+			k--;
+		hull[k++] = pts[i];
+	}
+	lower = k + 1;
+	for (i = n - 1; i-- > 0;) {
+		while (k >= lower && !convexhull_agg_left_turn(&hull[k - 2], &hull[k - 1], &pts[i]))
+			k--;
+		hull[k++] = pts[i];
+	}
+	/* The last point closes the ring on the first */
+	k--;
+
+	memcpy(pts, hull, sizeof(POINT2D) * k);
+	lwfree(hull);
+	state->npoints = state->nhull = k;
+}
+
+static void convexhull_agg_push(ConvexHullAggState *state, const POINT2D *pt) {
+	if (state->npoints == state->points_size) {
+		state->points_size = state->points_size ? state->points_size * 2 : 8;
+		state->points = (POINT2D *)lwrealloc(state->points, sizeof(POINT2D) * state->points_size);
+	}
+	state->points[state->npoints++] = *pt;
+	if (state->npoints - state->nhull >= CONVEXHULL_AGG_BATCH_SIZE)
+		convexhull_agg_reduce(state);
+}
+
+/*
+ * Add the coordinates of one EWKB geometry to the aggregate. Empties only
+ * count towards the type of the empty result.
+ */
+void convexhull_agg_state_add(ConvexHullAggState *state, const void *base, size_t size) {
+	LWGEOM *lwgeom = geom_agg_decode(&state->info, base, size, __func__);
+	LWPOINTITERATOR *it;
+	POINT4D p;
+
+	if (!lwgeom)
+		return;
+
+	it = lwpointiterator_create(lwgeom);
+	while (lwpointiterator_next(it, &p)) {
+		POINT2D pt = {p.x, p.y};
+		convexhull_agg_push(state, &pt);
+	}
+	lwpointiterator_destroy(it);
+	lwgeom_free(lwgeom);
+}
+
+/*
+ * Merge the points of source into target. Source is left intact, the same
+ * state may be combined into several targets.
+ */
+void convexhull_agg_state_combine(ConvexHullAggState *target, const ConvexHullAggState *source) {
+	uint32_t i;
+
+	geom_agg_info_combine(&target->info, &source->info, __func__);
+
+	for (i = 0; i < source->npoints; i++)
+		convexhull_agg_push(target, &source->points[i]);
+}
+
+/*
+ * Convex hull of everything added, NULL when only NULLs went in. The hull
+ * vertices go through GEOSConvexHull, so the shape and vertex order are
+ * those ST_ConvexHull gives for the same coordinates.
+ */
+GSERIALIZED *convexhull_agg_state_finalize(ConvexHullAggState *state) {
+	GEOSGeometry **geoms, *g, *g_hull;
+	GSERIALIZED *gser_out;
+	uint32_t i, lowest;
+
+	convexhull_agg_reduce(state);
+
+	/* The hull is planar, so is its empty */
+	if (state->npoints == 0)
+		return geom_agg_empty_result(&state->info, LW_FALSE);
+
+	/* Start from the lowest vertex, as GEOS does, so a two point hull does not depend on the row order */
+	lowest = 0;
+	for (i = 1; i < state->npoints; i++) {
+		const POINT2D *pt = &state->points[i];
+		const POINT2D *low = &state->points[lowest];
+		if (pt->y < low->y || (pt->y == low->y && pt->x < low->x))
+			lowest = i;
+	}
+
+	initGEOS(lwnotice, lwgeom_geos_error);
+	geoms = (GEOSGeometry **)lwalloc(sizeof(GEOSGeometry *) * state->npoints);
+	for (i = 0; i < state->npoints; i++) {
+		const POINT2D *pt = &state->points[(lowest + i) % state->npoints];
+		geoms[i] = GEOSGeom_createPointFromXY(pt->x, pt->y);
+	}
+	g = GEOSGeom_createCollection(GEOS_MULTIPOINT, geoms, state->npoints);
+	lwfree(geoms);
+	if (!g)
+		throw "Could not create GEOS MULTIPOINT from the hull vertices";
+
+	g_hull = GEOSConvexHull(g);
+	GEOSGeom_destroy(g);
+	if (!g_hull)
+		throw "GEOSConvexHull";
+
+	GEOSSetSRID(g_hull, state->info.srid);
+	gser_out = GEOS2POSTGIS(g_hull, LW_FALSE);
+	GEOSGeom_destroy(g_hull);
+	return gser_out;
+}
+
+void convexhull_agg_state_free(ConvexHullAggState *state) {
+	if (!state)
+		return;
+	if (state->points)
+		lwfree(state->points);
+	lwfree(state);
+}
+
 GSERIALIZED *buffer(GSERIALIZED *geom1, double size, string styles_text) {
 	GEOSBufferParams *bufferparams;
 	GEOSGeometry *g1, *g3 = NULL;
@@ -564,21 +1023,70 @@ bool ST_Equals(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return result;
 }
 
-/* Utility function that checks a LWPOINT and a GSERIALIZED poly against a cache.
- * Serialized poly may be a multipart.
+/* Utility function that checks a LWPOINT against a decoded poly.
+ * The poly may be a multipart. When the poly is cached, indexes holds
+ * the index of each of its polygons.
  */
-static int pip_short_circuit(LWPOINT *point, const GSERIALIZED *gpoly) {
-	int result;
+static int pip_short_circuit(LWPOINT *point, LWGEOM *poly, POLY_INDEX *const *indexes) {
+	if (indexes) {
+		POINT2D pt;
+		getPoint2d_p(point->point, 0, &pt);
+		if (lwgeom_get_type(poly) == POLYGONTYPE)
+			return point_in_poly_index(indexes[0], &pt);
+		return point_in_poly_indexes(indexes, lwgeom_as_lwmpoly(poly)->ngeoms, &pt);
+	}
+	if (lwgeom_get_type(poly) == POLYGONTYPE)
+		return point_in_polygon(lwgeom_as_lwpoly(poly), point);
+	return point_in_multipolygon(lwgeom_as_lwmpoly(poly), point);
+}
 
-	LWGEOM *poly = lwgeom_from_gserialized(gpoly);
-	if (lwgeom_get_type(poly) == POLYGONTYPE) {
-		result = point_in_polygon(lwgeom_as_lwpoly(poly), point);
-	} else {
-		result = point_in_multipolygon(lwgeom_as_lwmpoly(poly), point);
+/* Contains for a decoded (multi)polygon and a decoded (multi)point */
+static bool pip_contains(LWGEOM *poly, LWGEOM *points, POLY_INDEX *const *indexes = NULL) {
+	if (lwgeom_get_type(points) == POINTTYPE)
+		return pip_short_circuit(lwgeom_as_lwpoint(points), poly, indexes) == 1; /* completely inside */
+
+	LWMPOINT *mpoint = lwgeom_as_lwmpoint(points);
+	int found_completely_inside = LW_FALSE;
+	for (uint32_t i = 0; i < mpoint->ngeoms; i++) {
+		/* We need to find at least one point that's completely inside the
+		 * polygons (pip_result == 1).  As long as we have one point that's
+		 * completely inside, we can have as many as we want on the boundary
+		 * itself. (pip_result == 0)
+		 */
+		int pip_result = pip_short_circuit(mpoint->geoms[i], poly, indexes);
+		if (pip_result == 1)
+			found_completely_inside = LW_TRUE;
+
+		if (pip_result == -1) /* completely outside */
+			return false;
 	}
-	lwgeom_free(poly);
+	return found_completely_inside;
+}
 
-	return result;
+/* Intersects for a decoded (multi)polygon and a decoded (multi)point */
+static bool pip_intersects(LWGEOM *poly, LWGEOM *points, POLY_INDEX *const *indexes = NULL) {
+	if (lwgeom_get_type(points) == POINTTYPE)
+		return pip_short_circuit(lwgeom_as_lwpoint(points), poly, indexes) != -1; /* not outside */
+
+	LWMPOINT *mpoint = lwgeom_as_lwmpoint(points);
+	for (uint32_t i = 0; i < mpoint->ngeoms; i++) {
+		if (pip_short_circuit(mpoint->geoms[i], poly, indexes) != -1) /* not outside */
+			return true;
+	}
+	return false;
+}
+
+/* Covers for a decoded (multi)polygon and a decoded (multi)point */
+static bool pip_covers(LWGEOM *poly, LWGEOM *points) {
+	if (lwgeom_get_type(points) == POINTTYPE)
+		return pip_short_circuit(lwgeom_as_lwpoint(points), poly, NULL) != -1; /* not outside */
+
+	LWMPOINT *mpoint = lwgeom_as_lwmpoint(points);
+	for (uint32_t i = 0; i < mpoint->ngeoms; i++) {
+		if (pip_short_circuit(mpoint->geoms[i], poly, NULL) == -1)
+			return false;
+	}
+	return true;
 }
 
 static char is_poly(const GSERIALIZED *g) {
@@ -615,48 +1123,12 @@ bool contains(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	** call the point-in-polygon function.
 	*/
 	if (is_poly(geom1) && is_point(geom2)) {
-		const GSERIALIZED *gpoly = geom1;
-		const GSERIALIZED *gpoint = geom2;
-		int retval;
-
-		if (gserialized_get_type(gpoint) == POINTTYPE) {
-			LWGEOM *point = lwgeom_from_gserialized(gpoint);
-			int pip_result = pip_short_circuit(lwgeom_as_lwpoint(point), gpoly);
-			lwgeom_free(point);
-
-			retval = (pip_result == 1); /* completely inside */
-		} else if (gserialized_get_type(gpoint) == MULTIPOINTTYPE) {
-			LWMPOINT *mpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gpoint));
-			uint32_t i;
-			int found_completely_inside = LW_FALSE;
-
-			retval = LW_TRUE;
-			for (i = 0; i < mpoint->ngeoms; i++) {
-				/* We need to find at least one point that's completely inside the
-				 * polygons (pip_result == 1).  As long as we have one point that's
-				 * completely inside, we can have as many as we want on the boundary
-				 * itself. (pip_result == 0)
-				 */
-				int pip_result = pip_short_circuit(mpoint->geoms[i], gpoly);
-				if (pip_result == 1)
-					found_completely_inside = LW_TRUE;
-
-				if (pip_result == -1) /* completely outside */
-				{
-					retval = LW_FALSE;
-					break;
-				}
-			}
-
-			retval = retval && found_completely_inside;
-			lwmpoint_free(mpoint);
-		} else {
-			/* Never get here */
-			throw "Type isn't point or multipoint!";
-			return false;
-		}
-
-		return retval > 0;
+		LWGEOM *poly = lwgeom_from_gserialized(geom1);
+		LWGEOM *points = lwgeom_from_gserialized(geom2);
+		bool retval = pip_contains(poly, points);
+		lwgeom_free(poly);
+		lwgeom_free(points);
+		return retval;
 	}
 
 	initGEOS(lwnotice, lwgeom_geos_error);
@@ -747,37 +1219,11 @@ bool ST_Intersects(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	 * call the point_outside_polygon function.
 	 */
 	if ((is_point(geom1) && is_poly(geom2)) || (is_poly(geom1) && is_point(geom2))) {
-		const GSERIALIZED *gpoly = is_poly(geom1) ? geom1 : geom2;
-		const GSERIALIZED *gpoint = is_point(geom1) ? geom1 : geom2;
-		int retval;
-
-		if (gserialized_get_type(gpoint) == POINTTYPE) {
-			LWGEOM *point = lwgeom_from_gserialized(gpoint);
-			int pip_result = pip_short_circuit(lwgeom_as_lwpoint(point), gpoly);
-			lwgeom_free(point);
-
-			retval = (pip_result != -1); /* not outside */
-		} else if (gserialized_get_type(gpoint) == MULTIPOINTTYPE) {
-			LWMPOINT *mpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gpoint));
-			uint32_t i;
-
-			retval = LW_FALSE;
-			for (i = 0; i < mpoint->ngeoms; i++) {
-				int pip_result = pip_short_circuit(mpoint->geoms[i], gpoly);
-				if (pip_result != -1) /* not outside */
-				{
-					retval = LW_TRUE;
-					break;
-				}
-			}
-
-			lwmpoint_free(mpoint);
-		} else {
-			/* Never get here */
-			throw "Type isn't point or multipoint!";
-			return false;
-		}
-
+		LWGEOM *poly = lwgeom_from_gserialized(is_poly(geom1) ? geom1 : geom2);
+		LWGEOM *points = lwgeom_from_gserialized(is_point(geom1) ? geom1 : geom2);
+		bool retval = pip_intersects(poly, points);
+		lwgeom_free(poly);
+		lwgeom_free(points);
 		return retval;
 	}
 
@@ -803,6 +1249,282 @@ bool ST_Intersects(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	return result;
 }
 
+/* Multi geometries with at least this many parts get a parts tree */
+#define PREPARED_PARTS_TREE_MIN 8
+
+/*
+ * Index the non-empty parts of a multi geometry. Geometry collections are
+ * left out, GEOS does not treat their members as independent parts.
+ */
+static void prep_geom_cache_build_parts(PrepGeomCache *cache) {
+	int type = lwgeom_get_type(cache->lwgeom);
+	LWCOLLECTION *col;
+	GBOX *boxes;
+	uint32_t i, nparts = 0;
+
+	if (type != MULTIPOINTTYPE && type != MULTILINETYPE && type != MULTIPOLYGONTYPE)
+		return;
+	col = lwgeom_as_lwcollection(cache->lwgeom);
+	if (col->ngeoms < PREPARED_PARTS_TREE_MIN)
+		return;
+
+	cache->parts = (LWGEOM **)lwalloc(sizeof(LWGEOM *) * col->ngeoms);
+	boxes = (GBOX *)lwalloc(sizeof(GBOX) * col->ngeoms);
+	if (cache->pip_indexes)
+		cache->parts_pip = (POLY_INDEX **)lwalloc(sizeof(POLY_INDEX *) * col->ngeoms);
+	for (i = 0; i < col->ngeoms; i++) {
+		if (lwgeom_is_empty(col->geoms[i]) || lwgeom_calculate_gbox(col->geoms[i], &boxes[nparts]) == LW_FAILURE)
+			continue;
+		if (cache->parts_pip)
+			cache->parts_pip[nparts] = cache->pip_indexes[i];
+		cache->parts[nparts++] = col->geoms[i];
+	}
+	cache->parts_tree = rtree_build(boxes, nparts);
+	lwfree(boxes);
+
+	cache->parts_geos = (GEOSGeometry **)lwalloc(sizeof(GEOSGeometry *) * (nparts ? nparts : 1));
+	memset(cache->parts_geos, 0, sizeof(GEOSGeometry *) * (nparts ? nparts : 1));
+	cache->parts_hits = (uint32_t *)lwalloc(sizeof(uint32_t) * (nparts ? nparts : 1));
+}
+
+/* Index every polygon of a (multi)polygon for point-in-polygon tests */
+static void prep_geom_cache_build_pip(PrepGeomCache *cache) {
+	int type = lwgeom_get_type(cache->lwgeom);
+	uint32_t i;
+
+	if (type == POLYGONTYPE) {
+		cache->npip_indexes = 1;
+		cache->pip_indexes = (POLY_INDEX **)lwalloc(sizeof(POLY_INDEX *));
+		cache->pip_indexes[0] = poly_index_build(lwgeom_as_lwpoly(cache->lwgeom));
+	} else if (type == MULTIPOLYGONTYPE) {
+		LWMPOLY *mpoly = lwgeom_as_lwmpoly(cache->lwgeom);
+		cache->npip_indexes = mpoly->ngeoms;
+		cache->pip_indexes = (POLY_INDEX **)lwalloc(sizeof(POLY_INDEX *) * (mpoly->ngeoms ? mpoly->ngeoms : 1));
+		for (i = 0; i < mpoly->ngeoms; i++)
+			cache->pip_indexes[i] = poly_index_build(mpoly->geoms[i]);
+	}
+}
+
+PrepGeomCache *GetPrepGeomCache(const void *base, size_t size) {
+	LWGEOM *lwgeom = lwgeom_from_wkb(static_cast<const uint8_t *>(base), size, LW_PARSER_CHECK_NONE);
+	if (!lwgeom)
+		return NULL;
+
+	/* Attach the box now, nothing must allocate into the cache once it is built */
+	lwgeom_add_bbox(lwgeom);
+
+	PrepGeomCache *cache = (PrepGeomCache *)lwalloc(sizeof(PrepGeomCache));
+	cache->lwgeom = lwgeom;
+	cache->gser = geometry_serialize(lwgeom);
+	cache->geos = NULL;
+	cache->has_gbox = gserialized_get_gbox_p(cache->gser, &cache->gbox);
+	cache->parts_tree = NULL;
+	cache->parts = NULL;
+	cache->parts_geos = NULL;
+	cache->parts_hits = NULL;
+	cache->pip_indexes = NULL;
+	cache->npip_indexes = 0;
+	cache->parts_pip = NULL;
+	prep_geom_cache_build_pip(cache);
+	prep_geom_cache_build_parts(cache);
+	return cache;
+}
+
+void FreePrepGeomCache(PrepGeomCache *cache) {
+	if (!cache)
+		return;
+	initGEOS(lwnotice, lwgeom_geos_error);
+	if (cache->geos)
+		GEOSGeom_destroy(cache->geos);
+	if (cache->parts_tree) {
+		for (uint32_t i = 0; i < cache->parts_tree->nitems; i++) {
+			if (cache->parts_geos[i])
+				GEOSGeom_destroy(cache->parts_geos[i]);
+		}
+		lwfree(cache->parts_geos);
+		lwfree(cache->parts_hits);
+		lwfree(cache->parts);
+		rtree_free(cache->parts_tree);
+	}
+	if (cache->pip_indexes) {
+		for (uint32_t i = 0; i < cache->npip_indexes; i++)
+			poly_index_free(cache->pip_indexes[i]);
+		lwfree(cache->pip_indexes);
+		lwfree(cache->parts_pip);
+	}
+	lwgeom_free(cache->lwgeom);
+	lwfree(cache->gser);
+	lwfree(cache);
+}
+
+/*
+ * Run a GEOS predicate between the cached geometry, at argument position
+ * argnum, and geom. The GEOS form of the cache is built on first use.
+ */
+static char prepared_geos_predicate(PrepGeomCache *cache, int argnum, GSERIALIZED *geom,
+                                    char (*predicate)(const GEOSGeometry *, const GEOSGeometry *),
+                                    const char *name) {
+	initGEOS(lwnotice, lwgeom_geos_error);
+
+	if (!cache->geos) {
+		cache->geos = LWGEOM2GEOS(cache->lwgeom, 0);
+		if (!cache->geos)
+			throw "Prepared geometry could not be converted to GEOS";
+	}
+	GEOSGeometry *g = POSTGIS2GEOS(geom);
+	if (!g)
+		throw "Argument geometry could not be converted to GEOS";
+
+	char result = argnum == 1 ? predicate(cache->geos, g) : predicate(g, cache->geos);
+	GEOSGeom_destroy(g);
+
+	if (result == 2)
+		throw name;
+
+	return result;
+}
+
+/*
+ * contains() with one argument taken from the cache: argnum 1 when the
+ * cache is the container, 2 when it is the containee.
+ */
+bool contains_prepared(PrepGeomCache *cache, int argnum, GSERIALIZED *geom) {
+	GSERIALIZED *geom1 = argnum == 1 ? cache->gser : geom;
+	GSERIALIZED *geom2 = argnum == 1 ? geom : cache->gser;
+	GBOX box;
+
+	gserialized_error_if_srid_mismatch(geom1, geom2, __func__);
+
+	/* A.Contains(Empty) == FALSE */
+	if (gserialized_is_empty(geom1) || gserialized_is_empty(geom2))
+		return false;
+
+	/* short-circuit 1: bounding box containment, against the cached box */
+	if (cache->has_gbox && gserialized_get_gbox_p(geom, &box)) {
+		if (!(argnum == 1 ? gbox_contains_2d(&cache->gbox, &box) : gbox_contains_2d(&box, &cache->gbox)))
+			return false;
+	}
+
+	/* short-circuit 2: point-in-polygon, reusing whichever side is decoded already */
+	if (is_poly(geom1) && is_point(geom2)) {
+		LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
+		bool retval = argnum == 1 ? pip_contains(cache->lwgeom, lwgeom, cache->pip_indexes)
+		                          : pip_contains(lwgeom, cache->lwgeom);
+		lwgeom_free(lwgeom);
+		return retval;
+	}
+
+	return prepared_geos_predicate(cache, argnum, geom, GEOSContains, "GEOSContains") > 0;
+}
+
+/*
+ * ST_Intersects() against a cache with a parts tree: a geometry intersects
+ * a multi geometry when it intersects one of its parts, so only the parts
+ * whose box overlaps box are tested, and the first hit decides.
+ */
+static bool intersects_parts(PrepGeomCache *cache, GSERIALIZED *geom, const GBOX *box) {
+	uint32_t i, nhits;
+	int parts_type;
+	char result = 0;
+
+	nhits = rtree_query(cache->parts_tree, box, cache->parts_hits);
+	if (nhits == 0)
+		return false;
+
+	/* point-in-polygon against the candidate parts, as in short-circuit 2 */
+	parts_type = lwgeom_get_type(cache->parts[0]);
+	if ((parts_type == POLYGONTYPE && is_point(geom)) || (parts_type == POINTTYPE && is_poly(geom))) {
+		LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
+		bool retval = false;
+		for (i = 0; i < nhits && !retval; i++) {
+			LWGEOM *part = cache->parts[cache->parts_hits[i]];
+			retval = parts_type == POLYGONTYPE ? pip_intersects(part, lwgeom, &cache->parts_pip[cache->parts_hits[i]])
+			                                   : pip_intersects(lwgeom, part);
+		}
+		lwgeom_free(lwgeom);
+		return retval;
+	}
+
+	initGEOS(lwnotice, lwgeom_geos_error);
+
+	GEOSGeometry *g = POSTGIS2GEOS(geom);
+	if (!g)
+		throw "Argument geometry could not be converted to GEOS";
+	for (i = 0; i < nhits && result == 0; i++) {
+		uint32_t part = cache->parts_hits[i];
+		if (!cache->parts_geos[part]) {
+			cache->parts_geos[part] = LWGEOM2GEOS(cache->parts[part], 0);
+			if (!cache->parts_geos[part]) {
+				GEOSGeom_destroy(g);
+				throw "Prepared geometry could not be converted to GEOS";
+			}
+		}
+		result = GEOSIntersects(cache->parts_geos[part], g);
+	}
+	GEOSGeom_destroy(g);
+
+	if (result == 2)
+		throw "GEOSIntersects";
+
+	return result;
+}
+
+/* Multipolygons with more parts than this are left to the parts tree rather than tested point batch by point batch */
+#define PIP_BATCH_MAX_POLYGONS 64
+
+/* Whether the points of a batch can be tested against the cache with pip_prepared_points() */
+bool pip_prepared_batchable(const PrepGeomCache *cache) {
+	return cache->pip_indexes && cache->npip_indexes <= PIP_BATCH_MAX_POLYGONS;
+}
+
+/*
+ * pip_short_circuit() for n points against the cached (multi)polygon, the
+ * points given as coordinate arrays. results[i] is -1, 0 or 1 as for
+ * point_in_polygon.
+ */
+void pip_prepared_points(const PrepGeomCache *cache, const double *xs, const double *ys, uint32_t n, int *results) {
+	if (!pip_prepared_batchable(cache))
+		throw "Prepared geometry is not a polygon";
+	point_in_poly_indexes_batch(cache->pip_indexes, cache->npip_indexes, xs, ys, n, results);
+}
+
+/* ST_Intersects() with the cached geometry on either side */
+bool ST_Intersects_prepared(PrepGeomCache *cache, GSERIALIZED *geom) {
+	GBOX box;
+
+	gserialized_error_if_srid_mismatch(cache->gser, geom, __func__);
+
+	/* A.Intersects(Empty) == FALSE */
+	if (gserialized_is_empty(cache->gser) || gserialized_is_empty(geom))
+		return false;
+
+	/* short-circuit 1: bounding box overlap, against the cached box */
+	if (cache->has_gbox && gserialized_get_gbox_p(geom, &box)) {
+		if (gbox_overlaps_2d(&cache->gbox, &box) == LW_FALSE)
+			return false;
+
+		/* only the parts near geom can intersect it */
+		if (cache->parts_tree)
+			return intersects_parts(cache, geom, &box);
+	}
+
+	/* short-circuit 2: point-in-polygon, reusing whichever side is decoded already */
+	if (is_poly(cache->gser) && is_point(geom)) {
+		LWGEOM *points = lwgeom_from_gserialized(geom);
+		bool retval = pip_intersects(cache->lwgeom, points, cache->pip_indexes);
+		lwgeom_free(points);
+		return retval;
+	}
+	if (is_point(cache->gser) && is_poly(geom)) {
+		LWGEOM *poly = lwgeom_from_gserialized(geom);
+		bool retval = pip_intersects(poly, cache->lwgeom);
+		lwgeom_free(poly);
+		return retval;
+	}
+
+	return prepared_geos_predicate(cache, 1, geom, GEOSIntersects, "GEOSIntersects");
+}
+
 /*
  * Described at
  * http://lin-ear-th-inking.blogspot.com/2007/06/subtleties-of-ogc-covers-spatial.html
@@ -831,36 +1553,11 @@ bool covers(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	 * call the point-in-polygon function.
 	 */
 	if (is_poly(geom1) && is_point(geom2)) {
-		const GSERIALIZED *gpoly = is_poly(geom1) ? geom1 : geom2;
-		const GSERIALIZED *gpoint = is_point(geom1) ? geom1 : geom2;
-		int retval;
-
-		if (gserialized_get_type(gpoint) == POINTTYPE) {
-			LWGEOM *point = lwgeom_from_gserialized(gpoint);
-			int pip_result = pip_short_circuit(lwgeom_as_lwpoint(point), gpoly);
-			lwgeom_free(point);
-
-			retval = (pip_result != -1); /* not outside */
-		} else if (gserialized_get_type(gpoint) == MULTIPOINTTYPE) {
-			LWMPOINT *mpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gpoint));
-			uint32_t i;
-
-			retval = LW_TRUE;
-			for (i = 0; i < mpoint->ngeoms; i++) {
-				int pip_result = pip_short_circuit(mpoint->geoms[i], gpoly);
-				if (pip_result == -1) {
-					retval = LW_FALSE;
-					break;
-				}
-			}
-
-			lwmpoint_free(mpoint);
-		} else {
-			/* Never get here */
-			throw "Type isn't point or multipoint!";
-			return false;
-		}
-
+		LWGEOM *poly = lwgeom_from_gserialized(is_poly(geom1) ? geom1 : geom2);
+		LWGEOM *points = lwgeom_from_gserialized(is_point(geom1) ? geom1 : geom2);
+		bool retval = pip_covers(poly, points);
+		lwgeom_free(poly);
+		lwgeom_free(points);
 		return retval;
 	}
 
@@ -916,36 +1613,11 @@ bool coveredby(GSERIALIZED *geom1, GSERIALIZED *geom2) {
 	 * call the point-in-polygon function.
 	 */
 	if (is_point(geom1) && is_poly(geom2)) {
-		const GSERIALIZED *gpoly = is_poly(geom1) ? geom1 : geom2;
-		const GSERIALIZED *gpoint = is_point(geom1) ? geom1 : geom2;
-		int retval;
-
-		if (gserialized_get_type(gpoint) == POINTTYPE) {
-			LWGEOM *point = lwgeom_from_gserialized(gpoint);
-			int pip_result = pip_short_circuit(lwgeom_as_lwpoint(point), gpoly);
-			lwgeom_free(point);
-
-			retval = (pip_result != -1); /* not outside */
-		} else if (gserialized_get_type(gpoint) == MULTIPOINTTYPE) {
-			LWMPOINT *mpoint = lwgeom_as_lwmpoint(lwgeom_from_gserialized(gpoint));
-			uint32_t i;
-
-			retval = LW_TRUE;
-			for (i = 0; i < mpoint->ngeoms; i++) {
-				int pip_result = pip_short_circuit(mpoint->geoms[i], gpoly);
-				if (pip_result == -1) {
-					retval = LW_FALSE;
-					break;
-				}
-			}
-
-			lwmpoint_free(mpoint);
-		} else {
-			/* Never get here */
-			throw "Type isn't point or multipoint!";
-			return false;
-		}
-
+		LWGEOM *poly = lwgeom_from_gserialized(is_poly(geom1) ? geom1 : geom2);
+		LWGEOM *points = lwgeom_from_gserialized(is_point(geom1) ? geom1 : geom2);
+		bool retval = pip_covers(poly, points);
+		lwgeom_free(poly);
+		lwgeom_free(points);
 		return retval;
 	}
 
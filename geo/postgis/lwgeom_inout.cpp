@@ -41,6 +41,42 @@ GSERIALIZED *LWGEOM_getGserialized(const void *base, size_t size) {
 	return ret;
 }
 
+/*
+ * Build the LWGEOM directly from the stored EWKB payload, skipping the
+ * intermediate GSERIALIZED round trip.
+ */
+LWGEOM *LWGEOM_getLWGeom(const void *base, size_t size) {
+	return lwgeom_from_wkb(static_cast<const uint8_t *>(base), size, LW_PARSER_CHECK_NONE);
+}
+
+LWGEOM *LWGEOM_getLWGeom(GSERIALIZED *gser) {
+	return lwgeom_from_gserialized(gser);
+}
+
+/*
+ * SRID and exact 2D extent of the stored EWKB payload, read without
+ * building the geometry. Fails for empty and curved geometries.
+ */
+bool LWGEOM_getGBox(const void *base, size_t size, int32_t *srid, GBOX *gbox) {
+	const uint8_t *wkb = static_cast<const uint8_t *>(base);
+	return wkb_peek_srid(wkb, size, srid) == LW_SUCCESS && wkb_peek_gbox(wkb, size, gbox) == LW_SUCCESS;
+}
+
+/*
+ * SRID and 2D coordinates of the stored EWKB payload when it is a
+ * non-empty point, read without building the geometry.
+ */
+bool LWGEOM_getPoint(const void *base, size_t size, int32_t *srid, POINT2D *point) {
+	const uint8_t *wkb = static_cast<const uint8_t *>(base);
+	POINT4D pt;
+
+	if (wkb_peek_first_point(wkb, size, &pt) == LW_FAILURE || wkb_peek_srid(wkb, size, srid) == LW_FAILURE)
+		return false;
+	point->x = pt.x;
+	point->y = pt.y;
+	return true;
+}
+
 size_t LWGEOM_size(GSERIALIZED *gser) {
 	LWGEOM *lwgeom = lwgeom_from_gserialized(gser);
 	if (lwgeom == NULL) {
@@ -52,6 +88,13 @@ size_t LWGEOM_size(GSERIALIZED *gser) {
 	return buf_size;
 }
 
+size_t LWGEOM_size(LWGEOM *lwgeom) {
+	if (lwgeom == NULL) {
+		return 0;
+	}
+	return lwgeom_to_wkb_size(lwgeom, WKB_EXTENDED);
+}
+
 char *LWGEOM_base(GSERIALIZED *gser) {
 	LWGEOM *lwgeom = lwgeom_from_gserialized(gser);
 	if (lwgeom == NULL) {
@@ -63,6 +106,14 @@ char *LWGEOM_base(GSERIALIZED *gser) {
 	return (char *)buffer;
 }
 
+/*
+ * Write the EWKB of lwgeom into buffer, which must hold at least
+ * LWGEOM_size(lwgeom) bytes. Returns the number of bytes written.
+ */
+size_t LWGEOM_write(LWGEOM *lwgeom, char *buffer) {
+	return lwgeom_to_wkb_write_buf(lwgeom, WKB_EXTENDED, (uint8_t *)buffer);
+}
+
 // std::string LWGEOM_asText(const void *base, size_t size, size_t max_digits) {
 // 	std::string rstr = "";
 // 	LWGEOM *lwgeom = lwgeom_from_wkb(static_cast<const uint8_t *>(base), size, LW_PARSER_CHECK_NONE);
@@ -77,21 +128,32 @@ char *LWGEOM_base(GSERIALIZED *gser) {
 
 std::string LWGEOM_asText(GSERIALIZED *geom, size_t dbl_dig_for_wkt) {
 	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
+	std::string rstr = LWGEOM_asText(lwgeom, dbl_dig_for_wkt);
+	lwgeom_free(lwgeom);
+	return rstr;
+}
 
+std::string LWGEOM_asText(LWGEOM *lwgeom, size_t dbl_dig_for_wkt) {
 	std::string rstr = "";
 	size_t wkt_size;
-	rstr = lwgeom_to_wkt(lwgeom, WKT_ISO, dbl_dig_for_wkt, &wkt_size);
-
-	lwgeom_free(lwgeom);
+	char *wkt = lwgeom_to_wkt(lwgeom, WKT_ISO, dbl_dig_for_wkt, &wkt_size);
+	if (wkt) {
+		rstr = wkt;
+		lwfree(wkt);
+	}
 	return rstr;
 }
 
 lwvarlena_t *LWGEOM_asBinary(GSERIALIZED *geom, string text) {
-	LWGEOM *lwgeom;
-	uint8_t variant = WKB_ISO;
-
 	/* Get a 2D version of the geometry */
-	lwgeom = lwgeom_from_gserialized(geom);
+	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
+	auto binary = LWGEOM_asBinary(lwgeom, text);
+	lwgeom_free(lwgeom);
+	return binary;
+}
+
+lwvarlena_t *LWGEOM_asBinary(LWGEOM *lwgeom, string text) {
+	uint8_t variant = WKB_ISO;
 
 	/* If user specified endianness, respect it */
 	if (text != "") {
@@ -102,10 +164,8 @@ lwvarlena_t *LWGEOM_asBinary(GSERIALIZED *geom, string text) {
 		}
 	}
 
-	/* Write to WKB and free the geometry */
-	auto binary = lwgeom_to_wkb_varlena(lwgeom, variant);
-	lwgeom_free(lwgeom);
-	return binary;
+	/* Write to WKB */
+	return lwgeom_to_wkb_varlena(lwgeom, variant);
 }
 
 std::string LWGEOM_asBinary(const void *base, size_t size) {
@@ -135,4 +195,10 @@ void LWGEOM_free(GSERIALIZED *gser) {
 	}
 }
 
+void LWGEOM_free(LWGEOM *lwgeom) {
+	if (lwgeom) {
+		lwgeom_free(lwgeom);
+	}
+}
+
 } // namespace duckdb
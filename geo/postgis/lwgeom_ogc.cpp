@@ -106,10 +106,13 @@ GSERIALIZED *LWGEOM_boundary(GSERIALIZED *geom1) {
  */
 int LWGEOM_dimension(GSERIALIZED *geom) {
 	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
-	int dimension = -1;
-
-	dimension = lwgeom_dimension(lwgeom);
+	int dimension = LWGEOM_dimension(lwgeom);
 	lwgeom_free(lwgeom);
+	return dimension;
+}
+
+int LWGEOM_dimension(LWGEOM *lwgeom) {
+	int dimension = lwgeom_dimension(lwgeom);
 
 	if (dimension < 0) {
 		// elog(NOTICE, "Could not compute geometry dimensions");
@@ -134,6 +137,34 @@ double LWGEOM_x_point(GSERIALIZED *geom) {
 	return pt.x;
 }
 
+double LWGEOM_x_point(LWGEOM *lwgeom) {
+	POINT4D pt;
+
+	if (lwgeom->type != POINTTYPE) {
+		throw Exception("Argument to ST_X() must have type POINT");
+	}
+
+	if (lwgeom_is_empty(lwgeom) || lwgeom_startpoint(lwgeom, &pt) == LW_FAILURE) {
+		return LW_FAILURE;
+	}
+	return pt.x;
+}
+
+double LWGEOM_x_point(const void *base, size_t size) {
+	const uint8_t *wkb = static_cast<const uint8_t *>(base);
+	POINT4D pt;
+	uint8_t type;
+
+	if (wkb_peek_type(wkb, size, &type) == LW_FAILURE || type != POINTTYPE) {
+		throw Exception("Argument to ST_X() must have type POINT");
+	}
+
+	if (wkb_peek_first_point(wkb, size, &pt) == LW_FAILURE) {
+		return LW_FAILURE;
+	}
+	return pt.x;
+}
+
 /**
  * Y(GEOMETRY) -- return Y value of the point.
  * 	Raise an error if input is not a point.
@@ -154,6 +185,34 @@ double LWGEOM_y_point(GSERIALIZED *geom) {
 	return pt.y;
 }
 
+double LWGEOM_y_point(LWGEOM *lwgeom) {
+	POINT4D pt;
+
+	if (lwgeom->type != POINTTYPE) {
+		throw Exception("Argument to ST_Y() must have type POINT");
+	}
+
+	if (lwgeom_is_empty(lwgeom) || lwgeom_startpoint(lwgeom, &pt) == LW_FAILURE) {
+		return LW_FAILURE;
+	}
+	return pt.y;
+}
+
+double LWGEOM_y_point(const void *base, size_t size) {
+	const uint8_t *wkb = static_cast<const uint8_t *>(base);
+	POINT4D pt;
+	uint8_t type;
+
+	if (wkb_peek_type(wkb, size, &type) == LW_FAILURE || type != POINTTYPE) {
+		throw Exception("Argument to ST_Y() must have type POINT");
+	}
+
+	if (wkb_peek_first_point(wkb, size, &pt) == LW_FAILURE) {
+		return LW_FAILURE;
+	}
+	return pt.y;
+}
+
 /** EndPoint(GEOMETRY) -- find the first linestring in GEOMETRY,
  * @return the last point.
  * 	Return NULL if there is no LINESTRING(..) in GEOMETRY
@@ -188,6 +247,20 @@ std::string geometry_geometrytype(GSERIALIZED *gser) {
 	return stTypeName[gserialized_get_type(gser)];
 }
 
+std::string geometry_geometrytype(LWGEOM *lwgeom) {
+	return stTypeName[lwgeom->type];
+}
+
+std::string geometry_geometrytype(const void *base, size_t size) {
+	uint8_t type = 0;
+
+	/* Same error the full decode used to raise for a blob it could not read */
+	if (wkb_peek_type(static_cast<const uint8_t *>(base), size, &type) == LW_FAILURE || type == 0) {
+		throw ConversionException("Failure in geometry dimension: could not getting dimension from geom");
+	}
+	return stTypeName[type];
+}
+
 /**
  * @brief IsClosed(GEOMETRY) if geometry is a linestring then returns
  * 		startpoint == endpoint.  If its not a linestring then return NULL.
@@ -196,24 +269,55 @@ std::string geometry_geometrytype(GSERIALIZED *gser) {
  */
 bool LWGEOM_isclosed(GSERIALIZED *geom) {
 	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
-	int closed = lwgeom_is_closed(lwgeom);
+	int closed = LWGEOM_isclosed(lwgeom);
 
 	lwgeom_free(lwgeom);
 	return closed;
 }
 
+bool LWGEOM_isclosed(LWGEOM *lwgeom) {
+	return lwgeom_is_closed(lwgeom);
+}
+
 int LWGEOM_numgeometries_collection(GSERIALIZED *geom) {
-	LWGEOM *lwgeom;
+	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
+	int ret = LWGEOM_numgeometries_collection(lwgeom);
+	lwgeom_free(lwgeom);
+
+	return ret;
+}
+
+int LWGEOM_numgeometries_collection(LWGEOM *lwgeom) {
 	uint32_t ret = 1;
 
-	lwgeom = lwgeom_from_gserialized(geom);
 	if (lwgeom_is_empty(lwgeom)) {
 		ret = 0;
 	} else if (lwgeom_is_collection(lwgeom)) {
 		LWCOLLECTION *col = lwgeom_as_lwcollection(lwgeom);
 		ret = col->ngeoms;
 	}
-	lwgeom_free(lwgeom);
+
+	return ret;
+}
+
+int LWGEOM_numgeometries_collection(const void *base, size_t size) {
+	const uint8_t *wkb = static_cast<const uint8_t *>(base);
+	uint32_t ret = 1;
+	int is_empty;
+
+	if (wkb_peek_is_empty(wkb, size, &is_empty) == LW_FAILURE) {
+		LWGEOM *lwgeom = lwgeom_from_wkb(wkb, size, LW_PARSER_CHECK_NONE);
+		ret = LWGEOM_numgeometries_collection(lwgeom);
+		lwgeom_free(lwgeom);
+		return ret;
+	}
+
+	if (is_empty) {
+		ret = 0;
+	} else {
+		/* Only succeeds for collections, everything else counts as one */
+		wkb_peek_ngeoms(wkb, size, &ret);
+	}
 
 	return ret;
 }
@@ -224,14 +328,19 @@ int LWGEOM_numgeometries_collection(GSERIALIZED *geom) {
  */
 int LWGEOM_numpoints_linestring(GSERIALIZED *geom) {
 	LWGEOM *lwgeom = lwgeom_from_gserialized(geom);
+	int count = LWGEOM_numpoints_linestring(lwgeom);
+	lwgeom_free(lwgeom);
+
+	return count;
+}
+
+int LWGEOM_numpoints_linestring(LWGEOM *lwgeom) {
 	int count = -1;
 	int type = lwgeom->type;
 
 	if (type == LINETYPE || type == CIRCSTRINGTYPE || type == COMPOUNDTYPE)
 		count = lwgeom_count_vertices(lwgeom);
 
-	lwgeom_free(lwgeom);
-
 	/* OGC says this functions is only valid on LINESTRING */
 	if (count < 0)
 		return 0;
@@ -0,0 +1,166 @@
+/**********************************************************************
+ *
+ * PostGIS - Spatial Types for PostgreSQL
+ * http://postgis.net
+ *
+ * PostGIS is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * PostGIS is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with PostGIS.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ **********************************************************************/
+
+#include "postgis/lwgeom_rtree.hpp"
+
+#include "liblwgeom/liblwgeom_internal.hpp"
+
+#include <stdlib.h>
+
+namespace duckdb {
+
+typedef struct {
+	uint64_t key;
+	uint32_t item;
+} RTREE_SORT_ENTRY;
+
+static int rtree_sort_cmp(const void *a, const void *b) {
+	const RTREE_SORT_ENTRY *ea = (const RTREE_SORT_ENTRY *)a;
+	const RTREE_SORT_ENTRY *eb = (const RTREE_SORT_ENTRY *)b;
+	if (ea->key != eb->key)
+		return ea->key < eb->key ? -1 : 1;
+	return ea->item < eb->item ? -1 : (ea->item > eb->item ? 1 : 0);
+}
+
+/* Grid cell of a coordinate along one axis of the extent */
+static uint32_t rtree_grid_cell(double v, double min, double max) {
+	if (max <= min)
+		return 0;
+	return (uint32_t)((v - min) / (max - min) * UINT32_MAX);
+}
+
+static void rtree_box_merge(GBOX *target, const GBOX *box) {
+	target->xmin = FP_MIN(target->xmin, box->xmin);
+	target->xmax = FP_MAX(target->xmax, box->xmax);
+	target->ymin = FP_MIN(target->ymin, box->ymin);
+	target->ymax = FP_MAX(target->ymax, box->ymax);
+}
+
+static int rtree_box_overlaps(const GBOX *a, const GBOX *b) {
+	return !(a->xmin > b->xmax || b->xmin > a->xmax || a->ymin > b->ymax || b->ymin > a->ymax);
+}
+
+RTREE *rtree_build(const GBOX *boxes, uint32_t nboxes) {
+	RTREE *tree = (RTREE *)lwalloc(sizeof(RTREE));
+	RTREE_SORT_ENTRY *entries;
+	GBOX extent;
+	uint32_t i, j, level, count, nnodes;
+
+	tree->nitems = nboxes;
+	tree->items = (uint32_t *)lwalloc(sizeof(uint32_t) * (nboxes ? nboxes : 1));
+	tree->item_boxes = (GBOX *)lwalloc(sizeof(GBOX) * (nboxes ? nboxes : 1));
+
+	/* Order the items along the Hilbert curve through the centres of their boxes */
+	entries = (RTREE_SORT_ENTRY *)lwalloc(sizeof(RTREE_SORT_ENTRY) * (nboxes ? nboxes : 1));
+	for (i = 0; i < nboxes; i++) {
+		if (i == 0)
+			extent = boxes[0];
+		else
+			rtree_box_merge(&extent, &boxes[i]);
+	}
+	for (i = 0; i < nboxes; i++) {
+		double cx = (boxes[i].xmin + boxes[i].xmax) / 2;
+		double cy = (boxes[i].ymin + boxes[i].ymax) / 2;
+		entries[i].key = hilbert_point_as_int(rtree_grid_cell(cx, extent.xmin, extent.xmax),
+		                                      rtree_grid_cell(cy, extent.ymin, extent.ymax));
+		entries[i].item = i;
+	}
+	qsort(entries, nboxes, sizeof(RTREE_SORT_ENTRY), rtree_sort_cmp);
+	for (i = 0; i < nboxes; i++) {
+		tree->items[i] = entries[i].item;
+		tree->item_boxes[i] = boxes[entries[i].item];
+	}
+	lwfree(entries);
+
+	/* Count the levels, the top one has a single node */
+	tree->nlevels = 0;
+	nnodes = 0;
+	count = nboxes;
+	do {
+		count = (count + RTREE_NODE_CAPACITY - 1) / RTREE_NODE_CAPACITY;
+		nnodes += count;
+		tree->nlevels++;
+	} while (count > 1);
+
+	tree->level_offsets = (uint32_t *)lwalloc(sizeof(uint32_t) * (tree->nlevels + 1));
+	tree->nodes = (GBOX *)lwalloc(sizeof(GBOX) * (nnodes ? nnodes : 1));
+
+	/* Pack every level over the one below it */
+	tree->level_offsets[0] = 0;
+	count = nboxes;
+	for (level = 0; level < tree->nlevels; level++) {
+		const GBOX *children = level == 0 ? tree->item_boxes : tree->nodes + tree->level_offsets[level - 1];
+		uint32_t nparents = (count + RTREE_NODE_CAPACITY - 1) / RTREE_NODE_CAPACITY;
+		GBOX *parents = tree->nodes + tree->level_offsets[level];
+
+		for (i = 0; i < nparents; i++) {
+			uint32_t end = FP_MIN((i + 1) * RTREE_NODE_CAPACITY, count);
+			parents[i] = children[i * RTREE_NODE_CAPACITY];
+			for (j = i * RTREE_NODE_CAPACITY + 1; j < end; j++)
+				rtree_box_merge(&parents[i], &children[j]);
+		}
+		tree->level_offsets[level + 1] = tree->level_offsets[level] + nparents;
+		count = nparents;
+	}
+
+	return tree;
+}
+
+static void rtree_query_node(const RTREE *tree, uint32_t level, uint32_t node, const GBOX *box, uint32_t *hits,
+                             uint32_t *nhits) {
+	uint32_t i, first, end;
+
+	if (!rtree_box_overlaps(&tree->nodes[tree->level_offsets[level] + node], box))
+		return;
+
+	first = node * RTREE_NODE_CAPACITY;
+	if (level == 0) {
+		end = FP_MIN(first + RTREE_NODE_CAPACITY, tree->nitems);
+		for (i = first; i < end; i++) {
+			if (rtree_box_overlaps(&tree->item_boxes[i], box))
+				hits[(*nhits)++] = tree->items[i];
+		}
+		return;
+	}
+
+	end = FP_MIN(first + RTREE_NODE_CAPACITY, tree->level_offsets[level] - tree->level_offsets[level - 1]);
+	for (i = first; i < end; i++)
+		rtree_query_node(tree, level - 1, i, box, hits, nhits);
+}
+
+uint32_t rtree_query(const RTREE *tree, const GBOX *box, uint32_t *hits) {
+	uint32_t nhits = 0;
+	if (tree->nitems == 0)
+		return 0;
+	rtree_query_node(tree, tree->nlevels - 1, 0, box, hits, &nhits);
+	return nhits;
+}
+
+void rtree_free(RTREE *tree) {
+	if (!tree)
+		return;
+	lwfree(tree->items);
+	lwfree(tree->item_boxes);
+	lwfree(tree->level_offsets);
+	lwfree(tree->nodes);
+	lwfree(tree);
+}
+
+} // namespace duckdb
@@ -26,18 +26,55 @@
 
 #include "liblwgeom/gserialized.hpp"
 #include "liblwgeom/lwgeom_geos.hpp"
+#include "liblwgeom/lwinline.hpp"
 #include "liblwgeom/lwunionfind.hpp"
+#include "liblwgeom/lwgeodetic.hpp"
+#include "libpgcommon/lwgeom_pg.hpp"
+#include "postgis/geography_centroid.hpp"
 #include "postgis/lwgeom_geos.hpp"
 
 namespace duckdb {
 
-std::vector<int> ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int ngeoms, double tolerance, int minpoints) {
+std::vector<int> ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int ngeoms, double tolerance, int minpoints, int nthreads) {
 	if (ngeoms <= 0) {
 		return {};
 	}
-	uint32_t i;
-	uint32_t *result_ids;
+	int i;
 	LWGEOM **geoms;
+
+	geoms = (LWGEOM **)lwalloc(ngeoms * sizeof(LWGEOM *));
+	for (i = 0; i < ngeoms; i++) {
+		geoms[i] = lwgeom_from_gserialized(gserArray[i]);
+
+		if (!geoms[i]) {
+			/* TODO release memory ? */
+			lwerror("Error reading geometry.");
+			return {};
+		}
+	}
+
+	auto clusters = ST_ClusterDBSCAN(geoms, ngeoms, tolerance, minpoints, nthreads);
+
+	for (i = 0; i < ngeoms; i++) {
+		lwgeom_free(geoms[i]);
+	}
+	lwfree(geoms);
+
+	return clusters;
+}
+
+/*
+ * DBSCAN over geometries that are decoded already, so that callers
+ * clustering many subsets of the same rows decode each row only once.
+ * Tolerance is the great circle distance in radians, the neighbours are
+ * searched on up to nthreads threads.
+ */
+std::vector<int> ST_ClusterDBSCAN(LWGEOM *geoms[], int ngeoms, double tolerance, int minpoints, int nthreads) {
+	if (ngeoms <= 0) {
+		return {};
+	}
+	int i;
+	uint32_t *result_ids;
 	char *is_in_cluster = NULL;
 	UNIONFIND *uf;
 	std::vector<int> clusters(ngeoms, -1);
@@ -53,26 +90,17 @@ std::vector<int> ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int ngeoms, double t
 		lwerror("Minpoints must be a positive number", minpoints);
 	}
 
-	initGEOS(lwnotice, lwgeom_geos_error);
-	geoms = (LWGEOM **)lwalloc(ngeoms * sizeof(LWGEOM *));
 	uf = UF_create(ngeoms);
-	for (i = 0; i < ngeoms; i++) {
-		geoms[i] = lwgeom_from_gserialized(gserArray[i]);
 
-		if (!geoms[i]) {
-			/* TODO release memory ? */
-			lwerror("Error reading geometry.");
-			return {};
-		}
-	}
-
-	if (union_dbscan(geoms, ngeoms, uf, tolerance, minpoints, minpoints > 1 ? &is_in_cluster : NULL) == LW_SUCCESS)
+	/* Within a distance of zero is intersecting, which GEOS answers without measuring the distance */
+	if (tolerance == 0 && minpoints <= 1) {
+		initGEOS(lwnotice, lwgeom_geos_error);
+		if (union_intersecting_pairs(geoms, ngeoms, uf) == LW_SUCCESS)
+			is_error = LW_FALSE;
+	} else if (union_dbscan_geodetic(geoms, ngeoms, uf, tolerance, minpoints, minpoints > 1 ? &is_in_cluster : NULL,
+	                                 nthreads > 1 ? nthreads : 1) == LW_SUCCESS) {
 		is_error = LW_FALSE;
-
-	for (i = 0; i < ngeoms; i++) {
-		lwgeom_free(geoms[i]);
 	}
-	lwfree(geoms);
 
 	if (is_error) {
 		UF_destroy(uf);
@@ -92,9 +120,127 @@ std::vector<int> ST_ClusterDBSCAN(GSERIALIZED *gserArray[], int ngeoms, double t
 	}
 
 	lwfree(result_ids);
+	if (is_in_cluster)
+		lwfree(is_in_cluster);
 	UF_destroy(uf);
 
 	return clusters;
 }
 
+/*
+ * ST_ClusterIntersecting and ST_ClusterWithin: the connected components of
+ * the geometries within tolerance (radians) of each other, a tolerance of
+ * zero meaning intersecting. Every component comes back as a
+ * GEOMETRYCOLLECTION of its members, in the order of the cluster ids.
+ */
+std::vector<GSERIALIZED *> ST_ClusterWithin(GSERIALIZED *gserArray[], int ngeoms, double tolerance, int nthreads) {
+	if (ngeoms <= 0) {
+		return {};
+	}
+	int i;
+	LWGEOM **geoms;
+	LWCOLLECTION **components;
+	int ncomponents = 0;
+	std::vector<GSERIALIZED *> result;
+
+	geoms = (LWGEOM **)lwalloc(ngeoms * sizeof(LWGEOM *));
+	for (i = 0; i < ngeoms; i++) {
+		geoms[i] = lwgeom_from_gserialized(gserArray[i]);
+
+		if (!geoms[i]) {
+			/* TODO release memory ? */
+			lwerror("Error reading geometry.");
+			return {};
+		}
+	}
+
+	auto clusters = ST_ClusterDBSCAN(geoms, ngeoms, tolerance, 1, nthreads);
+	for (i = 0; i < ngeoms; i++) {
+		ncomponents = clusters[i] + 1 > ncomponents ? clusters[i] + 1 : ncomponents;
+	}
+
+	components = (LWCOLLECTION **)lwalloc(ncomponents * sizeof(LWCOLLECTION *));
+	for (i = 0; i < ncomponents; i++) {
+		components[i] = lwcollection_construct_empty(COLLECTIONTYPE, lwgeom_get_srid(geoms[0]),
+		                                             lwgeom_has_z(geoms[0]), lwgeom_has_m(geoms[0]));
+	}
+	for (i = 0; i < ngeoms; i++) {
+		/* with a minimum of one point nothing is noise */
+		components[clusters[i]] = lwcollection_add_lwgeom(components[clusters[i]], lwgeom_clone_deep(geoms[i]));
+	}
+
+	for (i = 0; i < ncomponents; i++) {
+		result.push_back(geography_serialize(lwcollection_as_lwgeom(components[i])));
+		lwcollection_free(components[i]);
+	}
+	lwfree(components);
+	for (i = 0; i < ngeoms; i++) {
+		lwgeom_free(geoms[i]);
+	}
+	lwfree(geoms);
+
+	return result;
+}
+
+/*
+ * The point that stands for a geography in ST_ClusterKMeans: a point is
+ * itself, anything else its centroid on the sphere. Returns false for an
+ * empty geography.
+ */
+bool ST_ClusterKMeansCentre(GSERIALIZED *gser, POINT2D *centre) {
+	GSERIALIZED *centroid;
+	LWGEOM *lwgeom;
+
+	if (gserialized_is_empty(gser))
+		return false;
+
+	centroid = gserialized_get_type(gser) == POINTTYPE ? gser : geography_centroid(gser, false);
+	lwgeom = lwgeom_from_gserialized(centroid);
+	if (!lwgeom || lwgeom_is_empty(lwgeom) || lwgeom->type != POINTTYPE) {
+		if (lwgeom)
+			lwgeom_free(lwgeom);
+		if (centroid != gser)
+			lwfree(centroid);
+		return false;
+	}
+	*centre = *getPoint2d_cp(lwgeom_as_lwpoint(lwgeom)->point, 0);
+	lwgeom_free(lwgeom);
+	if (centroid != gser)
+		lwfree(centroid);
+	return true;
+}
+
+/*
+ * k-means of the centres on the sphere, max_radius in radians. The
+ * clusters are numbered from 0 in the order their first member comes in.
+ */
+std::vector<int> ST_ClusterKMeans(const POINT2D *centres, int ncentres, int k, double max_radius) {
+	if (ncentres <= 0) {
+		return {};
+	}
+	if (k <= 0) {
+		lwerror("Number of clusters must be greater than zero");
+		return {};
+	}
+
+	int *labels = lwgeodetic_cluster_kmeans(centres, ncentres, k, max_radius);
+	if (!labels) {
+		lwerror("Error during clustering");
+		return {};
+	}
+
+	std::vector<int> clusters(ncentres, -1);
+	std::vector<int> renumbered(ncentres, -1);
+	int nclusters = 0;
+	for (int i = 0; i < ncentres; i++) {
+		if (renumbered[labels[i]] == -1) {
+			renumbered[labels[i]] = nclusters++;
+		}
+		clusters[i] = renumbered[labels[i]];
+	}
+	lwfree(labels);
+
+	return clusters;
+}
+
 } // namespace duckdb
@@ -37,11 +37,25 @@ using geos::geom::Geometry;
 // ## GLOBALS ################################################
 
 // NOTE: SRID will have to be changed after geometry creation
-GEOSContextHandle_t handle = NULL;
+// Each thread owns its context, so message handlers and the error buffer are never shared between threads
+thread_local GEOSContextHandle_t handle = NULL;
+
+namespace {
+// Releases the calling thread's context when the thread exits
+struct GEOSThreadContext {
+	~GEOSThreadContext() {
+		if (handle) {
+			GEOS_finish_r(handle);
+			handle = NULL;
+		}
+	}
+};
+} // namespace
 
 extern "C" {
 
 void initGEOS(GEOSMessageHandler nf, GEOSMessageHandler ef) {
+	static thread_local GEOSThreadContext thread_context;
 	if (!handle) {
 		handle = initGEOS_r(nf, ef);
 	} else {
@@ -198,6 +212,10 @@ void GEOSGeom_destroy(Geometry *a) {
 	return GEOSGeom_destroy_r(handle, a);
 }
 
+Geometry *GEOSGeom_clone(const Geometry *g) {
+	return GEOSGeom_clone_r(handle, g);
+}
+
 //-------------------------------------------------------------------
 // GEOS functions that return geometries
 //-------------------------------------------------------------------
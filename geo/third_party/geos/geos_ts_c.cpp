@@ -290,6 +290,11 @@ GEOSContextHandle_t GEOS_init_r() {
 	return static_cast<GEOSContextHandle_t>(handle);
 }
 
+void GEOS_finish_r(GEOSContextHandle_t extHandle) {
+	GEOSContextHandleInternal_t *handle = reinterpret_cast<GEOSContextHandleInternal_t *>(extHandle);
+	delete handle;
+}
+
 // Return postgis geometry type index
 int GEOSGeomTypeId_r(GEOSContextHandle_t extHandle, const Geometry *g1) {
 	return execute(extHandle, -1, [&]() { return static_cast<int>(g1->getGeometryTypeId()); });
@@ -659,6 +664,10 @@ void GEOSGeom_destroy_r(GEOSContextHandle_t extHandle, Geometry *a) {
 	});
 }
 
+Geometry *GEOSGeom_clone_r(GEOSContextHandle_t extHandle, const Geometry *g) {
+	return execute(extHandle, [&]() { return g->clone().release(); });
+}
+
 //-------------------------------------------------------------------
 // GEOS functions that return geometries
 //-------------------------------------------------------------------
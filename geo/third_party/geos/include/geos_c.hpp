@@ -200,6 +200,12 @@ extern GEOSContextHandle_t GEOS_DLL GEOS_init_r(void);
  */
 extern GEOSContextHandle_t GEOS_DLL initGEOS_r(GEOSMessageHandler notice_function, GEOSMessageHandler error_function);
 
+/**
+ * Free the memory associated with a \ref GEOSContextHandle_t
+ * created by \ref GEOS_init_r.
+ */
+extern void GEOS_DLL GEOS_finish_r(GEOSContextHandle_t handle);
+
 /* ========== Geometry info ========== */
 
 /** \see GEOSGeomTypeId */
@@ -357,6 +363,9 @@ extern void GEOS_DLL GEOSSTRtree_destroy_r(GEOSContextHandle_t handle, GEOSSTRtr
 /** \see GEOSGeom_destroy */
 extern void GEOS_DLL GEOSGeom_destroy_r(GEOSContextHandle_t handle, GEOSGeometry *g);
 
+/** \see GEOSGeom_clone */
+extern GEOSGeometry GEOS_DLL *GEOSGeom_clone_r(GEOSContextHandle_t handle, const GEOSGeometry *g);
+
 /* ========= Topology Operations ========= */
 
 /** \see GEOSDifference */
@@ -582,6 +591,14 @@ extern GEOSGeometry GEOS_DLL *GEOSGeom_createCollection(int type, GEOSGeometry *
  */
 extern void GEOS_DLL GEOSGeom_destroy(GEOSGeometry *g);
 
+/**
+ * Create a new copy of the input geometry.
+ * \param g The geometry to copy
+ * \return A newly allocated geometry. NULL on exception.
+ * Caller is responsible for freeing with GEOSGeom_destroy().
+ */
+extern GEOSGeometry GEOS_DLL *GEOSGeom_clone(const GEOSGeometry *g);
+
 ///@}
 
 /* ========== Geometry info ========== */
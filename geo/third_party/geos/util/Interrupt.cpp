@@ -15,9 +15,11 @@
 #include <geos/util/GEOSException.hpp> // for inheritance
 #include <geos/util/Interrupt.hpp>
 
+#include <atomic>
+
 namespace {
-/* Could these be portably stored in thread-specific space ? */
-bool requested = false;
+/* Shared so that request() from any thread reaches the one running GEOS; atomic for that cross-thread access */
+std::atomic<bool> requested(false);
 
 geos::util::Interrupt::Callback *callback = nullptr;
 } // namespace